@@ -0,0 +1,50 @@
+// Builds the algorithm as a plugin that the simulator runs in-process, e.g.,
+// with "--generate-mazes". It stands in for Interface.cpp, Main.cpp, and
+// Printer.cpp: the Interface methods forward to the simulator instead.
+
+#include "Algo.h"
+#include "Interface.h"
+
+// This must match MmsMazeGeneratorHost in the simulator's MazeGenerator.h
+extern "C" {
+struct MmsMazeGeneratorHost {
+    void* context;
+    int (*getWidth)(void* context);
+    int (*getHeight)(void* context);
+    double (*getRandomFloat)(void* context);
+    void (*setWall)(void* context, int x, int y, char direction, int wallExists);
+};
+}
+
+// The simulator may generate several mazes at once, one per thread
+static thread_local MmsMazeGeneratorHost* host = nullptr;
+
+Interface::Interface(
+    std::vector<std::vector<std::map<char, bool> > >* maze,
+    bool* success) :
+    m_maze(maze),
+    m_success(success) {
+}
+
+int Interface::getWidth() {
+    return host->getWidth(host->context);
+}
+
+int Interface::getHeight() {
+    return host->getHeight(host->context);
+}
+
+double Interface::getRandomFloat() {
+    return host->getRandomFloat(host->context);
+}
+
+void Interface::setWall(int x, int y, char direction, bool wallExists) {
+    host->setWall(host->context, x, y, direction, wallExists ? 1 : 0);
+}
+
+extern "C" void mmsGenerateMaze(MmsMazeGeneratorHost* generatorHost) {
+    host = generatorHost;
+    Interface interface(nullptr, nullptr);
+    Algo().generate(&interface);
+    host = nullptr;
+}
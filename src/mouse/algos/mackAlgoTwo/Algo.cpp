@@ -24,32 +24,22 @@ void Algo::solve(Interface* interface) {
     // Set and finalize some options
     m_mouse->setTileTextRowsAndCols(1, 5);
 
-    // Ensure that the maze size is sane
-    if (!(
-        1 <= Maze::WIDTH &&
-        1 <= Maze::HEIGHT &&
-        Maze::WIDTH <= 16 &&
-        Maze::HEIGHT <= 16
-    )) {
-#if (SIMULATOR)
-        std::cout << "ERROR - Maze::WIDTH and Maze::HEIGHT must be in [1, 16]"
-                  << std::endl;
-#endif
-        return;
-    }
-
-    // Ensure that the maze size is as expected
+    // Ensure that the maze size is as expected (the size is checked for
+    // sanity at compile time, in Size.h); in the simulator, where any size
+    // can be built, a maze of another size is refused rather than misread
     if (!(
         Maze::WIDTH == m_mouse->mazeWidth() &&
         Maze::HEIGHT == m_mouse->mazeHeight()
     )) {
 #if (SIMULATOR)
-        std::cout << "WARNING - configured for "
+        std::cout << "ERROR - configured for "
                   << static_cast<unsigned int>(Maze::WIDTH) << " x "
                   << static_cast<unsigned int>(Maze::HEIGHT)
                   << " maze, but actual maze size is "
                   << m_mouse->mazeWidth() << " x "
-                  << m_mouse->mazeHeight() << std::endl;
+                  << m_mouse->mazeHeight()
+                  << " (set MAZE_SIZE in Options.h)" << std::endl;
+        return;
 #endif
     }
 
@@ -187,8 +177,8 @@ void Algo::reset() {
 
     // Roll back some cell wall data
     while (0 < History::size()) {
-        twobyte cellAndData = History::pop();
-        byte cell = History::cell(cellAndData);
+        History::Entry cellAndData = History::pop();
+        Maze::Cell cell = History::cell(cellAndData);
         byte data = History::data(cellAndData);
         for (byte direction = 0; direction < 4; direction += 1) {
             if (data >> direction + 4 & 1) {
@@ -208,10 +198,10 @@ void Algo::step() {
 #endif
 
     // Get the current cell
-    byte current = Maze::getCell(m_x, m_y);
+    Maze::Cell current = Maze::getCell(m_x, m_y);
 
     // Generate a path from the current cell to the destination
-    byte start = generatePath(current);
+    Maze::Cell start = generatePath(current);
 
     // Invalid path, maze not solvable
     if (start != current) {
@@ -246,7 +236,7 @@ void Algo::step() {
     }
 }
 
-byte Algo::generatePath(byte start) {
+Maze::Cell Algo::generatePath(Maze::Cell start) {
 
     // Reset the sequence bit of all cells
     for (byte x = 0; x < Maze::WIDTH; x += 1) {
@@ -277,7 +267,7 @@ byte Algo::generatePath(byte start) {
     ASSERT_EQ(Heap::size(), 0);
     Heap::push(start);
     while (0 < Heap::size()) {
-        byte cell = Heap::pop();
+        Maze::Cell cell = Heap::pop();
         for (byte direction = 0; direction < 4; direction += 1) {
             if (!Maze::isWall(cell, direction)) {
                 checkNeighbor(cell, direction);
@@ -300,13 +290,13 @@ byte Algo::generatePath(byte start) {
     return reverseLinkedList(getClosestDestinationCell());
 }
 
-void Algo::drawPath(byte start) {
+void Algo::drawPath(Maze::Cell start) {
 #if (SIMULATOR)
     // This is probably a little two cutesy for it's own good. Oh well...
-    byte current = start;
+    Maze::Cell current = start;
     for (byte i = 0; i < 2; i += 1) {
         while (Maze::hasNext(current)) {
-            byte next = getNeighboringCell(current, Maze::getNextDirection(current));
+            Maze::Cell next = getNeighboringCell(current, Maze::getNextDirection(current));
             // Draw the "known" moves
             if (i == 0) {
                 if (!Maze::isKnown(current, Maze::getNextDirection(current))) {
@@ -324,14 +314,14 @@ void Algo::drawPath(byte start) {
 #endif
 }
 
-void Algo::followPath(byte start) {
+void Algo::followPath(Maze::Cell start) {
 
     // Move forward as long as we know we won't collide with a wall
-    byte current = start;
+    Maze::Cell current = start;
     while (Maze::hasNext(current) && Maze::isKnown(current, Maze::getNextDirection(current))) {
 
         // Move to the next cell and advance our pointers
-        byte next = getNeighboringCell(current, Maze::getNextDirection(current));
+        Maze::Cell next = getNeighboringCell(current, Maze::getNextDirection(current));
         moveOneCell(next);
         current = next;
 
@@ -345,8 +335,8 @@ void Algo::followPath(byte start) {
     }
 }
 
-byte Algo::getFirstUnknown(byte start) {
-    byte current = start;
+Maze::Cell Algo::getFirstUnknown(Maze::Cell start) {
+    Maze::Cell current = start;
     while (Maze::hasNext(current) &&
            Maze::isKnown(current, Maze::getNextDirection(current))) {
         current = getNeighboringCell(current, Maze::getNextDirection(current));
@@ -354,16 +344,16 @@ byte Algo::getFirstUnknown(byte start) {
     return current;
 }
 
-void Algo::checkNeighbor(byte cell, byte direction) {
+void Algo::checkNeighbor(Maze::Cell cell, byte direction) {
 
     // Retrieve the neighboring cell, and the direction that would take us from
     // the neighboring cell to the current cell (which is the opposite of the
     // direction that takes us from the current cell to the neighboring cell)
-    byte neighbor = getNeighboringCell(cell, direction);
+    Maze::Cell neighbor = getNeighboringCell(cell, direction);
     byte directionFromNeighbor = getOppositeDirection(direction);
 
     // Determine the cost if routed through the current cell
-    twobyte costToNeighbor = Maze::getDistance(cell) + (
+    Maze::Distance costToNeighbor = Maze::getDistance(cell) + (
         Maze::getNextDirection(cell) == directionFromNeighbor
         ? getStraightAwayCost(Maze::getStraightAwayLength(cell) + 1)
         : getTurnCost()
@@ -392,10 +382,10 @@ void Algo::checkNeighbor(byte cell, byte direction) {
     }
 }
 
-byte Algo::reverseLinkedList(byte cell) {
-    byte closest = cell;
+Maze::Cell Algo::reverseLinkedList(Maze::Cell cell) {
+    Maze::Cell closest = cell;
     byte direction = Maze::getNextDirection(closest);
-    byte current = getNeighboringCell(closest, direction);
+    Maze::Cell current = getNeighboringCell(closest, direction);
     Maze::clearNext(closest);
     while (Maze::hasNext(current)) {
         byte temp = Maze::getNextDirection(current);
@@ -432,7 +422,7 @@ void Algo::colorCenter(char color) {
 }
 
 void Algo::resetDestinationCellDistances() {
-    static twobyte maxDistance = 65535;
+    static Maze::Distance maxDistance = Maze::MAX_DISTANCE;
     if (m_mode == Mode::CENTER) {
         for (byte x = Maze::CLLX; x <= Maze::CURX; x += 1) {
             for (byte y = Maze::CLLY; y <= Maze::CURY; y += 1) {
@@ -445,12 +435,12 @@ void Algo::resetDestinationCellDistances() {
     }
 }
 
-byte Algo::getClosestDestinationCell() {
-    byte closest = Maze::getCell(Maze::CLLX, Maze::CLLY);
+Maze::Cell Algo::getClosestDestinationCell() {
+    Maze::Cell closest = Maze::getCell(Maze::CLLX, Maze::CLLY);
     if (m_mode == Mode::CENTER) {
         for (byte x = Maze::CLLX; x <= Maze::CURX; x += 1) {
             for (byte y = Maze::CLLY; y <= Maze::CURY; y += 1) {
-                byte other = Maze::getCell(x, y);
+                Maze::Cell other = Maze::getCell(x, y);
                 if (Maze::getDistance(other) < Maze::getDistance(closest)) {
                     closest = other;
                 }
@@ -478,7 +468,7 @@ byte Algo::getOppositeDirection(byte direction) {
     }
 }
 
-bool Algo::hasNeighboringCell(byte cell, byte direction) {
+bool Algo::hasNeighboringCell(Maze::Cell cell, byte direction) {
 
     byte x = Maze::getX(cell);
     byte y = Maze::getY(cell);
@@ -495,7 +485,7 @@ bool Algo::hasNeighboringCell(byte cell, byte direction) {
     }
 }
 
-byte Algo::getNeighboringCell(byte cell, byte direction) {
+Maze::Cell Algo::getNeighboringCell(Maze::Cell cell, byte direction) {
 
     ASSERT_TR(hasNeighboringCell(cell, direction));
 
@@ -514,7 +504,7 @@ byte Algo::getNeighboringCell(byte cell, byte direction) {
     }
 }
 
-bool Algo::isOneCellAway(byte target) {
+bool Algo::isOneCellAway(Maze::Cell target) {
 
     byte x = Maze::getX(target);
     byte y = Maze::getY(target);
@@ -535,7 +525,7 @@ bool Algo::isOneCellAway(byte target) {
     return false;
 }
 
-void Algo::moveOneCell(byte target) {
+void Algo::moveOneCell(Maze::Cell target) {
 
     ASSERT_TR(isOneCellAway(target));
 
@@ -570,7 +560,7 @@ void Algo::moveOneCell(byte target) {
 void Algo::readWalls() {
 
     // Record the cell and wall data for the History
-    byte cell = Maze::getCell(m_x, m_y);
+    Maze::Cell cell = Maze::getCell(m_x, m_y);
     byte data = 0;
 
     // For each of [left, front, right]
@@ -680,7 +670,7 @@ void Algo::aroundAndForward() {
 #endif
 }
 
-void Algo::setCellDistance(byte cell, twobyte distance) {
+void Algo::setCellDistance(Maze::Cell cell, Maze::Distance distance) {
     Maze::setDistance(cell, distance);
 #if (SIMULATOR)
     std::ostringstream ss;
@@ -689,22 +679,22 @@ void Algo::setCellDistance(byte cell, twobyte distance) {
 #endif
 }
 
-void Algo::setCellWall(byte cell, byte direction, bool isWall, bool bothSides) {
+void Algo::setCellWall(Maze::Cell cell, byte direction, bool isWall, bool bothSides) {
     Maze::setWall(cell, direction, isWall);
     static char directionChars[] = {'n', 'e', 's', 'w'};
     m_mouse->declareWall(Maze::getX(cell), Maze::getY(cell), directionChars[direction], isWall);
     if (bothSides && hasNeighboringCell(cell, direction)) {
-        byte neighboringCell = getNeighboringCell(cell, direction);
+        Maze::Cell neighboringCell = getNeighboringCell(cell, direction);
         setCellWall(neighboringCell, getOppositeDirection(direction), isWall, false);
     }
 }
 
-void Algo::unsetCellWall(byte cell, byte direction, bool bothSides) {
+void Algo::unsetCellWall(Maze::Cell cell, byte direction, bool bothSides) {
     Maze::unsetWall(cell, direction);
     static char directionChars[] = {'n', 'e', 's', 'w'};
     m_mouse->undeclareWall(Maze::getX(cell), Maze::getY(cell), directionChars[direction]);
     if (bothSides && hasNeighboringCell(cell, direction)) {
-        byte neighboringCell = getNeighboringCell(cell, direction);
+        Maze::Cell neighboringCell = getNeighboringCell(cell, direction);
         unsetCellWall(neighboringCell, getOppositeDirection(direction), false);
     }
 }
@@ -37,27 +37,27 @@ private:
     void reset();
     void step();
 
-    byte generatePath(byte start);
-    void drawPath(byte start);
-    void followPath(byte start);
-    byte getFirstUnknown(byte start);
+    Maze::Cell generatePath(Maze::Cell start);
+    void drawPath(Maze::Cell start);
+    void followPath(Maze::Cell start);
+    Maze::Cell getFirstUnknown(Maze::Cell start);
 
-    void checkNeighbor(byte cell, byte direction);
-    byte reverseLinkedList(byte cell);
+    void checkNeighbor(Maze::Cell cell, byte direction);
+    Maze::Cell reverseLinkedList(Maze::Cell cell);
 
     bool inCenter(byte x, byte y);
     bool inOrigin(byte x, byte y);
 
     void colorCenter(char color);
     void resetDestinationCellDistances();
-    byte getClosestDestinationCell();
+    Maze::Cell getClosestDestinationCell();
 
     byte getOppositeDirection(byte direction);
-    bool hasNeighboringCell(byte cell, byte direction);
-    byte getNeighboringCell(byte cell, byte direction);
+    bool hasNeighboringCell(Maze::Cell cell, byte direction);
+    Maze::Cell getNeighboringCell(Maze::Cell cell, byte direction);
 
-    bool isOneCellAway(byte target);
-    void moveOneCell(byte target);
+    bool isOneCellAway(Maze::Cell target);
+    void moveOneCell(Maze::Cell target);
 
     void readWalls();
     bool readWall(byte direction);
@@ -72,8 +72,8 @@ private:
     void rightAndForward();
     void aroundAndForward();
 
-    void setCellDistance(byte cell, twobyte distance);
-    void setCellWall(byte cell, byte direction, bool isWall, bool bothSides = true);
-    void unsetCellWall(byte cell, byte direction, bool bothSides = true);
+    void setCellDistance(Maze::Cell cell, Maze::Distance distance);
+    void setCellWall(Maze::Cell cell, byte direction, bool isWall, bool bothSides = true);
+    void unsetCellWall(Maze::Cell cell, byte direction, bool bothSides = true);
 
 };
@@ -2,3 +2,4 @@
 
 typedef unsigned char byte;
 typedef unsigned int twobyte;
+typedef unsigned long fourbyte;
@@ -3,14 +3,19 @@
 #include "Assert.h"
 #include "Maze.h"
 
-byte Heap::m_size = 0;
-byte Heap::m_data[] = {0};
+template <class S>
+typename BasicHeap<S>::Index BasicHeap<S>::m_size = 0;
 
-byte Heap::size() {
+template <class S>
+typename BasicHeap<S>::Cell BasicHeap<S>::m_data[] = {0};
+
+template <class S>
+typename BasicHeap<S>::Index BasicHeap<S>::size() {
     return m_size;
 }
 
-void Heap::push(byte cell) {
+template <class S>
+void BasicHeap<S>::push(Cell cell) {
     ASSERT_LT(m_size, CAPACITY);
     m_data[m_size] = cell;
     m_size += 1;
@@ -19,9 +24,10 @@ void Heap::push(byte cell) {
     }
 }
 
-void Heap::update(byte cell) {
-    byte index = SENTINEL;
-    for (byte i = 0; i < m_size; i += 1) {
+template <class S>
+void BasicHeap<S>::update(Cell cell) {
+    Index index = SENTINEL;
+    for (Index i = 0; i < m_size; i += 1) {
         if (m_data[i] == cell) {
             index = i;
             break;
@@ -31,9 +37,10 @@ void Heap::update(byte cell) {
     heapifyUp(index);
 }
 
-byte Heap::pop() {
+template <class S>
+typename BasicHeap<S>::Cell BasicHeap<S>::pop() {
     ASSERT_LT(0, m_size);
-    byte cell = m_data[0];
+    Cell cell = m_data[0];
     m_data[0] = m_data[m_size - 1];
     m_size -= 1;
     if (1 < m_size) {
@@ -42,34 +49,39 @@ byte Heap::pop() {
     return cell;
 }
 
-void Heap::clear() {
+template <class S>
+void BasicHeap<S>::clear() {
     m_size = 0;
 }
 
-byte Heap::getParentIndex(byte index) {
+template <class S>
+typename BasicHeap<S>::Index BasicHeap<S>::getParentIndex(Index index) {
     if (index == 0) {
         return SENTINEL;
     }
     return (index - 1) / 2;
 }
 
-byte Heap::getLeftChildIndex(byte index) {
+template <class S>
+typename BasicHeap<S>::Index BasicHeap<S>::getLeftChildIndex(Index index) {
     if (getParentIndex(CAPACITY - 1) < index) {
         return SENTINEL;
     }
     return (index * 2) + 1;
 }
 
-byte Heap::getRightChildIndex(byte index) {
+template <class S>
+typename BasicHeap<S>::Index BasicHeap<S>::getRightChildIndex(Index index) {
     if (getParentIndex(CAPACITY - 1) < index) {
         return SENTINEL;
     }
     return (index + 1) * 2;
 }
 
-byte Heap::getMinChildIndex(byte index) {
-    byte left = getLeftChildIndex(index);
-    byte right = getRightChildIndex(index);
+template <class S>
+typename BasicHeap<S>::Index BasicHeap<S>::getMinChildIndex(Index index) {
+    Index left = getLeftChildIndex(index);
+    Index right = getRightChildIndex(index);
     if (m_size <= left) {
         return SENTINEL;
     }
@@ -77,17 +89,18 @@ byte Heap::getMinChildIndex(byte index) {
         return left;
     }
     return (
-        Maze::getDistance(m_data[left]) < Maze::getDistance(m_data[right]) ?
+        BasicMaze<S>::getDistance(m_data[left]) < BasicMaze<S>::getDistance(m_data[right]) ?
         left : right
     );
 }
 
-void Heap::heapifyUp(byte index) {
+template <class S>
+void BasicHeap<S>::heapifyUp(Index index) {
     ASSERT_LT(index, m_size);
-    byte parentIndex = getParentIndex(index);
+    Index parentIndex = getParentIndex(index);
     while (
         parentIndex != SENTINEL &&
-        Maze::getDistance(m_data[index]) < Maze::getDistance(m_data[parentIndex])
+        BasicMaze<S>::getDistance(m_data[index]) < BasicMaze<S>::getDistance(m_data[parentIndex])
     ) {
         swap(index, parentIndex);
         index = parentIndex;
@@ -95,12 +108,13 @@ void Heap::heapifyUp(byte index) {
     }
 }
 
-void Heap::heapifyDown(byte index) {
+template <class S>
+void BasicHeap<S>::heapifyDown(Index index) {
     ASSERT_LT(index, m_size);
-    byte minChildIndex = getMinChildIndex(index);
+    Index minChildIndex = getMinChildIndex(index);
     while (
         minChildIndex != SENTINEL &&
-        Maze::getDistance(m_data[minChildIndex]) < Maze::getDistance(m_data[index])
+        BasicMaze<S>::getDistance(m_data[minChildIndex]) < BasicMaze<S>::getDistance(m_data[index])
     ) {
         swap(index, minChildIndex);
         index = minChildIndex;
@@ -108,11 +122,15 @@ void Heap::heapifyDown(byte index) {
     }
 }
 
-void Heap::swap(byte indexOne, byte indexTwo) {
+template <class S>
+void BasicHeap<S>::swap(Index indexOne, Index indexTwo) {
     ASSERT_LT(indexOne, m_size);
     ASSERT_LT(indexTwo, m_size);
     ASSERT_NE(indexOne, indexTwo);
-    byte temp = m_data[indexOne];
+    Cell temp = m_data[indexOne];
     m_data[indexOne] = m_data[indexTwo];
     m_data[indexTwo] = temp;
 }
+
+// Only the configured size is built
+template class BasicHeap<Size>;
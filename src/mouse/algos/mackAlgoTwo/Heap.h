@@ -1,31 +1,38 @@
 #pragma once
 
 #include "Byte.h"
+#include "Size.h"
 
-class Heap {
+template <class S>
+class BasicHeap {
 
 public:
 
-    static byte size();
-    static void push(byte cell);
-    static void update(byte cell);
-    static byte pop();
+    typedef typename S::Cell Cell;
+    typedef typename S::HeapIndex Index;
+
+    static Index size();
+    static void push(Cell cell);
+    static void update(Cell cell);
+    static Cell pop();
     static void clear();
 
 private:
 
-    static const byte CAPACITY = 127;
-    static const byte SENTINEL = 255;
+    static const Index CAPACITY = S::HEAP_CAPACITY;
+    static const Index SENTINEL = static_cast<Index>(-1);
 
-    static byte m_size;
-    static byte m_data[CAPACITY];
+    static Index m_size;
+    static Cell m_data[CAPACITY];
 
-    static byte getParentIndex(byte index); 
-    static byte getLeftChildIndex(byte index); 
-    static byte getRightChildIndex(byte index); 
-    static byte getMinChildIndex(byte index);
+    static Index getParentIndex(Index index); 
+    static Index getLeftChildIndex(Index index); 
+    static Index getRightChildIndex(Index index); 
+    static Index getMinChildIndex(Index index);
 
-    static void heapifyUp(byte index);
-    static void heapifyDown(byte index);
-    static void swap(byte indexOne, byte indexTwo);
+    static void heapifyUp(Index index);
+    static void heapifyDown(Index index);
+    static void swap(Index indexOne, Index indexTwo);
 };
+
+typedef BasicHeap<Size> Heap;
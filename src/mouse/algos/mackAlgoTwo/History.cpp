@@ -2,21 +2,31 @@
 
 #include "Assert.h"
 
-byte History::m_size = 0;
-byte History::m_tail = 0;
-bool History::m_infoAdded = false;
-twobyte History::m_data[] = {0};
+template <class S>
+byte BasicHistory<S>::m_size = 0;
 
-byte History::size() {
+template <class S>
+byte BasicHistory<S>::m_tail = 0;
+
+template <class S>
+bool BasicHistory<S>::m_infoAdded = false;
+
+template <class S>
+typename BasicHistory<S>::Entry BasicHistory<S>::m_data[] = {0};
+
+template <class S>
+byte BasicHistory<S>::size() {
     return m_size;
 }
 
-void History::add(byte cell, byte data) {
-    m_data[m_tail] = cell << 8 | data;
+template <class S>
+void BasicHistory<S>::add(Cell cell, byte data) {
+    m_data[m_tail] = static_cast<Entry>(cell) << 8 | data;
     m_infoAdded = true;
 }
 
-void History::move() {
+template <class S>
+void BasicHistory<S>::move() {
     if (!m_infoAdded) {
         m_data[m_tail] = 0;
     }
@@ -27,19 +37,25 @@ void History::move() {
     }
 }
 
-twobyte History::pop() {
+template <class S>
+typename BasicHistory<S>::Entry BasicHistory<S>::pop() {
     ASSERT_LT(0, m_size);
     m_tail = (m_tail - 1 + CAPACITY) % CAPACITY;
-    twobyte cellAndData = m_data[m_tail];
+    Entry cellAndData = m_data[m_tail];
     m_data[m_tail] = 0;
     m_size -= 1;
     return cellAndData;
 }
 
-byte History::cell(twobyte cellAndData) {
+template <class S>
+typename BasicHistory<S>::Cell BasicHistory<S>::cell(Entry cellAndData) {
     return cellAndData >> 8;
 }
 
-byte History::data(twobyte cellAndData) {
+template <class S>
+byte BasicHistory<S>::data(Entry cellAndData) {
     return cellAndData & 255;
 }
+
+// Only the configured size is built
+template class BasicHistory<Size>;
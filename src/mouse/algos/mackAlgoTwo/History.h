@@ -1,8 +1,10 @@
 #pragma once
 
 #include "Byte.h"
+#include "Size.h"
 
-class History {
+template <class S>
+class BasicHistory {
 
     // The History class is a circular stack that remembers the previous
     // CAPACITY moves, and allows you to retrieve the wall information learned
@@ -16,12 +18,15 @@ class History {
 
 public:
 
+    typedef typename S::Cell Cell;
+    typedef typename S::HistoryEntry Entry;
+
     static byte size();
-    static void add(byte cell, byte data);
+    static void add(Cell cell, byte data);
     static void move();
-    static twobyte pop();
-    static byte cell(twobyte cellAndData);
-    static byte data(twobyte cellAndData);
+    static Entry pop();
+    static Cell cell(Entry cellAndData);
+    static byte data(Entry cellAndData);
 
 private:
 
@@ -41,9 +46,9 @@ private:
     // some data the next time that move() is called.
     static bool m_infoAdded;
 
-    // One byte for the x and y position of the cell, and one byte for whether
-    // or not we learned of any walls, and what wall values we actually learned
-    // (which is technically not needed):
+    // The cell, and one byte for whether or not we learned of any walls, and
+    // what wall values we actually learned (which is technically not needed).
+    // For a 16x16 maze, the cell is one byte for its x and y position:
     //
     //                 |---------|---------|---------|---------|
     //            info |    x    |    y    | learned |  walls  |
@@ -53,6 +58,8 @@ private:
     //            bits | 7 6 5 4 | 3 2 1 0 | 7 6 5 4 | 3 2 1 0 |
     //                 |---------|---------|---------|---------|
     //
-    static twobyte m_data[CAPACITY];
+    static Entry m_data[CAPACITY];
 
 };
+
+typedef BasicHistory<Size> History;
@@ -1,92 +1,124 @@
 #include "Maze.h"
 
-byte Maze::m_data[] = {0};
-Info Maze::m_info[] = {0, 0};
+template <class S>
+byte BasicMaze<S>::m_data[] = {0};
 
-byte Maze::getX(byte cell) {
+template <class S>
+typename BasicMaze<S>::Info BasicMaze<S>::m_info[] = {0, 0};
+
+template <class S>
+byte BasicMaze<S>::getX(Cell cell) {
     return cell / HEIGHT;
 }
 
-byte Maze::getY(byte cell) {
+template <class S>
+byte BasicMaze<S>::getY(Cell cell) {
     return cell % HEIGHT;
 }
 
-byte Maze::getCell(byte x, byte y) {
+template <class S>
+typename BasicMaze<S>::Cell BasicMaze<S>::getCell(byte x, byte y) {
     return x * HEIGHT + y;
 }
 
-bool Maze::isKnown(byte x, byte y, byte direction) {
+template <class S>
+bool BasicMaze<S>::isKnown(byte x, byte y, byte direction) {
     return isKnown(getCell(x, y), direction);
 }
 
-bool Maze::isWall(byte x, byte y, byte direction) {
+template <class S>
+bool BasicMaze<S>::isWall(byte x, byte y, byte direction) {
     return isWall(getCell(x, y), direction);
 }
 
-void Maze::setWall(byte x, byte y, byte direction, bool isWall) {
+template <class S>
+void BasicMaze<S>::setWall(byte x, byte y, byte direction, bool isWall) {
     setWall(getCell(x, y), direction, isWall);
 }
 
-void Maze::unsetWall(byte x, byte y, byte direction) {
+template <class S>
+void BasicMaze<S>::unsetWall(byte x, byte y, byte direction) {
     unsetWall(getCell(x, y), direction);
 }
 
-bool Maze::isKnown(byte cell, byte direction) {
+template <class S>
+bool BasicMaze<S>::isKnown(Cell cell, byte direction) {
     return (m_data[cell] >> direction + 4) & 1;
 }
 
-bool Maze::isWall(byte cell, byte direction) {
+template <class S>
+bool BasicMaze<S>::isWall(Cell cell, byte direction) {
     return (m_data[cell] >> direction) & 1;
 }
 
-void Maze::setWall(byte cell, byte direction, bool isWall) {
+template <class S>
+void BasicMaze<S>::setWall(Cell cell, byte direction, bool isWall) {
     m_data[cell] |= 1 << direction + 4;
     m_data[cell] =
         (m_data[cell] & ~(1 << direction)) | (isWall ? 1 << direction : 0);
 }
 
-void Maze::unsetWall(byte cell, byte direction) {
+template <class S>
+void BasicMaze<S>::unsetWall(Cell cell, byte direction) {
     m_data[cell] &= ~(1 << direction + 4);
     m_data[cell] &= ~(1 << direction);
 }
 
-twobyte Maze::getDistance(byte cell) {
+template <class S>
+typename BasicMaze<S>::Distance BasicMaze<S>::getDistance(Cell cell) {
     return m_info[cell].distance;
 }
 
-void Maze::setDistance(byte cell, twobyte distance) {
+template <class S>
+void BasicMaze<S>::setDistance(Cell cell, Distance distance) {
     m_info[cell].distance = distance;
 }
 
-bool Maze::getDiscovered(byte cell) {
+template <class S>
+bool BasicMaze<S>::getDiscovered(Cell cell) {
     return m_info[cell].misc & 1;
 }
 
-void Maze::setDiscovered(byte cell, bool discovered) {
+template <class S>
+void BasicMaze<S>::setDiscovered(Cell cell, bool discovered) {
     m_info[cell].misc = (m_info[cell].misc & ~1) | (discovered ? 1 : 0);
 }
 
-bool Maze::hasNext(byte cell) {
+template <class S>
+bool BasicMaze<S>::hasNext(Cell cell) {
     return m_info[cell].misc & 2;
 }
 
-void Maze::clearNext(byte cell) {
+template <class S>
+void BasicMaze<S>::clearNext(Cell cell) {
     m_info[cell].misc &= ~2;
 }
 
-byte Maze::getNextDirection(byte cell) {
+template <class S>
+byte BasicMaze<S>::getNextDirection(Cell cell) {
     return m_info[cell].misc >> 2 & 3;
 }
 
-void Maze::setNextDirection(byte cell, byte nextDirection) {
+template <class S>
+void BasicMaze<S>::setNextDirection(Cell cell, byte nextDirection) {
     m_info[cell].misc |= 2;
     m_info[cell].misc = (m_info[cell].misc & ~12) | (nextDirection << 2);
 }
 
-byte Maze::getStraightAwayLength(byte cell) {
+template <class S>
+byte BasicMaze<S>::getStraightAwayLength(Cell cell) {
     return m_info[cell].misc >> 4 & 15;
 }
 
-void Maze::setStraightAwayLength(byte cell, byte straightAwayLength) {
+template <class S>
+void BasicMaze<S>::setStraightAwayLength(Cell cell, byte straightAwayLength) {
+    // Only larger mazes have straightaways too long to fit
+    if ((16 < WIDTH || 16 < HEIGHT) &&
+        MAX_STRAIGHT_AWAY_LENGTH < straightAwayLength) {
+        straightAwayLength = MAX_STRAIGHT_AWAY_LENGTH;
+    }
     m_info[cell].misc = (m_info[cell].misc & 15) | (straightAwayLength << 4);
 }
+
+// Only the configured size is built
+template struct BasicMaze<Size>;
@@ -2,10 +2,12 @@
 
 #include "Byte.h"
 #include "Direction.h"
+#include "Size.h"
 
-struct Info {
+template <typename Distance>
+struct BasicInfo {
     // The distance of the cell from the source (no units)
-    twobyte distance;
+    Distance distance;
     // bit 0 is whether or not the cell has been discovered
     // bit 1 is whether or not the cell has a "next" cell
     // bits 2 - 3 are the direction of the "next" cell
@@ -13,12 +15,16 @@ struct Info {
     byte misc;
 };
 
-struct Maze {
+template <class S>
+struct BasicMaze {
 
-    // The width and height of the maze, as understood
-    // by the algorithm, both of which must be in [1, 16]
-    static const byte WIDTH  = 16;
-    static const byte HEIGHT = 16;
+    typedef typename S::Cell Cell;
+    typedef typename S::Distance Distance;
+    typedef BasicInfo<Distance> Info;
+
+    // The width and height of the maze, as understood by the algorithm
+    static const byte WIDTH  = S::WIDTH;
+    static const byte HEIGHT = S::HEIGHT;
 
     // The x and y positions of the lower left and upper right center cells
     static const byte CLLX = (WIDTH  - 1) / 2;
@@ -26,6 +32,14 @@ struct Maze {
     static const byte CURX = (WIDTH     ) / 2;
     static const byte CURY = (HEIGHT    ) / 2;
 
+    // The distance of the destination cells until they're reached
+    static const Distance MAX_DISTANCE = S::MAX_DISTANCE;
+
+    // The longest straightaway that fits in an Info's four bits; longer ones
+    // (which only larger mazes have) are recorded as this long, i.e., their
+    // cells cost no less than the fifteenth cell of a straightaway
+    static const byte MAX_STRAIGHT_AWAY_LENGTH = 15;
+
     // For each cell, we store only eight bits of information: four bits for
     // whether we know the value of a wall, and four bits for the actual value
     //
@@ -35,40 +49,43 @@ struct Maze {
     //         |---------|---------|
     //    bits | 7 6 5 4 | 3 2 1 0 |
     //
-    // Furthermore, each cell can be indexed by just eight bits: at most
-    // four bits for the x position, and at most four bits for the y position
+    // Furthermore, each cell is indexed by a Cell, which is just eight bits
+    // for a 16x16 maze: four bits for the x position, and four bits for the
+    // y position
     //      
     static byte m_data[WIDTH * HEIGHT];
 
     // Helper methods for converting between xy coordinates
     // and the maze index of the cell in the data array
-    static byte getX(byte cell);
-    static byte getY(byte cell);
-    static byte getCell(byte x, byte y);
+    static byte getX(Cell cell);
+    static byte getY(Cell cell);
+    static Cell getCell(byte x, byte y);
 
     // Helper methods for querying and updating maze data
     static bool isKnown(byte x, byte y, byte direction);
     static bool isWall(byte x, byte y, byte direction);
     static void setWall(byte x, byte y, byte direction, bool isWall);
     static void unsetWall(byte x, byte y, byte direction);
-    static bool isKnown(byte cell, byte direction);
-    static bool isWall(byte cell, byte direction);
-    static void setWall(byte cell, byte direction, bool isWall);
-    static void unsetWall(byte cell, byte direction);
+    static bool isKnown(Cell cell, byte direction);
+    static bool isWall(Cell cell, byte direction);
+    static void setWall(Cell cell, byte direction, bool isWall);
+    static void unsetWall(Cell cell, byte direction);
 
     // Information used only by Dijkstra's algo to determine the fastest path
     static Info m_info[WIDTH * HEIGHT];
 
     // Helper methods for accessing and modifying m_info
-    static twobyte getDistance(byte cell);
-    static void setDistance(byte cell, twobyte distance);
-    static bool getDiscovered(byte cell);
-    static void setDiscovered(byte cell, bool discovered);
-    static bool hasNext(byte cell);
-    static void clearNext(byte cell);
-    static byte getNextDirection(byte cell);
-    static void setNextDirection(byte cell, byte nextDirection);
-    static byte getStraightAwayLength(byte cell);
-    static void setStraightAwayLength(byte cell, byte straightAwayLength);
+    static Distance getDistance(Cell cell);
+    static void setDistance(Cell cell, Distance distance);
+    static bool getDiscovered(Cell cell);
+    static void setDiscovered(Cell cell, bool discovered);
+    static bool hasNext(Cell cell);
+    static void clearNext(Cell cell);
+    static byte getNextDirection(Cell cell);
+    static void setNextDirection(Cell cell, byte nextDirection);
+    static byte getStraightAwayLength(Cell cell);
+    static void setStraightAwayLength(Cell cell, byte straightAwayLength);
 
 };
+
+typedef BasicMaze<Size> Maze;
@@ -3,3 +3,7 @@
 // 0 - Arduino
 // 1 - Simulator
 #define SIMULATOR 1
+
+// The width and height of the maze that the algorithm is built for (see
+// Size.h); only 16 fits on the Arduino, but 32 and 64 work in the simulator
+#define MAZE_SIZE 16
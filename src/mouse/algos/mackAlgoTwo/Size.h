@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Byte.h"
+#include "Options.h"
+
+// Everything that depends on the size of the maze, fixed at compile time, so
+// that the types are only as wide as that size needs them to be:
+//
+//   Cell         - holds the index of any cell, i.e., x * HEIGHT + y
+//   Distance     - holds the cost of any path, below MAX_DISTANCE, which
+//                  marks the destination cells as unreached
+//   HeapIndex    - holds any index into the heap, and the "none" sentinel
+//   HistoryEntry - holds a cell above eight bits of wall data
+//
+template <
+    byte Width,
+    byte Height,
+    typename CellType,
+    typename DistanceType,
+    DistanceType MaxDistance,
+    typename HeapIndexType,
+    HeapIndexType HeapCapacity,
+    typename HistoryEntryType>
+struct MazeSize {
+
+    static const byte WIDTH  = Width;
+    static const byte HEIGHT = Height;
+
+    typedef CellType Cell;
+    typedef DistanceType Distance;
+    typedef HeapIndexType HeapIndex;
+    typedef HistoryEntryType HistoryEntry;
+
+    static const Distance MAX_DISTANCE = MaxDistance;
+    static const HeapIndex HEAP_CAPACITY = HeapCapacity;
+
+    static_assert(
+        1 <= Width && 1 <= Height,
+        "The maze must have at least one cell");
+    static_assert(
+        static_cast<CellType>(Width * Height - 1) == Width * Height - 1,
+        "Cell must hold the index of every cell");
+    static_assert(
+        HeapCapacity < static_cast<HeapIndexType>(-1),
+        "HeapIndex must have room for the sentinel");
+    static_assert(
+        sizeof(CellType) < sizeof(HistoryEntryType),
+        "HistoryEntry must have room for a cell and a byte");
+};
+
+// The 16x16 size keeps a cell in a byte (four bits each for x and y), and is
+// the only one that fits on the Arduino; the larger sizes are for simulation
+#if (MAZE_SIZE == 16)
+typedef MazeSize<16, 16, byte, twobyte, 65535, byte, 127, twobyte> Size;
+#elif (MAZE_SIZE == 32)
+typedef MazeSize<32, 32, twobyte, fourbyte, 4294967295UL, twobyte, 511, fourbyte> Size;
+#elif (MAZE_SIZE == 64)
+typedef MazeSize<64, 64, twobyte, fourbyte, 4294967295UL, twobyte, 2047, fourbyte> Size;
+#else
+#error "MAZE_SIZE must be 16, 32, or 64"
+#endif
@@ -1,5 +1,8 @@
 #include "BufferInterface.h"
 
+#include <algorithm>
+
+#include "FontImage.h"
 #include "RGB.h"
 #include "SimUtilities.h"
 
@@ -8,10 +11,16 @@ namespace mms {
 BufferInterface::BufferInterface(
         QPair<int, int> mazeSize,
         QVector<TriangleGraphic>* graphicCpuBuffer,
-        QVector<TriangleTexture>* textureCpuBuffer) :
+        QVector<TriangleTexture>* textureCpuBuffer,
+        TileImage* tileImage) :
         m_mazeSize(mazeSize),
         m_graphicCpuBuffer(graphicCpuBuffer),
-        m_textureCpuBuffer(textureCpuBuffer) {
+        m_textureCpuBuffer(textureCpuBuffer),
+        m_tileImage(tileImage) {
+}
+
+bool BufferInterface::usesTileImage() const {
+    return m_tileImage != nullptr;
 }
 
 void BufferInterface::initTileGraphicText(
@@ -37,6 +46,18 @@ void BufferInterface::insertIntoGraphicCpuBuffer(const Polygon& polygon, Color c
     }
 }
 
+void BufferInterface::insertIntoGraphicCpuBuffer(const TileRect& rect, Color color, double alpha) {
+    // Rectangles don't need to be triangulated, so we write the two
+    // triangles directly rather than going through a Polygon
+    RGB rgb = COLOR_TO_RGB().value(color);
+    VertexGraphic lowerLeft {rect.left, rect.bottom, rgb, alpha};
+    VertexGraphic upperLeft {rect.left, rect.top, rgb, alpha};
+    VertexGraphic upperRight {rect.right, rect.top, rgb, alpha};
+    VertexGraphic lowerRight {rect.right, rect.bottom, rgb, alpha};
+    m_graphicCpuBuffer->push_back(TriangleGraphic{lowerLeft, upperLeft, upperRight});
+    m_graphicCpuBuffer->push_back(TriangleGraphic{lowerLeft, upperRight, lowerRight});
+}
+
 void BufferInterface::insertIntoTextureCpuBuffer() {
     // Here we just insert dummy TriangleTexture objects. All of the actual
     // values of the objects will be set on calls to the update method.
@@ -58,6 +79,10 @@ void BufferInterface::insertIntoTextureCpuBuffer() {
 }
 
 void BufferInterface::updateTileGraphicBaseColor(int x, int y, Color color) {
+    if (m_tileImage != nullptr) {
+        m_tileImage->setBaseColor(x, y, color);
+        return;
+    }
     int index = getTileGraphicBaseStartingIndex(x, y);
     RGB rgb = COLOR_TO_RGB().value(color);
     for (int i = 0; i < 2; i += 1) {
@@ -69,6 +94,10 @@ void BufferInterface::updateTileGraphicBaseColor(int x, int y, Color color) {
 }
 
 void BufferInterface::updateTileGraphicWallColor(int x, int y, Direction direction, Color color, double alpha) {
+    if (m_tileImage != nullptr) {
+        m_tileImage->setWallColor(x, y, direction, color, alpha);
+        return;
+    }
     int index = getTileGraphicWallStartingIndex(x, y, direction);
     RGB rgb = COLOR_TO_RGB().value(color);
     for (int i = 0; i < 2; i += 1) {
@@ -83,6 +112,10 @@ void BufferInterface::updateTileGraphicWallColor(int x, int y, Direction directi
 }
 
 void BufferInterface::updateTileGraphicFog(int x, int y, double alpha) {
+    if (m_tileImage != nullptr) {
+        m_tileImage->setFog(x, y, alpha);
+        return;
+    }
     int index = getTileGraphicFogStartingIndex(x, y);
     for (int i = 0; i < 2; i += 1) {
         TriangleGraphic* triangleGraphic = &(*m_graphicCpuBuffer)[index + i];
@@ -92,7 +125,49 @@ void BufferInterface::updateTileGraphicFog(int x, int y, double alpha) {
     }
 }
 
-void BufferInterface::updateTileGraphicText(int x, int y, int numRows, int numCols, int row, int col, QChar c) {
+void BufferInterface::updateTileGraphicText(int x, int y, const QVector<QString>& rowsOfText) {
+    if (m_tileImage != nullptr) {
+        return;
+    }
+
+    QPair<int, int> maxRowsAndCols = m_tileGraphicTextCache.getTileGraphicTextMaxSize();
+    int numRows = std::min(static_cast<int>(rowsOfText.size()), maxRowsAndCols.first);
+
+    // The cached positions are for tile (0, 0)
+    double tileLength = m_tileGraphicTextCache.getTileLength();
+    double offsetX = tileLength * x;
+    double offsetY = tileLength * y;
+
+    // The characters of a tile are contiguous, in row-major order
+    FontImage* fontImage = FontImage::get();
+    TriangleTexture* t = &(*m_textureCpuBuffer)[getTileGraphicTextStartingIndex(x, y, 0, 0)];
+    for (int row = 0; row < maxRowsAndCols.first; row += 1) {
+        const QString rowText = row < numRows ? rowsOfText.at(row) : QString();
+        int numCols = std::min(static_cast<int>(rowText.size()), maxRowsAndCols.second);
+        for (int col = 0; col < maxRowsAndCols.second; col += 1) {
+            const double* position = m_tileGraphicTextCache.getTileGraphicTextPosition(
+                numRows, numCols, row, col);
+            writeTileGraphicTextCharacter(
+                t,
+                t + 1,
+                position[0] + offsetX,
+                position[1] + offsetY,
+                position[2] + offsetX,
+                position[3] + offsetY,
+                fontImage->position(col < numCols ? rowText.at(col) : ' '));
+            t += 2;
+        }
+    }
+}
+
+void BufferInterface::writeTileGraphicTextCharacter(
+        TriangleTexture* t1,
+        TriangleTexture* t2,
+        double llX,
+        double llY,
+        double urX,
+        double urY,
+        QPair<double, double> fontImageCharacterPosition) {
 
     //    +---------[UR]  [p2]-------[p3]    [p2]
     //    |         / |    |         /       / |
@@ -102,62 +177,41 @@ void BufferInterface::updateTileGraphicText(int x, int y, int numRows, int numCo
     //    | /         |    | /       /         |
     //   [LL]---------+   [p1]     [p1]------[p3]
 
-    QPair<double, double> fontImageCharacterPosition =
-        m_tileGraphicTextCache.getFontImageCharacterPosition(c);
-
-    QPair<Coordinate, Coordinate> LL_UR =
-        m_tileGraphicTextCache.getTileGraphicTextPosition(x, y, numRows, numCols, row, col);
-
-    int triangleTextureIndex = getTileGraphicTextStartingIndex(x, y, row, col);
-    TriangleTexture* t1 = &(*m_textureCpuBuffer)[triangleTextureIndex];
-    TriangleTexture* t2 = &(*m_textureCpuBuffer)[triangleTextureIndex + 1];
-
-    t1->p1.x = LL_UR.first.getX().getMeters();
-    t1->p1.y = LL_UR.first.getY().getMeters();
+    t1->p1.x = llX;
+    t1->p1.y = llY;
     t1->p1.u = fontImageCharacterPosition.first;
-    t1->p2.x = LL_UR.first.getX().getMeters();
-    t1->p2.y = LL_UR.second.getY().getMeters();
+    t1->p2.x = llX;
+    t1->p2.y = urY;
     t1->p2.u = fontImageCharacterPosition.first;
-    t1->p3.x = LL_UR.second.getX().getMeters();
-    t1->p3.y = LL_UR.second.getY().getMeters();
+    t1->p3.x = urX;
+    t1->p3.y = urY;
     t1->p3.u = fontImageCharacterPosition.second;
 
-    t2->p1.x = LL_UR.first.getX().getMeters();
-    t2->p1.y = LL_UR.first.getY().getMeters();
+    t2->p1.x = llX;
+    t2->p1.y = llY;
     t2->p1.u = fontImageCharacterPosition.first;
-    t2->p2.x = LL_UR.second.getX().getMeters();
-    t2->p2.y = LL_UR.second.getY().getMeters();
+    t2->p2.x = urX;
+    t2->p2.y = urY;
     t2->p2.u = fontImageCharacterPosition.second;
-    t2->p3.x = LL_UR.second.getX().getMeters();
-    t2->p3.y = LL_UR.first.getY().getMeters();
+    t2->p3.x = urX;
+    t2->p3.y = llY;
     t2->p3.u = fontImageCharacterPosition.second;
 }
 
-int BufferInterface::trianglesPerTile() {
-    // This value must be predetermined, and was done so as follows:
-    // Base polygon:      2 (2 triangles x 1 polygon  per tile)
-    // Wall polygon:      8 (2 triangles x 4 polygons per tile)
-    // Corner polygon:    8 (2 triangles x 4 polygons per tile)
-    // Fog polygon:       2 (2 triangles x 1 polygon  per tile)
-    // --------------------
-    // Total             20
-    return 20;
-}
-
 int BufferInterface::getTileGraphicBaseStartingIndex(int x, int y) {
-    return  0 + trianglesPerTile() * (m_mazeSize.second * x + y);
+    return TILE_BASE_TRIANGLES_BEGIN + TRIANGLES_PER_TILE * (m_mazeSize.second * x + y);
 }
 
 int BufferInterface::getTileGraphicWallStartingIndex(int x, int y, Direction direction) {
-    return  2 + trianglesPerTile() * (m_mazeSize.second * x + y) + (2 * DIRECTIONS().indexOf(direction));
+    return TILE_WALL_TRIANGLES_BEGIN + TRIANGLES_PER_TILE * (m_mazeSize.second * x + y) + (2 * DIRECTIONS().indexOf(direction));
 }
 
 int BufferInterface::getTileGraphicCornerStartingIndex(int x, int y, int cornerNumber) {
-    return 10 + trianglesPerTile() * (m_mazeSize.second * x + y) + (2 * cornerNumber);
+    return TILE_CORNER_TRIANGLES_BEGIN + TRIANGLES_PER_TILE * (m_mazeSize.second * x + y) + (2 * cornerNumber);
 }
 
 int BufferInterface::getTileGraphicFogStartingIndex(int x, int y) {
-    return 18 + trianglesPerTile() * (m_mazeSize.second * x + y);
+    return TILE_FOG_TRIANGLES_BEGIN + TRIANGLES_PER_TILE * (m_mazeSize.second * x + y);
 }
 
 int BufferInterface::getTileGraphicTextStartingIndex(int x, int y, int row, int col) {
@@ -1,13 +1,15 @@
 #pragma once
 
-#include <QChar>
 #include <QPair>
+#include <QString>
 #include <QVector>
 
 #include "Color.h"
 #include "Direction.h"
 #include "Polygon.h"
+#include "TileGeometry.h"
 #include "TileGraphicTextCache.h"
+#include "TileImage.h"
 #include "TriangleGraphic.h"
 #include "TriangleTexture.h"
 
@@ -17,10 +19,30 @@ class BufferInterface {
 
 public:
 
+    // If tileImage is not null, the tiles are written into it rather than
+    // into the cpu buffers, and tile text is not drawn at all
     BufferInterface(
         QPair<int, int> mazeSize,
         QVector<TriangleGraphic>* graphicCpuBuffer,
-        QVector<TriangleTexture>* textureCpuBuffer);
+        QVector<TriangleTexture>* textureCpuBuffer,
+        TileImage* tileImage);
+
+    // The layout of each tile's triangles in the graphic cpu buffer, which
+    // is predetermined as follows:
+    // Base polygon:      2 (2 triangles x 1 polygon  per tile)
+    // Wall polygon:      8 (2 triangles x 4 polygons per tile)
+    // Corner polygon:    8 (2 triangles x 4 polygons per tile)
+    // Fog polygon:       2 (2 triangles x 1 polygon  per tile)
+    // --------------------
+    // Total             20
+    static const int TILE_BASE_TRIANGLES_BEGIN = 0;
+    static const int TILE_WALL_TRIANGLES_BEGIN = 2;
+    static const int TILE_CORNER_TRIANGLES_BEGIN = 10;
+    static const int TILE_FOG_TRIANGLES_BEGIN = 18;
+    static const int TRIANGLES_PER_TILE = 20;
+
+    // Whether the tiles are drawn as a tile image (rather than as polygons)
+    bool usesTileImage() const;
 
     // Initializes and caches all possible tile text positions. We need this
     // extra initialization function since the max size is from the algorithm.
@@ -34,13 +56,17 @@ public:
 
     // Fills the graphic cpu buffer and texture cpu buffer
     void insertIntoGraphicCpuBuffer(const Polygon& polygon, Color color, double alpha);
+    void insertIntoGraphicCpuBuffer(const TileRect& rect, Color color, double alpha);
     void insertIntoTextureCpuBuffer();
 
     // These methods are inexpensive, and may be called many times
     void updateTileGraphicBaseColor(int x, int y, Color color);
     void updateTileGraphicWallColor(int x, int y, Direction direction, Color color, double alpha);
     void updateTileGraphicFog(int x, int y, double alpha);
-    void updateTileGraphicText(int x, int y, int numRows, int numCols, int row, int col, QChar c);
+
+    // Writes all of the characters of a tile's text at once, one string per
+    // row; rows and cols beyond the text (or beyond the max size) are cleared
+    void updateTileGraphicText(int x, int y, const QVector<QString>& rowsOfText);
 
 private:
 
@@ -50,13 +76,13 @@ private:
     // CPU-side buffers
     QVector<TriangleGraphic>* m_graphicCpuBuffer;
     QVector<TriangleTexture>* m_textureCpuBuffer;
+    TileImage* m_tileImage;
 
     // A cache for tile graphic text information
     TileGraphicTextCache m_tileGraphicTextCache;
 
     // Retrieve the indices into the graphic cpu buffer,
     // for each specific type of Tile triangle
-    int trianglesPerTile();
     int getTileGraphicBaseStartingIndex(int x, int y);
     int getTileGraphicWallStartingIndex(int x, int y, Direction direction);
     int getTileGraphicCornerStartingIndex(int x, int y, int cornerNumber);
@@ -65,6 +91,16 @@ private:
     // Retrieve the indices into the texture cpu buffer
     int getTileGraphicTextStartingIndex(int x, int y, int row, int col);
 
+    // Writes a single character's rectangle and font image position
+    static void writeTileGraphicTextCharacter(
+        TriangleTexture* t1,
+        TriangleTexture* t2,
+        double llX,
+        double llY,
+        double urX,
+        double urY,
+        QPair<double, double> fontImageCharacterPosition);
+
 };
 
 } // namespace mms
@@ -1,10 +1,21 @@
 #include "Driver.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QScopedPointer>
+#include <QTimer>
 
 #include "ColorManager.h"
 #include "FontImage.h"
+#include "FrameExporter.h"
 #include "Logging.h"
+#include "MazeAnalyzer.h"
+#include "MazeBenchmark.h"
+#include "MazeConverter.h"
+#include "MazeGenerator.h"
+#include "MazeSymmetry.h"
+#include "Param.h"
 #include "Screen.h"
 #include "Settings.h"
 #include "SimTime.h"
@@ -21,6 +32,167 @@ int Driver::drive(int argc, char* argv[]) {
     // Initialize Qt
     QApplication app(argc, argv);
 
+    // Parse the command line options; these make it possible to run the
+    // simulator unattended, e.g., with "-platform offscreen" on a machine
+    // without a display or GPU
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption mazeOption(
+        "maze",
+        "Load the maze file <path> on startup.",
+        "path");
+    QCommandLineOption mouseAlgoOption(
+        "mouse-algo",
+        "Run the mouse algorithm <name> once the maze is loaded.",
+        "name");
+    QCommandLineOption mazeSymmetryOption(
+        "maze-symmetry",
+        "View the maze turned over by <symmetry> (one of identity, "
+        "rotate-90, rotate-180, rotate-270, mirror, mirror-rotate-90, "
+        "mirror-rotate-180, mirror-rotate-270), or run the mouse algorithm "
+        "in each of them in turn, printing the stats of each run and exiting "
+        "with the worst exit code, if <symmetry> is \"all\".",
+        "symmetry");
+    QCommandLineOption mazeGoalOption(
+        "maze-goal",
+        "Make <tiles> the goal of the maze instead of its center, as x,y "
+        "pairs separated by spaces (e.g., \"0,15 1,15\"), in the maze "
+        "file's coordinates.",
+        "tiles");
+    QCommandLineOption quitOption(
+        "quit-when-done",
+        "Exit with the mouse algorithm's exit code once it finishes.");
+    QCommandLineOption timelinesDirOption(
+        "timelines-dir",
+        "Save the exploration timeline of each run (the tiles in the order "
+        "the mouse first entered them, with when it did, how often it "
+        "entered them, and how long it spent in them) as a CSV file in <dir>.",
+        "dir");
+    QCommandLineOption framesDirOption(
+        "frames-dir",
+        "Save a PNG sequence of the map to <dir>.",
+        "dir");
+    QCommandLineOption framesEncoderOption(
+        "frames-encoder",
+        "Pipe raw RGBA frames of the map to the stdin of <command>.",
+        "command");
+    QCommandLineOption framesIntervalOption(
+        "frames-interval",
+        "Capture a frame every <seconds> of sim time (default 0.1).",
+        "seconds",
+        "0.1");
+    QCommandLineOption framesSizeOption(
+        "frames-size",
+        "Size of the captured frames, in pixels (default 640x640).",
+        "WxH",
+        "640x640");
+    QCommandLineOption benchmarkOption(
+        "benchmark",
+        "Time loading, checking, and drawing generated mazes of each of the "
+        "comma-separated <sizes>, print the results, and exit.",
+        "sizes");
+    QCommandLineOption convertMazesOption(
+        "convert-mazes",
+        "Convert every maze file in <dir> (recursively) to the binary .mzb "
+        "format, on all cores, and exit.",
+        "dir");
+    QCommandLineOption hashMazesOption(
+        "hash-mazes",
+        "Print the canonical hash (the same for all rotations and mirrorings) "
+        "and path of every maze file in <dir> (recursively), sorted by hash, "
+        "and exit.",
+        "dir");
+    QCommandLineOption generateMazesOption(
+        "generate-mazes",
+        "Generate mazes in-process, on all cores, into <dir> as .mzb files, "
+        "and exit.",
+        "dir");
+    QCommandLineOption mazeAlgoOption(
+        "maze-algo",
+        "Generate mazes with <algo>, either a built-in algorithm (random or "
+        "tomasz) or the path of a plugin built from "
+        "maze/templates/c++/Plugin.cpp (default random).",
+        "algo",
+        "random");
+    QCommandLineOption generateCountOption(
+        "generate-count",
+        "Generate <count> mazes (default 1000).",
+        "count",
+        "1000");
+    QCommandLineOption generateSizeOption(
+        "generate-size",
+        "Size of the generated mazes, in tiles (default 16x16).",
+        "WxH",
+        "16x16");
+    QCommandLineOption generateSeedOption(
+        "generate-seed",
+        "Seed of the generated mazes (default 0); the same seed always "
+        "generates the same mazes.",
+        "seed",
+        "0");
+    QCommandLineOption generateValidityOption(
+        "generate-validity",
+        "Keep only the generated mazes that are at least <validity> (one of "
+        "invalid, drawable, explorable, official; default invalid).",
+        "validity",
+        "invalid");
+    QCommandLineOption analyzeMazesOption(
+        "analyze-mazes",
+        "Measure the structure and difficulty of every maze file in <dir> "
+        "(recursively), on all cores, write a report with a row per file, "
+        "and exit.",
+        "dir");
+    QCommandLineOption analyzeReportOption(
+        "analyze-report",
+        "Write the report to <path>, as JSON if it ends in .json and as CSV "
+        "otherwise (default: CSV to stdout).",
+        "path");
+    QCommandLineOption analyzeSpeedOption(
+        "analyze-speed",
+        "Top speed of the mouse whose run time is reported, in meters per "
+        "second (default 2).",
+        "speed",
+        "2");
+    QCommandLineOption analyzeAccelerationOption(
+        "analyze-acceleration",
+        "Acceleration (and deceleration) of the mouse whose run time is "
+        "reported, in meters per second squared (default 5).",
+        "acceleration",
+        "5");
+    QCommandLineOption analyzeTurnTimeOption(
+        "analyze-turn-time",
+        "Time that the mouse whose run time is reported takes to turn 90 "
+        "degrees in place, in seconds (default 0.2).",
+        "seconds",
+        "0.2");
+    parser.addOptions({
+        mazeOption,
+        mouseAlgoOption,
+        mazeSymmetryOption,
+        mazeGoalOption,
+        quitOption,
+        timelinesDirOption,
+        framesDirOption,
+        framesEncoderOption,
+        framesIntervalOption,
+        framesSizeOption,
+        benchmarkOption,
+        convertMazesOption,
+        hashMazesOption,
+        generateMazesOption,
+        mazeAlgoOption,
+        generateCountOption,
+        generateSizeOption,
+        generateSeedOption,
+        generateValidityOption,
+        analyzeMazesOption,
+        analyzeReportOption,
+        analyzeSpeedOption,
+        analyzeAccelerationOption,
+        analyzeTurnTimeOption,
+    });
+    parser.process(app);
+
     // Initialize logging
     Logging::init();
 
@@ -36,10 +208,215 @@ int Driver::drive(int argc, char* argv[]) {
     // Initialize the Param object
     P();
 
+    // Run the benchmark instead of the simulator, if requested
+    if (parser.isSet(benchmarkOption)) {
+        QVector<int> sizes;
+        for (const QString& size : parser.value(benchmarkOption).split(',')) {
+            bool ok = false;
+            int value = size.toInt(&ok);
+            if (!ok || value <= 0) {
+                qWarning().noquote().nospace()
+                    << "Invalid benchmark size: " << size;
+                return 1;
+            }
+            sizes.append(value);
+        }
+        return MazeBenchmark::run(sizes);
+    }
+
+    // Convert a directory of maze files instead, if requested
+    if (parser.isSet(convertMazesOption)) {
+        return MazeConverter::run(parser.value(convertMazesOption));
+    }
+    if (parser.isSet(hashMazesOption)) {
+        return MazeConverter::hash(parser.value(hashMazesOption));
+    }
+
+    // Generate mazes instead, if requested
+    if (parser.isSet(generateMazesOption)) {
+        static const QMap<QString, MazeValidity> stringToValidity = {
+            {"invalid", MazeValidity::INVALID},
+            {"drawable", MazeValidity::DRAWABLE},
+            {"explorable", MazeValidity::EXPLORABLE},
+            {"official", MazeValidity::OFFICIAL},
+        };
+        bool countOk = false;
+        bool seedOk = false;
+        bool widthOk = false;
+        bool heightOk = false;
+        int count = parser.value(generateCountOption).toInt(&countOk);
+        quint64 seed = parser.value(generateSeedOption).toULongLong(&seedOk);
+        QStringList size = parser.value(generateSizeOption).split('x');
+        int width = size.value(0).toInt(&widthOk);
+        int height = size.value(1).toInt(&heightOk);
+        QString validity = parser.value(generateValidityOption);
+        if (!countOk || count < 0) {
+            qWarning().noquote().nospace()
+                << "Invalid maze count: " << parser.value(generateCountOption);
+            return 1;
+        }
+        if (!seedOk) {
+            qWarning().noquote().nospace()
+                << "Invalid maze seed: " << parser.value(generateSeedOption);
+            return 1;
+        }
+        if (size.size() != 2 || !widthOk || !heightOk || width <= 0 || height <= 0) {
+            qWarning().noquote().nospace()
+                << "Invalid maze size: " << parser.value(generateSizeOption);
+            return 1;
+        }
+        if (!stringToValidity.contains(validity)) {
+            qWarning().noquote().nospace()
+                << "Invalid maze validity: " << validity;
+            return 1;
+        }
+        return MazeGenerator::run(
+            parser.value(generateMazesOption),
+            parser.value(mazeAlgoOption),
+            width,
+            height,
+            count,
+            seed,
+            stringToValidity.value(validity));
+    }
+
+    // Analyze mazes instead, if requested
+    if (parser.isSet(analyzeMazesOption)) {
+        bool speedOk = false;
+        bool accelerationOk = false;
+        bool turnTimeOk = false;
+        MazeRunProfile profile;
+        profile.tileLength = P()->wallLength() + P()->wallWidth();
+        profile.maxSpeed = parser.value(analyzeSpeedOption).toDouble(&speedOk);
+        profile.acceleration =
+            parser.value(analyzeAccelerationOption).toDouble(&accelerationOk);
+        profile.quarterTurnSeconds =
+            parser.value(analyzeTurnTimeOption).toDouble(&turnTimeOk);
+        if (!speedOk || profile.maxSpeed <= 0.0) {
+            qWarning().noquote().nospace()
+                << "Invalid speed: " << parser.value(analyzeSpeedOption);
+            return 1;
+        }
+        if (!accelerationOk || profile.acceleration <= 0.0) {
+            qWarning().noquote().nospace()
+                << "Invalid acceleration: " << parser.value(analyzeAccelerationOption);
+            return 1;
+        }
+        if (!turnTimeOk || profile.quarterTurnSeconds < 0.0) {
+            qWarning().noquote().nospace()
+                << "Invalid turn time: " << parser.value(analyzeTurnTimeOption);
+            return 1;
+        }
+        return MazeAnalyzer::run(
+            parser.value(analyzeMazesOption),
+            parser.value(analyzeReportOption),
+            profile);
+    }
+
+    // Check the symmetry before anything is shown
+    QString mazeSymmetry = parser.value(mazeSymmetryOption);
+    bool sweepSymmetries = mazeSymmetry == "all";
+    if (parser.isSet(mazeSymmetryOption) && !sweepSymmetries &&
+            !STRING_TO_MAZE_SYMMETRY().contains(mazeSymmetry)) {
+        qWarning().noquote().nospace()
+            << "Invalid maze symmetry: " << mazeSymmetry;
+        return 1;
+    }
+    if (sweepSymmetries && !parser.isSet(mouseAlgoOption)) {
+        qWarning().noquote().nospace()
+            << "Sweeping the maze symmetries requires a mouse algorithm.";
+        return 1;
+    }
+
+    // And the goal
+    QVector<QPair<int, int>> mazeGoal;
+    QStringList tiles = parser.value(mazeGoalOption).split(' ', QString::SkipEmptyParts);
+    for (const QString& tile : tiles) {
+        QStringList position = tile.split(',');
+        bool xOk = false;
+        bool yOk = false;
+        int x = position.value(0).toInt(&xOk);
+        int y = position.value(1).toInt(&yOk);
+        if (position.size() != 2 || !xOk || !yOk || x < 0 || y < 0) {
+            qWarning().noquote().nospace()
+                << "Invalid goal tile: " << tile;
+            return 1;
+        }
+        mazeGoal.append({x, y});
+    }
+
+    // Create the frame exporter, if requested; it must outlive the window
+    QScopedPointer<FrameExporter> frameExporter;
+    if (parser.isSet(framesDirOption) || parser.isSet(framesEncoderOption)) {
+        bool intervalOk = false;
+        double interval = parser.value(framesIntervalOption).toDouble(&intervalOk);
+        QStringList size = parser.value(framesSizeOption).split('x');
+        bool widthOk = false;
+        bool heightOk = false;
+        int width = size.value(0).toInt(&widthOk);
+        int height = size.value(1).toInt(&heightOk);
+        if (!intervalOk || interval < 0.0) {
+            qWarning().noquote().nospace()
+                << "Invalid frame interval: " << parser.value(framesIntervalOption);
+            return 1;
+        }
+        if (size.size() != 2 || !widthOk || !heightOk || width <= 0 || height <= 0) {
+            qWarning().noquote().nospace()
+                << "Invalid frame size: " << parser.value(framesSizeOption);
+            return 1;
+        }
+        frameExporter.reset(new FrameExporter(
+            parser.value(framesDirOption),
+            parser.value(framesEncoderOption),
+            Duration::Seconds(interval),
+            {width, height}));
+    }
+
     // Create the main window
     Window window;
+    window.setFrameExporter(frameExporter.data());
+    if (parser.isSet(timelinesDirOption)) {
+        window.setTimelineDirectory(parser.value(timelinesDirOption));
+    }
     window.show();
 
+    // Headless runs exit with a failure rather than carry on without a maze
+    bool headless = (
+        parser.isSet(quitOption) ||
+        sweepSymmetries ||
+        parser.isSet(framesDirOption) ||
+        parser.isSet(framesEncoderOption) ||
+        parser.isSet(framesIntervalOption) ||
+        parser.isSet(framesSizeOption)
+    );
+
+    // Apply the remaining options once the event loop is running, so that
+    // exiting (e.g., if the algorithm can't start) takes effect
+    QTimer::singleShot(0, &window, [&](){
+        if (parser.isSet(mazeSymmetryOption) && !sweepSymmetries) {
+            window.setMazeSymmetry(STRING_TO_MAZE_SYMMETRY().value(mazeSymmetry));
+        }
+        if (!mazeGoal.isEmpty()) {
+            window.setMazeGoal(mazeGoal);
+        }
+        if (parser.isSet(mazeOption) && !window.loadMazeFile(parser.value(mazeOption))) {
+            // The algorithm would otherwise run in whichever maze was loaded
+            // before, and its results would be taken for this one's
+            if (headless) {
+                app.exit(1);
+            }
+            return;
+        }
+        if (parser.isSet(mouseAlgoOption) && sweepSymmetries) {
+            window.sweepMouseAlgo(parser.value(mouseAlgoOption));
+        }
+        else if (parser.isSet(mouseAlgoOption)) {
+            window.startMouseAlgo(
+                parser.value(mouseAlgoOption),
+                parser.isSet(quitOption));
+        }
+    });
+
     // Start the event loop
     return app.exec();
 }
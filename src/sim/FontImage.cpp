@@ -27,7 +27,18 @@ QMap<QChar, QPair<double, double>> FontImage::positions() {
     return m_positions;
 }
 
-FontImage::FontImage() {
+bool FontImage::contains(QChar c) const {
+    ushort code = c.unicode();
+    return code < NUM_ASCII_CHARS && 0.0 <= m_asciiPositions.at(code).first;
+}
+
+QPair<double, double> FontImage::position(QChar c) const {
+    ASSERT_TR(contains(c));
+    return m_asciiPositions.at(c.unicode());
+}
+
+FontImage::FontImage() :
+        m_asciiPositions(NUM_ASCII_CHARS, {-1.0, -1.0}) {
 
     // Initialize the font image path if necessary
     QString comboBoxValue = SettingsMisc::getFontImagePathComboBoxValue();
@@ -65,6 +76,8 @@ FontImage::FontImage() {
         double start = static_cast<double>(i + 0) / static_cast<double>(size);
         double end   = static_cast<double>(i + 1) / static_cast<double>(size);
         m_positions.insert(fontImageChars.at(i), {start, end});
+        ASSERT_LT(fontImageChars.at(i).unicode(), NUM_ASCII_CHARS);
+        m_asciiPositions[fontImageChars.at(i).unicode()] = {start, end};
     }
 }
 
@@ -3,6 +3,7 @@
 #include <QChar>
 #include <QMap>
 #include <QPair>
+#include <QVector>
 
 namespace mms {
 
@@ -14,12 +15,22 @@ public:
     QString imageFilePath();
     QMap<QChar, QPair<double, double>> positions();
 
+    // Constant-time versions of positions().contains(c) and
+    // positions().value(c), backed by a table indexed by ASCII code
+    bool contains(QChar c) const;
+    QPair<double, double> position(QChar c) const;
+
 private:
     FontImage();
     static FontImage* INSTANCE;
     QString m_imageFilePath;
     QMap<QChar, QPair<double, double>> m_positions;
 
+    // The same positions, indexed by ASCII code; the characters that aren't
+    // in the font image are marked with a start position of -1.0
+    static const int NUM_ASCII_CHARS = 128;
+    QVector<QPair<double, double>> m_asciiPositions;
+
 };
 
 } // namespace mms
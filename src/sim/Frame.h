@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QPair>
+#include <QVector>
+
+#include "TileImage.h"
+#include "TriangleGraphic.h"
+#include "TriangleTexture.h"
+
+namespace mms {
+
+// A snapshot of everything the map draws for a single frame. The buffers are
+// implicitly shared copies, so taking a snapshot is cheap and the snapshot
+// can be rasterized on another thread while the simulation keeps going.
+struct Frame {
+
+    // The physical size of the maze and the wall width (in meters)
+    QPair<double, double> physicalMazeSize;
+    double wallWidth;
+
+    // The tiles and the tile text of the current view, in the physical frame
+    QVector<TriangleGraphic> graphicBuffer;
+    QVector<TriangleTexture> textureBuffer;
+
+    // Used instead of the buffers above for large mazes (null otherwise)
+    TileImage tileImage;
+
+    // The rigid parts of the mouse, in the mouse's local frame, along with
+    // the matrix that poses them (empty if there is no mouse)
+    QVector<TriangleGraphic> mouseBuffer;
+    QVector<float> mouseMatrix;
+
+    // The sensor views, in the physical frame
+    QVector<TriangleGraphic> sensorViewBuffer;
+};
+
+} // namespace mms
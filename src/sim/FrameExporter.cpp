@@ -0,0 +1,200 @@
+#include "FrameExporter.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QEvent>
+#include <QFile>
+
+#include "Assert.h"
+#include "FontImage.h"
+#include "FrameRasterizer.h"
+#include "FunctionTask.h"
+#include "Param.h"
+#include "ProcessUtilities.h"
+#include "SimTime.h"
+#include "TransformationMatrix.h"
+
+namespace mms {
+
+FrameExporter::FrameExporter(
+        const QString& directory,
+        const QString& encoderCommand,
+        const Duration& interval,
+        QPair<int, int> frameSize) :
+        m_directory(directory),
+        m_encoderProcess(nullptr),
+        m_interval(interval),
+        m_frameSize(frameSize),
+        m_capturedAny(false),
+        m_nextFrameIndex(0),
+        m_framesInFlight(0),
+        m_framesDropped(0),
+        m_nextFrameToWrite(0) {
+
+    ASSERT_LT(0, m_frameSize.first);
+    ASSERT_LT(0, m_frameSize.second);
+
+    if (!m_directory.isEmpty() && !QDir().mkpath(m_directory)) {
+        qWarning().noquote().nospace()
+            << "Could not create the frame directory \"" << m_directory
+            << "\"; frames will not be saved as images.";
+        m_directory = "";
+    }
+
+    if (!encoderCommand.isEmpty()) {
+        m_encoderProcess = new QProcess(this);
+        m_encoderProcess->setProcessChannelMode(QProcess::ForwardedChannels);
+        if (!ProcessUtilities::start(
+                encoderCommand,
+                QDir::currentPath(),
+                m_encoderProcess)) {
+            qWarning().noquote().nospace()
+                << "Could not start the frame encoder \"" << encoderCommand
+                << "\": " << m_encoderProcess->errorString();
+            delete m_encoderProcess;
+            m_encoderProcess = nullptr;
+        }
+    }
+
+    // Same font image as the map, converted once so that the workers can
+    // sample it directly
+    if (QFile::exists(FontImage::get()->imageFilePath())) {
+        m_fontImage = QImage(FontImage::get()->imageFilePath()).convertToFormat(
+            QImage::Format_ARGB32);
+    }
+}
+
+FrameExporter::~FrameExporter() {
+
+    // Wait for the workers, and then deliver their queued results
+    m_threadPool.waitForDone();
+    QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+    ASSERT_EQ(m_framesInFlight, 0);
+    ASSERT_TR(m_pendingFrames.isEmpty());
+
+    if (m_encoderProcess != nullptr) {
+        m_encoderProcess->closeWriteChannel();
+        m_encoderProcess->waitForFinished(-1);
+    }
+
+    if (0 < m_framesDropped) {
+        qWarning().noquote().nospace()
+            << "Dropped " << m_framesDropped << " of "
+            << m_nextFrameIndex + m_framesDropped
+            << " frames because rendering couldn't keep up.";
+    }
+}
+
+void FrameExporter::capture(
+        const Maze* maze,
+        const MazeView* view,
+        const MouseGraphic* mouseGraphic) {
+
+    if (maze == nullptr || view == nullptr) {
+        return;
+    }
+    if (m_directory.isEmpty() && m_encoderProcess == nullptr) {
+        return;
+    }
+
+    // Sim time starts over whenever a new mouse is added
+    Duration now = SimTime::get()->elapsedSimTime();
+    if (now < m_lastCaptureTime) {
+        m_capturedAny = false;
+    }
+    if (m_capturedAny && now < m_lastCaptureTime + m_interval) {
+        return;
+    }
+    m_capturedAny = true;
+    m_lastCaptureTime = now;
+
+    // Rather than slowing down the simulation, drop frames if the workers
+    // can't keep up (bounds the memory held by snapshots, too)
+    if (2 * m_threadPool.maxThreadCount() <= m_framesInFlight) {
+        m_framesDropped += 1;
+        return;
+    }
+
+    Frame frame;
+    frame.wallWidth = P()->wallWidth();
+    frame.physicalMazeSize = {
+        P()->wallWidth() + maze->getWidth() * (P()->wallWidth() + P()->wallLength()),
+        P()->wallWidth() + maze->getHeight() * (P()->wallWidth() + P()->wallLength()),
+    };
+    frame.graphicBuffer = *view->getGraphicCpuBuffer();
+    frame.textureBuffer = *view->getTextureCpuBuffer();
+    if (view->getTileImage() != nullptr) {
+        frame.tileImage = *view->getTileImage();
+    }
+    if (mouseGraphic != nullptr) {
+        QPair<Coordinate, Angle> position = mouseGraphic->getCurrentMousePosition();
+        frame.mouseBuffer = mouseGraphic->getStaticBuffer();
+        frame.mouseMatrix = TransformationMatrix::getMouseTransformationMatrix(
+            position.first,
+            position.second);
+        frame.sensorViewBuffer = mouseGraphic->drawSensorViews(
+            position.first,
+            position.second);
+    }
+
+    int index = m_nextFrameIndex;
+    m_nextFrameIndex += 1;
+    m_framesInFlight += 1;
+    m_threadPool.start(new FunctionTask([=](){
+        render(index, frame);
+    }));
+}
+
+void FrameExporter::onFrameRendered(int index, QByteArray rgba) {
+    m_framesInFlight -= 1;
+    if (m_encoderProcess != nullptr) {
+        m_pendingFrames.insert(index, rgba);
+        flushPendingFrames();
+    }
+}
+
+void FrameExporter::render(int index, const Frame& frame) const {
+
+    QImage image = FrameRasterizer::rasterize(frame, m_frameSize, m_fontImage);
+
+    // PNG compression is the expensive part, so it happens here too
+    if (!m_directory.isEmpty()) {
+        QString path = QDir(m_directory).filePath(
+            QString("frame-%1.png").arg(index, 6, 10, QChar('0')));
+        if (!image.save(path, "PNG")) {
+            qWarning().noquote().nospace()
+                << "Could not save frame \"" << path << "\".";
+        }
+    }
+
+    QByteArray rgba;
+    if (m_encoderProcess != nullptr) {
+        QImage converted = image.convertToFormat(QImage::Format_RGBA8888);
+        int rowBytes = 4 * converted.width();
+        rgba.reserve(rowBytes * converted.height());
+        for (int y = 0; y < converted.height(); y += 1) {
+            rgba.append(
+                reinterpret_cast<const char*>(converted.constScanLine(y)),
+                rowBytes);
+        }
+    }
+
+    // The encoder process belongs to this object's thread, so hand the
+    // frame back rather than writing to it from here
+    QMetaObject::invokeMethod(
+        const_cast<FrameExporter*>(this),
+        "onFrameRendered",
+        Qt::QueuedConnection,
+        Q_ARG(int, index),
+        Q_ARG(QByteArray, rgba));
+}
+
+void FrameExporter::flushPendingFrames() {
+    while (m_pendingFrames.contains(m_nextFrameToWrite)) {
+        m_encoderProcess->write(m_pendingFrames.take(m_nextFrameToWrite));
+        m_nextFrameToWrite += 1;
+    }
+}
+
+} // namespace mms
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QMap>
+#include <QObject>
+#include <QPair>
+#include <QProcess>
+#include <QString>
+#include <QThreadPool>
+
+#include "Frame.h"
+#include "Maze.h"
+#include "MazeView.h"
+#include "MouseGraphic.h"
+#include "units/Duration.h"
+
+namespace mms {
+
+// Periodically snapshots the map and, on a background thread pool, renders
+// the snapshots with the FrameRasterizer. Rendered frames are saved as a PNG
+// sequence and/or piped (in order, as raw RGBA) to an encoder's stdin, e.g.:
+//
+//   ffmpeg -f rawvideo -pix_fmt rgba -s 640x640 -r 30 -i - out.mp4
+//
+class FrameExporter : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    // Either the directory or the encoder command may be empty
+    FrameExporter(
+        const QString& directory,
+        const QString& encoderCommand,
+        const Duration& interval,
+        QPair<int, int> frameSize);
+
+    // Waits for the outstanding frames and closes the encoder
+    ~FrameExporter();
+
+    // Snapshots the view if at least one interval of sim time has elapsed
+    // since the previous snapshot; this is cheap, and meant to be called
+    // once per tick of the graphics loop
+    void capture(
+        const Maze* maze,
+        const MazeView* view,
+        const MouseGraphic* mouseGraphic);
+
+private slots:
+
+    // Called on this object's thread when a worker finishes a frame
+    void onFrameRendered(int index, QByteArray rgba);
+
+private:
+
+    QString m_directory;
+    QProcess* m_encoderProcess;
+    Duration m_interval;
+    QPair<int, int> m_frameSize;
+    QImage m_fontImage;
+    QThreadPool m_threadPool;
+
+    // Capture bookkeeping
+    bool m_capturedAny;
+    Duration m_lastCaptureTime;
+    int m_nextFrameIndex;
+    int m_framesInFlight;
+    int m_framesDropped;
+
+    // Frames that finished out of order, waiting to be written to the encoder
+    QMap<int, QByteArray> m_pendingFrames;
+    int m_nextFrameToWrite;
+
+    // Renders and saves a single frame; runs on the thread pool
+    void render(int index, const Frame& frame) const;
+
+    // Writes every pending frame that's next in line to the encoder
+    void flushPendingFrames();
+};
+
+} // namespace mms
@@ -0,0 +1,219 @@
+#include "FrameRasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Assert.h"
+#include "Param.h"
+#include "TransformationMatrix.h"
+
+namespace mms {
+
+QImage FrameRasterizer::rasterize(
+        const Frame& frame,
+        QPair<int, int> imageSize,
+        const QImage& fontImage) {
+
+    ASSERT_LT(0, imageSize.first);
+    ASSERT_LT(0, imageSize.second);
+
+    // Same background as the map
+    QImage image(imageSize.first, imageSize.second, QImage::Format_RGB32);
+    image.fill(Qt::black);
+
+    // Scale the maze uniformly so that it fits within the image, center it,
+    // and flip the y axis (physical y points up, image y points down). Note
+    // that the physical point (0,0) is the middle of the bottom-left corner.
+    double physicalWidth = frame.physicalMazeSize.first;
+    double physicalHeight = frame.physicalMazeSize.second;
+    double pixelsPerMeter = std::min(
+        imageSize.first / physicalWidth,
+        imageSize.second / physicalHeight);
+    double left = 0.5 * (imageSize.first - pixelsPerMeter * physicalWidth);
+    double bottom = 0.5 * (imageSize.second + pixelsPerMeter * physicalHeight);
+    double x = left + 0.5 * frame.wallWidth * pixelsPerMeter;
+    double y = bottom - 0.5 * frame.wallWidth * pixelsPerMeter;
+    QVector<float> mapMatrix = {
+        static_cast<float>(pixelsPerMeter), 0.0, 0.0, static_cast<float>(x),
+        0.0, static_cast<float>(-pixelsPerMeter), 0.0, static_cast<float>(y),
+        0.0, 0.0, 1.0, 0.0,
+        0.0, 0.0, 0.0, 1.0,
+    };
+
+    // Draw in the same order as the map does
+    drawTriangles(&image, frame.graphicBuffer, mapMatrix);
+    if (!frame.tileImage.isNull()) {
+        drawTileImage(&image, frame.tileImage, mapMatrix);
+    }
+    drawTextures(&image, frame.textureBuffer, fontImage, mapMatrix);
+    if (!frame.mouseBuffer.isEmpty()) {
+        drawTriangles(
+            &image,
+            frame.mouseBuffer,
+            TransformationMatrix::multiply4x4Matrices(
+                mapMatrix,
+                frame.mouseMatrix));
+    }
+    drawTriangles(&image, frame.sensorViewBuffer, mapMatrix);
+
+    return image;
+}
+
+void FrameRasterizer::drawTriangles(
+        QImage* image,
+        const QVector<TriangleGraphic>& triangles,
+        const QVector<float>& matrix) {
+    ASSERT_EQ(matrix.size(), 16);
+    for (const TriangleGraphic& triangle : triangles) {
+        const VertexGraphic* p[3] = {&triangle.p1, &triangle.p2, &triangle.p3};
+        double xs[3];
+        double ys[3];
+        for (int i = 0; i < 3; i += 1) {
+            xs[i] = matrix.at(0) * p[i]->x + matrix.at(1) * p[i]->y + matrix.at(3);
+            ys[i] = matrix.at(4) * p[i]->x + matrix.at(5) * p[i]->y + matrix.at(7);
+        }
+        fillTriangle(image, xs, ys, [&](QRgb* pixel, double w1, double w2, double w3){
+            blend(
+                pixel,
+                w1 * p[0]->rgb.r + w2 * p[1]->rgb.r + w3 * p[2]->rgb.r,
+                w1 * p[0]->rgb.g + w2 * p[1]->rgb.g + w3 * p[2]->rgb.g,
+                w1 * p[0]->rgb.b + w2 * p[1]->rgb.b + w3 * p[2]->rgb.b,
+                w1 * p[0]->a + w2 * p[1]->a + w3 * p[2]->a);
+        });
+    }
+}
+
+void FrameRasterizer::drawTileImage(
+        QImage* image,
+        const TileImage& tileImage,
+        const QVector<float>& matrix) {
+    ASSERT_EQ(matrix.size(), 16);
+
+    // The matrix only scales and translates, so each pixel maps straight back
+    // to a physical point; the tile image covers the whole maze, walls included
+    double halfWallWidth = 0.5 * P()->wallWidth();
+    double tileLength = P()->wallWidth() + P()->wallLength();
+    double physicalRight = tileImage.getMazeWidth() * tileLength + halfWallWidth;
+    double physicalTop = tileImage.getMazeHeight() * tileLength + halfWallWidth;
+    int minX = std::max(0, static_cast<int>(std::ceil(
+        matrix.at(0) * -halfWallWidth + matrix.at(3) - 0.5)));
+    int maxX = std::min(image->width() - 1, static_cast<int>(std::floor(
+        matrix.at(0) * physicalRight + matrix.at(3) - 0.5)));
+    int minY = std::max(0, static_cast<int>(std::ceil(
+        matrix.at(5) * physicalTop + matrix.at(7) - 0.5)));
+    int maxY = std::min(image->height() - 1, static_cast<int>(std::floor(
+        matrix.at(5) * -halfWallWidth + matrix.at(7) - 0.5)));
+    for (int py = minY; py <= maxY; py += 1) {
+        QRgb* line = reinterpret_cast<QRgb*>(image->scanLine(py));
+        double y = (py + 0.5 - matrix.at(7)) / matrix.at(5);
+        for (int px = minX; px <= maxX; px += 1) {
+            double x = (px + 0.5 - matrix.at(3)) / matrix.at(0);
+            line[px] = tileImage.sample(x, y);
+        }
+    }
+}
+
+void FrameRasterizer::drawTextures(
+        QImage* image,
+        const QVector<TriangleTexture>& triangles,
+        const QImage& fontImage,
+        const QVector<float>& matrix) {
+    ASSERT_EQ(matrix.size(), 16);
+    if (fontImage.isNull()) {
+        return;
+    }
+    ASSERT_EQ(fontImage.format(), QImage::Format_ARGB32);
+    int fontWidth = fontImage.width();
+    int fontHeight = fontImage.height();
+    for (const TriangleTexture& triangle : triangles) {
+        const VertexTexture* p[3] = {&triangle.p1, &triangle.p2, &triangle.p3};
+        double xs[3];
+        double ys[3];
+        for (int i = 0; i < 3; i += 1) {
+            xs[i] = matrix.at(0) * p[i]->x + matrix.at(1) * p[i]->y + matrix.at(3);
+            ys[i] = matrix.at(4) * p[i]->x + matrix.at(5) * p[i]->y + matrix.at(7);
+        }
+        fillTriangle(image, xs, ys, [&](QRgb* pixel, double w1, double w2, double w3){
+            // The map uploads a mirrored copy of the font image, so texture
+            // coordinate v = 0 refers to the bottom row of the unmirrored one
+            double u = w1 * p[0]->u + w2 * p[1]->u + w3 * p[2]->u;
+            double v = w1 * p[0]->v + w2 * p[1]->v + w3 * p[2]->v;
+            int tx = std::min(std::max(static_cast<int>(u * fontWidth), 0), fontWidth - 1);
+            int ty = std::min(std::max(static_cast<int>((1.0 - v) * fontHeight), 0), fontHeight - 1);
+            QRgb texel = reinterpret_cast<const QRgb*>(fontImage.constScanLine(ty))[tx];
+            blend(
+                pixel,
+                qRed(texel) / 255.0,
+                qGreen(texel) / 255.0,
+                qBlue(texel) / 255.0,
+                qAlpha(texel) / 255.0);
+        });
+    }
+}
+
+template <typename Shader>
+void FrameRasterizer::fillTriangle(
+        QImage* image,
+        const double (&xs)[3],
+        const double (&ys)[3],
+        Shader shade) {
+
+    // Twice the signed area; degenerate triangles cover no pixels
+    double area = (xs[1] - xs[0]) * (ys[2] - ys[0]) - (xs[2] - xs[0]) * (ys[1] - ys[0]);
+    if (area == 0.0) {
+        return;
+    }
+
+    // Pixels centered exactly on an edge shared by two triangles (e.g., the
+    // halves of a translucent fog square) must only be drawn once, so each
+    // edge only keeps such pixels if the triangle lies above it (or, for
+    // horizontal edges, to its right)
+    bool keepEdge[3];
+    for (int i = 0; i < 3; i += 1) {
+        int a = (i + 1) % 3;
+        int b = (i + 2) % 3;
+        double normalX = ys[a] - ys[b];
+        double normalY = xs[b] - xs[a];
+        if (normalX * (xs[i] - xs[a]) + normalY * (ys[i] - ys[a]) < 0.0) {
+            normalX = -normalX;
+            normalY = -normalY;
+        }
+        keepEdge[i] = normalY < 0.0 || (normalY == 0.0 && normalX > 0.0);
+    }
+
+    // Only visit the pixels within the (clipped) bounding box
+    int minX = std::max(0, static_cast<int>(std::floor(std::min({xs[0], xs[1], xs[2]}))));
+    int maxX = std::min(image->width() - 1, static_cast<int>(std::ceil(std::max({xs[0], xs[1], xs[2]}))));
+    int minY = std::max(0, static_cast<int>(std::floor(std::min({ys[0], ys[1], ys[2]}))));
+    int maxY = std::min(image->height() - 1, static_cast<int>(std::ceil(std::max({ys[0], ys[1], ys[2]}))));
+
+    for (int py = minY; py <= maxY; py += 1) {
+        QRgb* line = reinterpret_cast<QRgb*>(image->scanLine(py));
+        double cy = py + 0.5;
+        for (int px = minX; px <= maxX; px += 1) {
+            double cx = px + 0.5;
+            double w[3];
+            bool inside = true;
+            for (int i = 0; i < 3 && inside; i += 1) {
+                int a = (i + 1) % 3;
+                int b = (i + 2) % 3;
+                w[i] = ((xs[a] - cx) * (ys[b] - cy) - (xs[b] - cx) * (ys[a] - cy)) / area;
+                inside = 0.0 < w[i] || (w[i] == 0.0 && keepEdge[i]);
+            }
+            if (inside) {
+                shade(&line[px], w[0], w[1], w[2]);
+            }
+        }
+    }
+}
+
+void FrameRasterizer::blend(QRgb* pixel, double r, double g, double b, double a) {
+    // Equivalent to glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+    a = std::min(std::max(a, 0.0), 1.0);
+    *pixel = qRgb(
+        static_cast<int>(255.0 * r * a + qRed(*pixel) * (1.0 - a) + 0.5),
+        static_cast<int>(255.0 * g * a + qGreen(*pixel) * (1.0 - a) + 0.5),
+        static_cast<int>(255.0 * b * a + qBlue(*pixel) * (1.0 - a) + 0.5));
+}
+
+} // namespace mms
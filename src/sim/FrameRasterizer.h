@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QImage>
+#include <QPair>
+#include <QVector>
+
+#include "Frame.h"
+
+namespace mms {
+
+// A CPU rasterizer for the map's triangle buffers. It produces the same image
+// as the full map does, but doesn't require a window, an OpenGL context, or a
+// GPU, which makes it usable on headless machines and from worker threads.
+class FrameRasterizer {
+
+public:
+
+    // This class is not constructible
+    FrameRasterizer() = delete;
+
+    // Draws the entire maze, centered and scaled to fit the image. The font
+    // image must be in QImage::Format_ARGB32, unmirrored.
+    static QImage rasterize(
+        const Frame& frame,
+        QPair<int, int> imageSize,
+        const QImage& fontImage);
+
+private:
+
+    // Blends the triangles into the image, after transforming them by the
+    // given 4x4 matrix (which must map physical coordinates to pixels)
+    static void drawTriangles(
+        QImage* image,
+        const QVector<TriangleGraphic>& triangles,
+        const QVector<float>& matrix);
+    static void drawTileImage(
+        QImage* image,
+        const TileImage& tileImage,
+        const QVector<float>& matrix);
+    static void drawTextures(
+        QImage* image,
+        const QVector<TriangleTexture>& triangles,
+        const QImage& fontImage,
+        const QVector<float>& matrix);
+
+    // Calls shade(pixel, w1, w2, w3) for every pixel whose center lies
+    // within the triangle, where w1, w2, and w3 are barycentric weights
+    template <typename Shader>
+    static void fillTriangle(
+        QImage* image,
+        const double (&xs)[3],
+        const double (&ys)[3],
+        Shader shade);
+
+    // Blends a color into a pixel with the given opacity (0.0 to 1.0)
+    static void blend(QRgb* pixel, double r, double g, double b, double a);
+
+};
+
+} // namespace mms
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QRunnable>
+
+#include <functional>
+
+namespace mms {
+
+// Runs a function on a QThreadPool
+class FunctionTask : public QRunnable {
+
+public:
+
+    FunctionTask(std::function<void()> function) : m_function(function) {}
+    void run() { m_function(); }
+
+private:
+
+    std::function<void()> m_function;
+
+};
+
+} // namespace mms
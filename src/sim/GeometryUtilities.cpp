@@ -257,7 +257,7 @@ Coordinate GeometryUtilities::castRay(
             int x = sx + ox - px;
             int y = sy + oy - py;
             if (isOnTileEdge(cy, halfWallWidth, tileLength) ||
-                    (maze.withinMaze(x, y) && maze.getTile(x, y)->isWall(wx))) {
+                    (maze.withinMaze(x, y) && maze.isWall(x, y, wx))) {
                 return Coordinate::Cartesian(cx, cy);
             }
             ox += ix;
@@ -271,7 +271,7 @@ Coordinate GeometryUtilities::castRay(
             int x = sx + ox - px;
             int y = sy + oy - py;
             if (isOnTileEdge(cx, halfWallWidth, tileLength) ||
-                    (maze.withinMaze(x, y) && maze.getTile(x, y)->isWall(wy))) {
+                    (maze.withinMaze(x, y) && maze.isWall(x, y, wy))) {
                 return Coordinate::Cartesian(cx, cy);
             }
             oy += iy;
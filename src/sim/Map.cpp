@@ -1,15 +1,25 @@
 #include "Map.h"
 
 #include <QFile>
+#include <QFontMetrics>
+#include <QPainter>
 #include <QPair>
 
+#include <algorithm>
+#include <cmath>
+
 #include "Assert.h"
+#include "BufferInterface.h"
+#include "Color.h"
 #include "FontImage.h"
 #include "Layout.h"
 #include "Logging.h"
 #include "Param.h"
 #include "Screen.h"
+#include "SimTime.h"
+#include "SimUtilities.h"
 #include "TransformationMatrix.h"
+#include "VertexGraphic.h"
 
 namespace mms {
 
@@ -18,13 +28,34 @@ Map::Map(QWidget* parent) :
     m_maze(nullptr),
     m_view(nullptr),
     m_mouseGraphic(nullptr),
+    m_mouseTrail(nullptr),
     m_windowWidth(0),
     m_windowHeight(0),
     m_layoutType(LayoutType::FULL),
     m_zoomedMapScale(0.1),
     m_rotateZoomedMap(false),
+    m_trailVisible(true),
+    m_heatmapVisible(false),
+    m_hudVisible(false),
+    m_hudFont("Monospace", 9),
+    m_hudSimSteps(0),
+    m_hudAlgoCommands(0),
+    m_uploadBytes(0),
+    m_mouseVBOIsStale(false),
+    m_mouseVBOTriangleCount(0),
+    m_trailVBOIsStale(false),
+    m_trailVBOPoseCount(0),
+    m_heatmapVBOIsStale(false),
+    m_heatmapVBOTileVersion(0),
+    m_heatmapVBOCapacity(0),
+    m_lowDetailIBO(QOpenGLBuffer::IndexBuffer),
+    m_lowDetailIBOTileCount(0),
+    m_lowDetailIBOIndexCount(0),
+    m_tileImageTexture(nullptr),
+    m_tileImageTextureSource(nullptr),
     m_textureAtlas(nullptr) {
     ASSERT_RUNS_JUST_ONCE();
+    m_hudFont.setStyleHint(QFont::TypeWriter);
 }
 
 void Map::setMaze(const Maze* maze) {
@@ -38,6 +69,7 @@ void Map::setView(const MazeView* view) {
         ASSERT_FA(m_maze == nullptr);
     }
     m_view = view;
+    m_tileImageTextureSource = nullptr;
 }
 
 void Map::setMouseGraphic(const MouseGraphic* mouseGraphic) {
@@ -46,6 +78,16 @@ void Map::setMouseGraphic(const MouseGraphic* mouseGraphic) {
         ASSERT_FA(m_view == nullptr);
     }
     m_mouseGraphic = mouseGraphic;
+    m_mouseVBOIsStale = true;
+}
+
+void Map::setMouseTrail(const MouseTrail* mouseTrail) {
+    if (mouseTrail != nullptr) {
+        ASSERT_FA(m_maze == nullptr);
+    }
+    m_mouseTrail = mouseTrail;
+    m_trailVBOIsStale = true;
+    m_heatmapVBOIsStale = true;
 }
 
 void Map::setLayoutType(LayoutType layoutType) {
@@ -60,6 +102,23 @@ void Map::setRotateZoomedMap(bool rotateZoomedMap) {
     m_rotateZoomedMap = rotateZoomedMap;
 }
 
+void Map::setTrailVisible(bool trailVisible) {
+    m_trailVisible = trailVisible;
+}
+
+void Map::setHeatmapVisible(bool heatmapVisible) {
+    m_heatmapVisible = heatmapVisible;
+}
+
+void Map::setHudVisible(bool hudVisible) {
+    m_hudVisible = hudVisible;
+}
+
+void Map::setHudCounters(qint64 simSteps, qint64 algoCommands) {
+    m_hudSimSteps = simSteps;
+    m_hudAlgoCommands = algoCommands;
+}
+
 QVector<QString> Map::getOpenGLVersionInfo() {
     static QVector<QString> openGLVersionInfo;
     if (openGLVersionInfo.empty()) {
@@ -114,9 +173,10 @@ void Map::initializeGL() {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glEnable(GL_BLEND);
 
-    // Initialize the polygon and texture programs
+    // Initialize the polygon, texture, and tile image programs
     initPolygonProgram();
     initTextureProgram();
+    initTileImageProgram();
 }
 
 void Map::paintGL() {
@@ -127,20 +187,45 @@ void Map::paintGL() {
         return;
     }
 
+    // The performance overlay (drawn with a QPainter) may have changed these
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_BLEND);
+    m_uploadBytes = 0;
+
     Coordinate currentMouseTranslation;
     Angle currentMouseRotation;
-    QVector<TriangleGraphic> mouseBuffer;
+    QVector<TriangleGraphic> sensorViewBuffer;
     if (m_mouseGraphic != nullptr) {
         auto currentPosition = m_mouseGraphic->getCurrentMousePosition();
         currentMouseTranslation = currentPosition.first;
         currentMouseRotation = currentPosition.second;
-        mouseBuffer = m_mouseGraphic->draw(
+        sensorViewBuffer = m_mouseGraphic->drawSensorViews(
             currentMouseTranslation,
             currentMouseRotation);
     }
 
     // Re-populate both vertex buffer objects
-    repopulateVertexBufferObjects(mouseBuffer);
+    repopulateVertexBufferObjects(sensorViewBuffer);
+
+    // The rigid parts of the mouse only need to be uploaded once
+    if (m_mouseVBOIsStale) {
+        populateMouseVertexBufferObject();
+    }
+
+    // Upload whatever is new in the trail and heatmap
+    populateTrailVertexBufferObject();
+    populateHeatmapVertexBufferObject();
+
+    // Large mazes are drawn from a tile image instead of the buffers
+    const TileImage* tileImage = m_view->getTileImage();
+    if (tileImage != nullptr) {
+        populateTileImageTexture(tileImage);
+    }
+
+    // The tiles are uniformly sized in both buffers
+    int tileCount = m_maze->getWidth() * m_maze->getHeight();
+    int trianglesPerTile = m_view->getGraphicCpuBuffer()->size() / tileCount;
+    int textureTrianglesPerTile = m_view->getTextureCpuBuffer()->size() / tileCount;
 
     // Clear the screen
     glClear(GL_COLOR_BUFFER_BIT);
@@ -148,8 +233,8 @@ void Map::paintGL() {
     // Enable scissoring so that the maps are only draw in specified locations.
     glEnable(GL_SCISSOR_TEST);
 
-    // Determine the starting index of the mouse
-    int mouseTrianglesStartingIndex = m_view->getGraphicCpuBuffer()->size();
+    // The maze and sensor views are already in physical coordinates
+    QMatrix4x4 identityMatrix;
 
     // Draw the tiles
     drawMap(
@@ -158,9 +243,42 @@ void Map::paintGL() {
         currentMouseRotation,
         &m_polygonProgram,
         &m_polygonVAO,
+        GL_TRIANGLES,
+        identityMatrix,
         0,
-        3 * m_view->getGraphicCpuBuffer()->size()
+        3 * m_view->getGraphicCpuBuffer()->size(),
+        trianglesPerTile
     );
+    if (tileImage != nullptr) {
+        drawMap(
+            m_layoutType,
+            currentMouseTranslation,
+            currentMouseRotation,
+            &m_tileImageProgram,
+            &m_tileImageVAO,
+            GL_TRIANGLES,
+            identityMatrix,
+            0,
+            6,
+            0
+        );
+    }
+
+    // Tint the tiles by how long the mouse has spent in them
+    if (m_heatmapVisible && !m_heatmapTriangles.isEmpty()) {
+        drawMap(
+            m_layoutType,
+            currentMouseTranslation,
+            currentMouseRotation,
+            &m_polygonProgram,
+            &m_heatmapVAO,
+            GL_TRIANGLES,
+            identityMatrix,
+            0,
+            3 * m_heatmapTriangles.size(),
+            0
+        );
+    }
 
     // Overlay the tile text
     if (m_textureAtlas != nullptr) {
@@ -170,25 +288,74 @@ void Map::paintGL() {
             currentMouseRotation,
             &m_textureProgram,
             &m_textureVAO,
+            GL_TRIANGLES,
+            identityMatrix,
+            0,
+            3 * m_view->getTextureCpuBuffer()->size(),
+            textureTrianglesPerTile
+        );
+    }
+
+    // Draw where the mouse has been
+    if (m_trailVisible) {
+        drawTrail(currentMouseTranslation, currentMouseRotation);
+    }
+
+    // Draw the mouse, posed on the GPU
+    if (m_mouseGraphic != nullptr) {
+        auto matrix = TransformationMatrix::getMouseTransformationMatrix(
+            currentMouseTranslation,
+            currentMouseRotation
+        );
+        QMatrix4x4 mouseMatrix(
+            matrix.at(0), matrix.at(1), matrix.at(2), matrix.at(3),
+            matrix.at(4), matrix.at(5), matrix.at(6), matrix.at(7),
+            matrix.at(8), matrix.at(9), matrix.at(10), matrix.at(11),
+            matrix.at(12), matrix.at(13), matrix.at(14), matrix.at(15)
+        );
+        drawMap(
+            m_layoutType,
+            currentMouseTranslation,
+            currentMouseRotation,
+            &m_polygonProgram,
+            &m_mouseVAO,
+            GL_TRIANGLES,
+            mouseMatrix,
             0,
-            3 * m_view->getTextureCpuBuffer()->size()
+            3 * m_mouseVBOTriangleCount,
+            0
         );
     }
 
-    // Draw the mouse
+    // Draw the sensor views
     drawMap(
         m_layoutType,
         currentMouseTranslation,
         currentMouseRotation,
         &m_polygonProgram,
         &m_polygonVAO,
+        GL_TRIANGLES,
+        identityMatrix,
         3 * m_view->getGraphicCpuBuffer()->size(),
-        3 * mouseBuffer.size()
+        3 * sensorViewBuffer.size(),
+        0
     );
 
     // Disable scissoring so that the glClear can take effect, and so that
     // drawn text isn't clipped at all
     glDisable(GL_SCISSOR_TEST);
+
+    // Always record the frame, so that the stats are ready when shown
+    m_hud.recordFrame(
+        SimUtilities::getHighResTimestamp(),
+        SimTime::get()->elapsedSimTime().getSeconds(),
+        m_hudSimSteps,
+        m_hudAlgoCommands,
+        m_uploadBytes
+    );
+    if (m_hudVisible) {
+        drawHud();
+    }
 }
 
 void Map::resizeGL(int width, int height) {
@@ -196,18 +363,72 @@ void Map::resizeGL(int width, int height) {
     m_windowHeight = height;
 }
 
+void Map::mousePressEvent(QMouseEvent* event) {
+
+    // Only the full map shows the whole maze in a fixed place
+    if (m_maze == nullptr ||
+            (m_layoutType != LayoutType::FULL && m_mouseGraphic != nullptr)) {
+        return;
+    }
+
+    // Invert the full map's transformation to get the physical coordinate of
+    // the click, where (0, 0) is the middle of the bottom-left corner post
+    double tileLength = P()->wallWidth() + P()->wallLength();
+    auto matrix = TransformationMatrix::getFullMapTransformationMatrix(
+        Distance::Meters(P()->wallWidth()),
+        {
+            P()->wallWidth() + m_maze->getWidth() * tileLength,
+            P()->wallWidth() + m_maze->getHeight() * tileLength,
+        },
+        Layout::getFullMapPosition(),
+        Layout::getFullMapSize(m_windowWidth, m_windowHeight),
+        {m_windowWidth, m_windowHeight}
+    );
+    bool invertible = false;
+    QMatrix4x4 inverse = QMatrix4x4(
+        matrix.at(0), matrix.at(1), matrix.at(2), matrix.at(3),
+        matrix.at(4), matrix.at(5), matrix.at(6), matrix.at(7),
+        matrix.at(8), matrix.at(9), matrix.at(10), matrix.at(11),
+        matrix.at(12), matrix.at(13), matrix.at(14), matrix.at(15)
+    ).inverted(&invertible);
+    if (!invertible) {
+        return;
+    }
+    QPointF physical = inverse.map(QPointF(
+        2.0 * event->x() / m_windowWidth - 1.0,
+        1.0 - 2.0 * event->y() / m_windowHeight));
+
+    // Pick the tile, and then the side of it that's closest to the click
+    int x = static_cast<int>(std::floor(physical.x() / tileLength));
+    int y = static_cast<int>(std::floor(physical.y() / tileLength));
+    if (!m_maze->withinMaze(x, y)) {
+        return;
+    }
+    double u = physical.x() - x * tileLength;
+    double v = physical.y() - y * tileLength;
+    QVector<QPair<double, Direction>> sides = {
+        {tileLength - v, Direction::NORTH},
+        {tileLength - u, Direction::EAST},
+        {v, Direction::SOUTH},
+        {u, Direction::WEST},
+    };
+    emit wallClicked(x, y, std::min_element(sides.begin(), sides.end())->second);
+}
+
 void Map::initPolygonProgram() {
 
     m_polygonProgram.addShaderFromSourceCode(
         QOpenGLShader::Vertex,
         R"(
             uniform mat4 transformationMatrix;
+            uniform mat4 modelMatrix;
+            uniform float alphaScale;
             attribute vec2 coordinate;
             attribute vec4 inColor;
             varying vec4 outColor;
             void main(void) {
-                gl_Position = transformationMatrix * vec4(coordinate, 0.0, 1.0);
-                outColor = inColor;
+                gl_Position = transformationMatrix * modelMatrix * vec4(coordinate, 0.0, 1.0);
+                outColor = vec4(inColor.rgb, alphaScale * inColor.a);
             }
         )"
     );
@@ -223,12 +444,44 @@ void Map::initPolygonProgram() {
     m_polygonProgram.link();
     m_polygonProgram.bind();
 
-    m_polygonVAO.create();
-    m_polygonVAO.bind();
+    initPolygonVertexArrayObject(
+        &m_polygonVAO,
+        &m_polygonVBO,
+        QOpenGLBuffer::DynamicDraw
+    );
+    initPolygonVertexArrayObject(
+        &m_mouseVAO,
+        &m_mouseVBO,
+        QOpenGLBuffer::StaticDraw
+    );
+    initPolygonVertexArrayObject(
+        &m_trailVAO,
+        &m_trailVBO,
+        QOpenGLBuffer::DynamicDraw
+    );
+    initPolygonVertexArrayObject(
+        &m_heatmapVAO,
+        &m_heatmapVBO,
+        QOpenGLBuffer::DynamicDraw
+    );
+
+    m_lowDetailIBO.create();
+    m_lowDetailIBO.setUsagePattern(QOpenGLBuffer::StaticDraw);
 
-    m_polygonVBO.create();
-    m_polygonVBO.bind();
-    m_polygonVBO.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    m_polygonProgram.release();
+}
+
+void Map::initPolygonVertexArrayObject(
+        QOpenGLVertexArrayObject* vao,
+        QOpenGLBuffer* vbo,
+        QOpenGLBuffer::UsagePattern usagePattern) {
+
+    vao->create();
+    vao->bind();
+
+    vbo->create();
+    vbo->bind();
+    vbo->setUsagePattern(usagePattern);
 
     m_polygonProgram.enableAttributeArray("coordinate");
     m_polygonProgram.setAttributeBuffer(
@@ -248,9 +501,8 @@ void Map::initPolygonProgram() {
         6 * sizeof(double) // stride (bytes between vertices)
     );
 
-    m_polygonVBO.release();
-    m_polygonVAO.release();
-    m_polygonProgram.release();
+    vbo->release();
+    vao->release();
 }
 
 void Map::initTextureProgram() {
@@ -323,26 +575,100 @@ void Map::initTextureProgram() {
     m_polygonProgram.release();
 }
 
-void Map::repopulateVertexBufferObjects(const QVector<TriangleGraphic>& mouseBuffer) {
+void Map::initTileImageProgram() {
+
+    // The fragment shader works out which tile, and which of the tile's 3x3
+    // texels, each fragment falls in; see TileImage (and TileImage::sample,
+    // which must be kept in sync with this)
+    m_tileImageProgram.addShaderFromSourceCode(
+        QOpenGLShader::Vertex,
+        R"(
+            uniform mat4 transformationMatrix;
+            attribute vec2 coordinate;
+            varying vec2 physicalCoordinate;
+            void main() {
+                gl_Position = transformationMatrix * vec4(coordinate, 0.0, 1.0);
+                physicalCoordinate = coordinate;
+            }
+        )"
+    );
+    m_tileImageProgram.addShaderFromSourceCode(
+        QOpenGLShader::Fragment,
+        R"(
+            uniform sampler2D tileImage;
+            uniform vec2 mazeSize;
+            uniform float tileLength;
+            uniform float halfWallWidth;
+            uniform vec3 fogColor;
+            varying vec2 physicalCoordinate;
+            void main() {
+                vec2 tile = clamp(
+                    floor(physicalCoordinate / tileLength),
+                    vec2(0.0),
+                    mazeSize - 1.0);
+                vec2 local = physicalCoordinate - tile * tileLength;
+                vec2 texel =
+                    step(halfWallWidth, local) +
+                    step(tileLength - halfWallWidth, local);
+                vec2 imageSize = 3.0 * mazeSize;
+                vec4 layer = texture2D(tileImage, (3.0 * tile + texel + 0.5) / imageSize);
+                vec4 base = texture2D(tileImage, (3.0 * tile + 1.5) / imageSize);
+                vec3 color = mix(base.rgb, layer.rgb, layer.a);
+                if (texel == vec2(1.0)) {
+                    color = base.rgb;
+                }
+                gl_FragColor = vec4(mix(color, fogColor, 1.0 - base.a), 1.0);
+            }
+        )"
+    );
+    m_tileImageProgram.link();
+    m_tileImageProgram.bind();
+
+    m_tileImageVAO.create();
+    m_tileImageVAO.bind();
+
+    m_tileImageVBO.create();
+    m_tileImageVBO.bind();
+    m_tileImageVBO.setUsagePattern(QOpenGLBuffer::StaticDraw);
+
+    m_tileImageProgram.enableAttributeArray("coordinate");
+    m_tileImageProgram.setAttributeBuffer(
+        "coordinate", // name
+        GL_DOUBLE, // type
+        0, // offset (bytes)
+        2, // tupleSize (number of elements in the attribute array)
+        2 * sizeof(double) // stride (bytes between vertices)
+    );
+
+    m_tileImageVBO.release();
+    m_tileImageVAO.release();
+    m_tileImageProgram.release();
+}
+
+void Map::repopulateVertexBufferObjects(const QVector<TriangleGraphic>& sensorViewBuffer) {
 
     // Overwrite the polygon vertex buffer object data
     m_polygonVBO.bind();
     m_polygonVBO.allocate(sizeof(TriangleGraphic) * (
         m_view->getGraphicCpuBuffer()->size() +
-        mouseBuffer.size()
+        sensorViewBuffer.size()
     ));
+    m_uploadBytes += sizeof(TriangleGraphic) * (
+        m_view->getGraphicCpuBuffer()->size() +
+        sensorViewBuffer.size()
+    );
     // Write the maze
     m_polygonVBO.write(
         0,
-        &(m_view->getGraphicCpuBuffer()->front()),
+        m_view->getGraphicCpuBuffer()->constData(),
         sizeof(TriangleGraphic) * m_view->getGraphicCpuBuffer()->size()
     );
-    // Write the mouse
-    if (!mouseBuffer.isEmpty()) {
+    // Write the sensor views
+    if (!sensorViewBuffer.isEmpty()) {
         m_polygonVBO.write(
             sizeof(TriangleGraphic) * m_view->getGraphicCpuBuffer()->size(),
-            &(mouseBuffer.front()),
-            sizeof(TriangleGraphic) * mouseBuffer.size()
+            sensorViewBuffer.constData(),
+            sizeof(TriangleGraphic) * sensorViewBuffer.size()
         );
     }
     m_polygonVBO.release();
@@ -350,10 +676,349 @@ void Map::repopulateVertexBufferObjects(const QVector<TriangleGraphic>& mouseBuf
     // Overwrite the texture vertex buffer object data
     m_textureVBO.bind();
     m_textureVBO.allocate(
-        &(m_view->getTextureCpuBuffer()->front()),
+        m_view->getTextureCpuBuffer()->constData(),
         sizeof(TriangleTexture) * m_view->getTextureCpuBuffer()->size()
     );
     m_textureVBO.release();
+    m_uploadBytes += sizeof(TriangleTexture) * m_view->getTextureCpuBuffer()->size();
+}
+
+void Map::populateMouseVertexBufferObject() {
+    m_mouseVBOIsStale = false;
+    m_mouseVBOTriangleCount = 0;
+    if (m_mouseGraphic == nullptr) {
+        return;
+    }
+    const QVector<TriangleGraphic>& buffer = m_mouseGraphic->getStaticBuffer();
+    m_mouseVBO.bind();
+    m_mouseVBO.allocate(
+        buffer.constData(),
+        sizeof(TriangleGraphic) * buffer.size()
+    );
+    m_mouseVBO.release();
+    m_mouseVBOTriangleCount = buffer.size();
+    m_uploadBytes += sizeof(TriangleGraphic) * buffer.size();
+}
+
+void Map::populateTrailVertexBufferObject() {
+
+    if (m_trailVBOIsStale) {
+        m_trailVBOIsStale = false;
+        m_trailVBOPoseCount = 0;
+        if (m_mouseTrail != nullptr) {
+            m_trailVBO.bind();
+            m_trailVBO.allocate(
+                sizeof(VertexGraphic) * (m_mouseTrail->getCapacity() + 1)
+            );
+            m_trailVBO.release();
+        }
+    }
+    if (m_mouseTrail == nullptr) {
+        return;
+    }
+
+    // Only upload the poses recorded since the last frame (or, if more than
+    // a full ring's worth were recorded, just the ones that are still kept)
+    qint64 first = std::max(m_trailVBOPoseCount, m_mouseTrail->getFirstIndex());
+    qint64 count = m_mouseTrail->getCount();
+    if (count <= first) {
+        return;
+    }
+    RGB rgb = COLOR_TO_RGB().value(Color::ORANGE);
+    int capacity = m_mouseTrail->getCapacity();
+    m_trailVBO.bind();
+    while (first < count) {
+        // Write the contiguous run up to the end of the ring
+        int slot = first % capacity;
+        int runLength = std::min(count - first, static_cast<qint64>(capacity - slot));
+        QVector<VertexGraphic> vertices;
+        vertices.reserve(runLength);
+        for (int i = 0; i < runLength; i += 1) {
+            const MouseTrail::Pose& pose = m_mouseTrail->getPose(first + i);
+            vertices.append(VertexGraphic{pose.x, pose.y, rgb, 1.0});
+        }
+        m_trailVBO.write(
+            sizeof(VertexGraphic) * slot,
+            vertices.constData(),
+            sizeof(VertexGraphic) * runLength
+        );
+        // Keep the extra vertex at the end in sync with the first one
+        if (slot == 0) {
+            m_trailVBO.write(
+                sizeof(VertexGraphic) * capacity,
+                vertices.constData(),
+                sizeof(VertexGraphic)
+            );
+        }
+        m_uploadBytes += sizeof(VertexGraphic) * runLength;
+        first += runLength;
+    }
+    m_trailVBO.release();
+    m_trailVBOPoseCount = count;
+}
+
+void Map::populateHeatmapVertexBufferObject() {
+
+    if (m_heatmapVBOIsStale || m_mouseTrail == nullptr) {
+        m_heatmapVBOIsStale = false;
+        m_heatmapVBOTileVersion = 0;
+        m_heatmapVBOCapacity = 0;
+        m_heatmapTriangles.clear();
+        m_heatmapSlots.clear();
+        if (m_mouseTrail != nullptr) {
+            m_heatmapSlots.fill(-1, m_maze->getWidth() * m_maze->getHeight());
+        }
+    }
+    if (m_mouseTrail == nullptr) {
+        return;
+    }
+    int tileVersion = m_mouseTrail->getTileVersion();
+    if (tileVersion == m_heatmapVBOTileVersion) {
+        return;
+    }
+
+    // The tiles whose dwell times have changed are the one that the mouse was
+    // in as of the last upload, and every one that it has entered since; if
+    // those entries are no longer kept, every visited tile is rewritten
+    const QVector<int>& timeline = m_mouseTrail->getTimeline();
+    QVector<int> changed;
+    int firstVersion = std::max(1, m_heatmapVBOTileVersion);
+    if (tileVersion - firstVersion < MouseTrail::ENTRY_CAPACITY) {
+        for (int version = firstVersion; version <= tileVersion; version += 1) {
+            changed.append(m_mouseTrail->getEnteredTile(version));
+        }
+    }
+    else {
+        changed = timeline;
+    }
+    m_heatmapVBOTileVersion = tileVersion;
+
+    // Newly visited tiles get the next squares
+    int oldTriangleCount = m_heatmapTriangles.size();
+    for (int i = oldTriangleCount / 2; i < timeline.size(); i += 1) {
+        m_heatmapSlots[timeline.at(i)] = i;
+    }
+    m_heatmapTriangles.resize(2 * timeline.size());
+
+    // Cover the floor of each changed tile, with an (unscaled) opacity
+    // proportional to the time spent in it
+    double halfWallWidth = 0.5 * P()->wallWidth();
+    double tileLength = P()->wallWidth() + P()->wallLength();
+    RGB rgb = COLOR_TO_RGB().value(Color::RED);
+    for (int index : changed) {
+        int x = index / m_maze->getHeight();
+        int y = index % m_maze->getHeight();
+        double alpha = 0.7 * m_mouseTrail->getDwellTime(x, y);
+        double left = x * tileLength + halfWallWidth;
+        double bottom = y * tileLength + halfWallWidth;
+        double right = left + P()->wallLength();
+        double top = bottom + P()->wallLength();
+        int slot = m_heatmapSlots.at(index);
+        m_heatmapTriangles[2 * slot] = TriangleGraphic{
+            {left, bottom, rgb, alpha},
+            {left, top, rgb, alpha},
+            {right, top, rgb, alpha},
+        };
+        m_heatmapTriangles[2 * slot + 1] = TriangleGraphic{
+            {left, bottom, rgb, alpha},
+            {right, top, rgb, alpha},
+            {right, bottom, rgb, alpha},
+        };
+    }
+
+    m_heatmapVBO.bind();
+    if (m_heatmapVBOCapacity < m_heatmapTriangles.size()) {
+        // Grow geometrically, so that the full uploads are rare
+        m_heatmapVBOCapacity = std::max(
+            2 * m_heatmapVBOCapacity,
+            static_cast<int>(m_heatmapTriangles.size()));
+        m_heatmapVBO.allocate(sizeof(TriangleGraphic) * m_heatmapVBOCapacity);
+        m_heatmapVBO.write(
+            0,
+            m_heatmapTriangles.constData(),
+            sizeof(TriangleGraphic) * m_heatmapTriangles.size()
+        );
+        m_uploadBytes += sizeof(TriangleGraphic) * m_heatmapTriangles.size();
+    }
+    else {
+        for (int index : changed) {
+            int slot = m_heatmapSlots.at(index);
+            m_heatmapVBO.write(
+                sizeof(TriangleGraphic) * 2 * slot,
+                &m_heatmapTriangles.at(2 * slot),
+                sizeof(TriangleGraphic) * 2
+            );
+            m_uploadBytes += sizeof(TriangleGraphic) * 2;
+        }
+    }
+    m_heatmapVBO.release();
+}
+
+void Map::populateTileImageTexture(const TileImage* tileImage) {
+
+    const QImage& image = tileImage->getImage();
+    const QVector<quint32>& rowVersions = tileImage->getRowVersions();
+
+    // A new tile image (e.g., a new maze, or a switch between the truth and
+    // the mouse's view) needs a new texture, and a new quad to draw it on
+    if (m_tileImageTextureSource != tileImage ||
+            m_tileImageTexture == nullptr ||
+            m_tileImageTexture->width() != image.width() ||
+            m_tileImageTexture->height() != image.height()) {
+
+        if (m_tileImageTexture == nullptr ||
+                m_tileImageTexture->width() != image.width() ||
+                m_tileImageTexture->height() != image.height()) {
+            delete m_tileImageTexture;
+            m_tileImageTexture = new QOpenGLTexture(QOpenGLTexture::Target2D);
+            m_tileImageTexture->setSize(image.width(), image.height());
+            m_tileImageTexture->setFormat(QOpenGLTexture::RGBA8_UNorm);
+            m_tileImageTexture->setMinificationFilter(QOpenGLTexture::Nearest);
+            m_tileImageTexture->setMagnificationFilter(QOpenGLTexture::Nearest);
+            m_tileImageTexture->setWrapMode(QOpenGLTexture::ClampToEdge);
+            m_tileImageTexture->allocateStorage();
+        }
+        m_tileImageTextureSource = tileImage;
+        m_tileImageTextureRowVersions = rowVersions;
+
+        // Upload the whole image
+        m_tileImageTexture->bind();
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            0,
+            0,
+            image.width(),
+            image.height(),
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            image.constBits());
+        m_tileImageTexture->release();
+        m_uploadBytes += image.bytesPerLine() * image.height();
+
+        // The quad spans the whole maze, including the outer walls
+        double halfWallWidth = 0.5 * P()->wallWidth();
+        double tileLength = P()->wallWidth() + P()->wallLength();
+        double left = -halfWallWidth;
+        double bottom = -halfWallWidth;
+        double right = tileImage->getMazeWidth() * tileLength + halfWallWidth;
+        double top = tileImage->getMazeHeight() * tileLength + halfWallWidth;
+        double quad[12] = {
+            left, bottom, left, top, right, top,
+            left, bottom, right, top, right, bottom,
+        };
+        m_tileImageVBO.bind();
+        m_tileImageVBO.allocate(quad, sizeof(quad));
+        m_tileImageVBO.release();
+        m_uploadBytes += sizeof(quad);
+    }
+
+    // Upload each run of consecutive tile rows that changed
+    m_tileImageTexture->bind();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    int y = 0;
+    while (y < rowVersions.size()) {
+        if (m_tileImageTextureRowVersions.at(y) == rowVersions.at(y)) {
+            y += 1;
+            continue;
+        }
+        int first = y;
+        while (y < rowVersions.size() &&
+                m_tileImageTextureRowVersions.at(y) != rowVersions.at(y)) {
+            m_tileImageTextureRowVersions[y] = rowVersions.at(y);
+            y += 1;
+        }
+        int firstRow = TileImage::TEXELS_PER_TILE * first;
+        int numRows = TileImage::TEXELS_PER_TILE * (y - first);
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            0,
+            firstRow,
+            image.width(),
+            numRows,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            image.constScanLine(firstRow));
+        m_uploadBytes += image.bytesPerLine() * numRows;
+    }
+    m_tileImageTexture->release();
+}
+
+void Map::drawTrail(
+        const Coordinate& currentMouseTranslation,
+        const Angle& currentMouseRotation) {
+
+    if (m_mouseTrail == nullptr) {
+        return;
+    }
+    qint64 first = m_mouseTrail->getFirstIndex();
+    qint64 count = m_mouseTrail->getCount();
+    if (count - first < 2) {
+        return;
+    }
+
+    // Draw the oldest poses up to the end of the ring (including the extra
+    // vertex, which connects it to the start of the ring), then the rest
+    QMatrix4x4 identityMatrix;
+    int capacity = m_mouseTrail->getCapacity();
+    int oldestSlot = first % capacity;
+    int newestSlot = (count - 1) % capacity;
+    QVector<QPair<int, int>> strips;
+    if (oldestSlot <= newestSlot) {
+        strips.append({oldestSlot, newestSlot - oldestSlot + 1});
+    }
+    else {
+        strips.append({oldestSlot, capacity - oldestSlot + 1});
+        strips.append({0, newestSlot + 1});
+    }
+    for (const QPair<int, int>& strip : strips) {
+        drawMap(
+            m_layoutType,
+            currentMouseTranslation,
+            currentMouseRotation,
+            &m_polygonProgram,
+            &m_trailVAO,
+            GL_LINE_STRIP,
+            identityMatrix,
+            strip.first,
+            strip.second,
+            0
+        );
+    }
+}
+
+void Map::populateLowDetailIndexBuffer(int tileCount) {
+
+    // Everything but the corners, which are too small to see at low detail
+    static const int trianglesPerTile = BufferInterface::TRIANGLES_PER_TILE;
+    static const int cornersBegin = BufferInterface::TILE_CORNER_TRIANGLES_BEGIN;
+    static const int cornersEnd = BufferInterface::TILE_FOG_TRIANGLES_BEGIN;
+
+    QVector<GLuint> indices;
+    indices.reserve(3 * (trianglesPerTile - (cornersEnd - cornersBegin)) * tileCount);
+    for (int tile = 0; tile < tileCount; tile += 1) {
+        for (int triangle = 0; triangle < trianglesPerTile; triangle += 1) {
+            if (cornersBegin <= triangle && triangle < cornersEnd) {
+                continue;
+            }
+            GLuint first = 3 * (trianglesPerTile * tile + triangle);
+            indices.append(first);
+            indices.append(first + 1);
+            indices.append(first + 2);
+        }
+    }
+
+    m_lowDetailIBO.bind();
+    m_lowDetailIBO.allocate(
+        indices.constData(),
+        sizeof(GLuint) * indices.size()
+    );
+    m_lowDetailIBO.release();
+    m_uploadBytes += sizeof(GLuint) * indices.size();
+    m_lowDetailIBOTileCount = tileCount;
+    m_lowDetailIBOIndexCount = indices.size();
 }
 
 void Map::drawMap(
@@ -362,8 +1027,11 @@ void Map::drawMap(
         const Angle& currentMouseRotation,
         QOpenGLShaderProgram* program,
         QOpenGLVertexArrayObject* vao,
+        GLenum mode,
+        const QMatrix4x4& modelMatrix,
         int vboStartingIndex,
-        int count) {
+        int count,
+        int trianglesPerTile) {
 
     // Get the physical size of the maze (in meters)
     double physicalMazeWidth = P()->wallWidth() + m_maze->getWidth() * (P()->wallWidth() + P()->wallLength());
@@ -375,12 +1043,47 @@ void Map::drawMap(
     program->bind();
     vao->bind();
 
+    // If it's the polygon program, set the pose of the geometry, and scale
+    // the heatmap's alphas by the longest dwell time
+    if (program == &m_polygonProgram) {
+        GLfloat alphaScale = 1.0;
+        if (vao == &m_heatmapVAO) {
+            double maxDwellTime = m_mouseTrail->getMaxDwellTime();
+            alphaScale = 0.0 < maxDwellTime ? 1.0 / maxDwellTime : 0.0;
+        }
+        program->setUniformValue("modelMatrix", modelMatrix);
+        program->setUniformValue("alphaScale", alphaScale);
+    }
+
     // If it's the texture program, bind the texture and set the uniform
     if (program == &m_textureProgram) {
         glActiveTexture(GL_TEXTURE0);
         m_textureAtlas->bind();
         program->setUniformValue("texture", 0);
     }
+
+    // Likewise for the tile image program, which also needs the tile layout
+    if (program == &m_tileImageProgram) {
+        RGB fogColor = m_view->getTileImage()->getFogColor();
+        glActiveTexture(GL_TEXTURE0);
+        m_tileImageTexture->bind();
+        program->setUniformValue("tileImage", 0);
+        program->setUniformValue(
+            "mazeSize",
+            static_cast<GLfloat>(m_maze->getWidth()),
+            static_cast<GLfloat>(m_maze->getHeight()));
+        program->setUniformValue(
+            "tileLength",
+            static_cast<GLfloat>(P()->wallWidth() + P()->wallLength()));
+        program->setUniformValue(
+            "halfWallWidth",
+            static_cast<GLfloat>(0.5 * P()->wallWidth()));
+        program->setUniformValue(
+            "fogColor",
+            static_cast<GLfloat>(fogColor.r),
+            static_cast<GLfloat>(fogColor.g),
+            static_cast<GLfloat>(fogColor.b));
+    }
     
     // Render the full map
     if (type == LayoutType::FULL || m_mouseGraphic == nullptr) {
@@ -403,9 +1106,24 @@ void Map::drawMap(
             matrix.at(12), matrix.at(13), matrix.at(14), matrix.at(15)
         );
 
+        // When the tiles are only a few pixels wide, the text is unreadable
+        // and the corners are barely visible, so we skip them
+        double pixelsPerTile = (P()->wallWidth() + P()->wallLength()) * std::min(
+            fullMapSize.first / physicalMazeWidth,
+            fullMapSize.second / physicalMazeHeight);
+        bool lowDetail =
+            0 < trianglesPerTile &&
+            pixelsPerTile < LOW_DETAIL_PIXELS_PER_TILE;
+
         glScissor(fullMapPosition.first, fullMapPosition.second, fullMapSize.first, fullMapSize.second);
         program->setUniformValue("transformationMatrix", transformationMatrix);
-        glDrawArrays(GL_TRIANGLES, vboStartingIndex, count);
+        if (!lowDetail) {
+            glDrawArrays(mode, vboStartingIndex, count);
+        }
+        else if (program == &m_polygonProgram) {
+            ASSERT_EQ(vboStartingIndex, 0);
+            drawLowDetailTiles(m_maze->getWidth() * m_maze->getHeight());
+        }
 
     }
 
@@ -437,16 +1155,119 @@ void Map::drawMap(
 
         glScissor(zoomedMapPosition.first, zoomedMapPosition.second, zoomedMapSize.first, zoomedMapSize.second);
         program->setUniformValue("transformationMatrix", transformationMatrix2);
-        glDrawArrays(GL_TRIANGLES, vboStartingIndex, count);
+        if (0 < trianglesPerTile) {
+            drawVisibleTiles(
+                matrix2,
+                zoomedMapPosition,
+                zoomedMapSize,
+                vboStartingIndex,
+                trianglesPerTile
+            );
+        }
+        else {
+            glDrawArrays(mode, vboStartingIndex, count);
+        }
     }
 
     // If it's the texture program, we should additionally unbind the texture
     if (program == &m_textureProgram) {
         m_textureAtlas->release();
     }
+    if (program == &m_tileImageProgram) {
+        m_tileImageTexture->release();
+    }
 
     // Stop using the program and vertex array object
     vao->release();
 }
 
+void Map::drawVisibleTiles(
+        const QVector<float>& transformationMatrix,
+        QPair<int, int> mapPosition,
+        QPair<int, int> mapSize,
+        int vboStartingIndex,
+        int trianglesPerTile) {
+
+    QPair<QPair<double, double>, QPair<double, double>> region =
+        TransformationMatrix::getVisiblePhysicalRegion(
+            transformationMatrix,
+            mapPosition,
+            mapSize,
+            {m_windowWidth, m_windowHeight}
+        );
+
+    // Tile (x, y) starts at (x, y) * tileLength, give or take half a wall
+    // width; we pad by a tile to account for the walls and corners
+    double tileLength = P()->wallWidth() + P()->wallLength();
+    int minX = std::max(0, static_cast<int>(std::floor(region.first.first / tileLength)) - 1);
+    int minY = std::max(0, static_cast<int>(std::floor(region.first.second / tileLength)) - 1);
+    int maxX = std::min(m_maze->getWidth() - 1, static_cast<int>(std::floor(region.second.first / tileLength)) + 1);
+    int maxY = std::min(m_maze->getHeight() - 1, static_cast<int>(std::floor(region.second.second / tileLength)) + 1);
+
+    // The tiles are column-major, so each visible column is one contiguous
+    // run of vertices. Runs are merged when they're adjacent (i.e., when the
+    // whole column is visible) so that we issue as few draws as possible.
+    int verticesPerTile = 3 * trianglesPerTile;
+    int runStart = 0;
+    int runCount = 0;
+    for (int x = minX; x <= maxX; x += 1) {
+        int start = vboStartingIndex + verticesPerTile * (m_maze->getHeight() * x + minY);
+        int count = verticesPerTile * (maxY - minY + 1);
+        if (0 < runCount && runStart + runCount == start) {
+            runCount += count;
+            continue;
+        }
+        if (0 < runCount) {
+            glDrawArrays(GL_TRIANGLES, runStart, runCount);
+        }
+        runStart = start;
+        runCount = count;
+    }
+    if (0 < runCount) {
+        glDrawArrays(GL_TRIANGLES, runStart, runCount);
+    }
+}
+
+void Map::drawLowDetailTiles(int tileCount) {
+    if (m_lowDetailIBOTileCount != tileCount) {
+        populateLowDetailIndexBuffer(tileCount);
+    }
+    m_lowDetailIBO.bind();
+    glDrawElements(GL_TRIANGLES, m_lowDetailIBOIndexCount, GL_UNSIGNED_INT, nullptr);
+    m_lowDetailIBO.release();
+}
+
+void Map::drawHud() {
+
+    const QStringList& lines = m_hud.getLines();
+    if (lines.isEmpty()) {
+        return;
+    }
+
+    // Top-left corner, on a translucent background
+    static const int margin = 6;
+    QFontMetrics metrics(m_hudFont);
+    int width = 0;
+    for (const QString& line : lines) {
+        width = std::max(width, metrics.width(line));
+    }
+    int lineHeight = metrics.height();
+
+    QPainter painter(this);
+    painter.fillRect(
+        QRect(0, 0, width + 2 * margin, lines.size() * lineHeight + 2 * margin),
+        QColor(0, 0, 0, 160)
+    );
+    painter.setPen(Qt::white);
+    painter.setFont(m_hudFont);
+    for (int i = 0; i < lines.size(); i += 1) {
+        painter.drawText(
+            margin,
+            margin + i * lineHeight + metrics.ascent(),
+            lines.at(i)
+        );
+    }
+    painter.end();
+}
+
 } // namespace mms
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QFont>
+#include <QMouseEvent>
 #include <QOpenGLBuffer> 
 #include <QOpenGLDebugLogger>
 #include <QOpenGLFunctions>
@@ -9,10 +11,14 @@
 #include <QOpenGLWidget>
 #include <QVector>
 
+#include "Direction.h"
 #include "LayoutType.h"
 #include "Maze.h"
 #include "MazeView.h"
 #include "MouseGraphic.h"
+#include "MouseTrail.h"
+#include "PerformanceHud.h"
+#include "TileImage.h"
 #include "TriangleGraphic.h"
 
 namespace mms {
@@ -31,21 +37,34 @@ public:
     void setMaze(const Maze* maze);
     void setView(const MazeView* view);
     void setMouseGraphic(const MouseGraphic* mouseGraphic);
+    void setMouseTrail(const MouseTrail* mouseTrail);
 
     void setLayoutType(LayoutType layoutType);
     void setZoomedMapScale(double zoomedMapScale);
     void setRotateZoomedMap(bool rotateZoomedMap);
+    void setTrailVisible(bool trailVisible);
+    void setHeatmapVisible(bool heatmapVisible);
+    void setHudVisible(bool hudVisible);
+
+    // Running totals shown in the performance overlay
+    void setHudCounters(qint64 simSteps, qint64 algoCommands);
 
     // Retrieves OpenGL version info
     QVector<QString> getOpenGLVersionInfo();
 
     void shutdown();
 
+signals:
+
+    // Emitted when the full map is clicked, with the wall nearest the click
+    void wallClicked(int x, int y, Direction direction);
+
 protected:
 
     void initializeGL();
     void paintGL();
     void resizeGL(int width, int height);
+    void mousePressEvent(QMouseEvent* event);
 
 private:
 
@@ -57,6 +76,7 @@ private:
     const Maze* m_maze;
     const MazeView* m_view;
     const MouseGraphic* m_mouseGraphic;
+    const MouseTrail* m_mouseTrail;
 
     // The map's window size, in pixels
     int m_windowWidth;
@@ -66,12 +86,69 @@ private:
     LayoutType m_layoutType;
     double m_zoomedMapScale;
     bool m_rotateZoomedMap;
+    bool m_trailVisible;
+    bool m_heatmapVisible;
+    bool m_hudVisible;
+
+    // The performance overlay, along with its inputs
+    PerformanceHud m_hud;
+    QFont m_hudFont;
+    qint64 m_hudSimSteps;
+    qint64 m_hudAlgoCommands;
+    qint64 m_uploadBytes; // For the current frame
 
     // Polygon program variables
     QOpenGLShaderProgram m_polygonProgram;
     QOpenGLVertexArrayObject m_polygonVAO;
     QOpenGLBuffer m_polygonVBO;
 
+    // The rigid parts of the mouse, uploaded once per mouse graphic (in the
+    // mouse's local frame) and posed via the polygon program's model matrix
+    QOpenGLVertexArrayObject m_mouseVAO;
+    QOpenGLBuffer m_mouseVBO;
+    bool m_mouseVBOIsStale;
+    int m_mouseVBOTriangleCount;
+
+    // The trail mirrors the mouse trail's ring buffer, plus one extra vertex
+    // (a copy of the first) so that the wrapped-around strip stays connected;
+    // only the newly recorded poses are uploaded each frame
+    QOpenGLVertexArrayObject m_trailVAO;
+    QOpenGLBuffer m_trailVBO;
+    bool m_trailVBOIsStale;
+    qint64 m_trailVBOPoseCount;
+
+    // Tinted tile squares, one per visited tile, in the order in which the
+    // tiles were first visited (m_heatmapSlots maps a tile to its square). The
+    // squares' alphas are in proportion to the dwell times, and are scaled by
+    // the polygon program, so only the squares of the tiles entered since the
+    // last frame need to be uploaded; the cpu-side copy is only uploaded in
+    // full when the buffer has to grow.
+    QOpenGLVertexArrayObject m_heatmapVAO;
+    QOpenGLBuffer m_heatmapVBO;
+    bool m_heatmapVBOIsStale;
+    int m_heatmapVBOTileVersion;
+    int m_heatmapVBOCapacity; // In triangles
+    QVector<TriangleGraphic> m_heatmapTriangles;
+    QVector<int> m_heatmapSlots;
+
+    // Indices of every tile's triangles except for its corners, used to draw
+    // the full map in low detail (i.e., when the tiles are tiny)
+    QOpenGLBuffer m_lowDetailIBO;
+    int m_lowDetailIBOTileCount;
+    int m_lowDetailIBOIndexCount;
+
+    // Below this many pixels per tile, the full map is drawn in low detail
+    static constexpr double LOW_DETAIL_PIXELS_PER_TILE = 6.0;
+
+    // Tile image program variables, for mazes that are too large to draw
+    // polygon by polygon; only the tile rows that changed are re-uploaded
+    QOpenGLShaderProgram m_tileImageProgram;
+    QOpenGLVertexArrayObject m_tileImageVAO;
+    QOpenGLBuffer m_tileImageVBO;
+    QOpenGLTexture* m_tileImageTexture;
+    const TileImage* m_tileImageTextureSource;
+    QVector<quint32> m_tileImageTextureRowVersions;
+
     // Texture program variables
     QOpenGLTexture* m_textureAtlas;
     QOpenGLShaderProgram m_textureProgram;
@@ -80,19 +157,47 @@ private:
 
     // Initialize the graphics
     void initPolygonProgram();
+    void initPolygonVertexArrayObject(
+        QOpenGLVertexArrayObject* vao,
+        QOpenGLBuffer* vbo,
+        QOpenGLBuffer::UsagePattern usagePattern);
     void initTextureProgram();
+    void initTileImageProgram();
 
     // Drawing helper methods
     void repopulateVertexBufferObjects(
-        const QVector<TriangleGraphic>& mouseBuffer);
+        const QVector<TriangleGraphic>& sensorViewBuffer);
+    void populateMouseVertexBufferObject();
+    void populateLowDetailIndexBuffer(int tileCount);
+    void populateTrailVertexBufferObject();
+    void populateHeatmapVertexBufferObject();
+    void populateTileImageTexture(const TileImage* tileImage);
+    void drawTrail(
+        const Coordinate& currentMouseTranslation,
+        const Angle& currentMouseRotation);
+    void drawHud();
+
+    // If trianglesPerTile is positive, the range holds that many triangles
+    // for each tile, in the maze's (column-major) tile order, which allows
+    // the zoomed map to only draw the tiles that are visible
     void drawMap(
         LayoutType type,
         const Coordinate& currentMouseTranslation,
         const Angle& currentMouseRotation,
         QOpenGLShaderProgram* program,
         QOpenGLVertexArrayObject* vao,
+        GLenum mode,
+        const QMatrix4x4& modelMatrix,
+        int vboStartingIndex,
+        int count,
+        int trianglesPerTile);
+    void drawVisibleTiles(
+        const QVector<float>& transformationMatrix,
+        QPair<int, int> mapPosition,
+        QPair<int, int> mapSize,
         int vboStartingIndex,
-        int count);
+        int trianglesPerTile);
+    void drawLowDetailTiles(int tileCount);
 };
 
 } // namespace mms
@@ -2,7 +2,6 @@
 
 #include <QDebug>
 #include <QString>
-#include <QQueue>
 
 #include "Assert.h"
 #include "Logging.h"
@@ -16,9 +15,10 @@
 namespace mms {
 
 Maze* Maze::fromFile(const QString& path) {
-    BasicMaze basicMaze;
+    PackedMaze walls;
+    MazeMetadata metadata;
     try {
-        basicMaze = MazeFileUtilities::load(path);
+        walls = MazeFileUtilities::load(path, &metadata);
     }
     catch (const std::exception& e) {
         qWarning().nospace()
@@ -26,15 +26,16 @@ Maze* Maze::fromFile(const QString& path) {
             << QString(e.what()) << ".";
         return nullptr;
     }
-    return new Maze(basicMaze);
+    return new Maze(walls, metadata);
 }
 
 Maze* Maze::fromAlgo(const QByteArray& bytes) {
     // TODO: MACK - dedup with fromFile
     // TODO: MACK - rename this to fromBytes
-    BasicMaze basicMaze;
+    PackedMaze walls;
+    MazeMetadata metadata;
     try {
-        basicMaze = MazeFileUtilities::loadBytes(bytes);
+        walls = MazeFileUtilities::loadBytes(bytes, &metadata);
     }
     catch (const std::exception& e) {
         qWarning().nospace()
@@ -42,13 +43,21 @@ Maze* Maze::fromAlgo(const QByteArray& bytes) {
             << QString(e.what()) << ".";
         return nullptr;
     }
-    return new Maze(basicMaze);
+    return new Maze(walls, metadata);
 }
 
-Maze::Maze(BasicMaze basicMaze) {
+Maze::Maze(const PackedMaze& walls, const MazeMetadata& metadata) :
+        m_walls(walls),
+        m_symmetry(MazeSymmetry::IDENTITY, walls.getWidth(), walls.getHeight()) {
 
-    // Validate the maze
-    MazeValidity validity = MazeChecker::checkMaze(basicMaze);
+    // Validate the maze, unless the file already did
+    MazeValidity validity = (
+        metadata.isAvailable
+        ? metadata.validity
+        : 0 < m_walls.getWidth() && 0 < m_walls.getHeight()
+        ? MazeChecker::checkMaze(m_walls)
+        : MazeValidity::INVALID
+    );
 
     // Check to see if it's a valid maze
     m_isValidMaze = (
@@ -78,51 +87,133 @@ Maze::Maze(BasicMaze basicMaze) {
     }
     */
 
-    // TODO: MACK - make it possible to do rotate and mirroring on the fly
-    /*
-    // Mirror and rotate the maze
-    if (P()->mazeMirrored()) {
-        basicMaze = mirrorAcrossVertical(basicMaze);
-        qInfo().noquote().nospace()
-            << "Mirroring the maze across the vertical.";
+    // The goal is the center, whose distances the file may already have
+    m_goal = QBitArray(m_walls.getWidth() * m_walls.getHeight());
+    for (const QPair<int, int>& position : MazeUtilities::getCenterPositions(
+            m_walls.getWidth(), m_walls.getHeight())) {
+        m_goal.setBit(position.first * m_walls.getHeight() + position.second);
     }
-    for (int i = 0; i < P()->mazeRotations(); i += 1) {
-        basicMaze = rotateCounterClockwise(basicMaze);
-        qInfo().noquote().nospace()
-            << "Rotating the maze counter-clockwise (" << i + 1 << ").";
+    m_distances = (
+        metadata.isAvailable
+        ? metadata.distances
+        : MazeUtilities::getDistancesToCenter(m_walls)
+    );
+}
+
+Maze* Maze::withSymmetry(MazeSymmetry symmetry) const {
+    Maze* view = new Maze(*this);
+    view->m_symmetry = MazeSymmetryMap(
+        symmetry,
+        m_walls.getWidth(),
+        m_walls.getHeight());
+    if (m_isValidMaze) {
+        MazeValidity validity = MazeChecker::checkSymmetry(
+            m_walls,
+            view->m_symmetry,
+            m_isOfficialMaze ? MazeValidity::OFFICIAL : MazeValidity::EXPLORABLE);
+        view->m_isOfficialMaze = validity == MazeValidity::OFFICIAL;
+    }
+    return view;
+}
+
+Maze* Maze::withGoal(const QVector<QPair<int, int>>& goal) const {
+    Maze* maze = new Maze(*this);
+    QVector<QPair<int, int>> positions;
+    for (const QPair<int, int>& position : goal) {
+        if (m_walls.withinMaze(position.first, position.second)) {
+            positions.append(position);
+        }
+        else {
+            qWarning().noquote().nospace()
+                << "The goal tile (" << position.first << ", "
+                << position.second << ") is outside of the maze.";
+        }
     }
-    */
+    if (positions.isEmpty()) {
+        positions = MazeUtilities::getCenterPositions(
+            m_walls.getWidth(),
+            m_walls.getHeight());
+    }
+    maze->m_goal.fill(false);
+    for (const QPair<int, int>& position : positions) {
+        maze->m_goal.setBit(position.first * m_walls.getHeight() + position.second);
+    }
+    maze->m_distances = MazeUtilities::getDistancesToGoal(m_walls, positions);
+    return maze;
+}
 
-    // Load the maze given by the maze generation algorithm
-    m_maze = initializeFromBasicMaze(basicMaze);
+MazeSymmetry Maze::getSymmetry() const {
+    return m_symmetry.getSymmetry();
 }
 
 int Maze::getWidth() const {
-    return m_maze.size();
+    return m_symmetry.getWidth();
 }
 
 int Maze::getHeight() const {
-    return (0 < m_maze.size() ? m_maze.at(0).size() : 0);
+    return m_symmetry.getHeight();
 }
 
 bool Maze::withinMaze(int x, int y) const {
     return 0 <= x && x < getWidth() && 0 <= y && y < getHeight();
 }
 
-const Tile* Maze::getTile(int x, int y) const {
+Tile Maze::getTile(int x, int y) const {
+    Tile tile;
+    tile.setPos(x, y);
+    tile.setMazeSize(getWidth(), getHeight());
+    tile.setDistance(getDistance(x, y));
+    return tile;
+}
+
+int Maze::getDistance(int x, int y) const {
     ASSERT_TR(withinMaze(x, y));
-    return &m_maze.at(x).at(y);
+    return m_distances.at(
+        m_symmetry.toSourceX(x, y) * m_walls.getHeight() +
+        m_symmetry.toSourceY(x, y));
 }
 
-int Maze::getMaximumDistance() const {
-    int max = 0;
+const PackedMaze& Maze::getWalls() const {
+    return m_walls;
+}
+
+PackedMaze Maze::getOrientedWalls() const {
+    if (getSymmetry() == MazeSymmetry::IDENTITY) {
+        return m_walls;
+    }
+    // Every wall is the north or east wall of some tile, save for those on
+    // the south and west edges
+    PackedMaze walls(getWidth(), getHeight());
     for (int x = 0; x < getWidth(); x += 1) {
         for (int y = 0; y < getHeight(); y += 1) {
-            if (max < getTile(x, y)->getDistance()) {
-                max = getTile(x, y)->getDistance();
+            for (Direction direction : DIRECTIONS()) {
+                if ((direction == Direction::SOUTH && y != 0) ||
+                        (direction == Direction::WEST && x != 0)) {
+                    continue;
+                }
+                walls.setWall(x, y, direction, isWall(x, y, direction));
             }
         }
     }
+    if (!m_walls.hasConsistentWalls()) {
+        walls = PackedMaze::fromWords(
+            walls.getWidth(),
+            walls.getHeight(),
+            false,
+            walls.getHorizontalWords(),
+            walls.getVerticalWords());
+    }
+    return walls;
+}
+
+int Maze::getMaximumDistance() const {
+    // Distances are the same in every view
+    int max = 0;
+    for (int distance : m_distances) {
+        if (max < distance) {
+            max = distance;
+        }
+    }
     return max;
 }
 
@@ -134,156 +225,27 @@ bool Maze::isOfficialMaze() const {
     return m_isOfficialMaze;
 }
 
-bool Maze::isCenterTile(int x, int y) const {
-    const auto centerPositions = 
-        MazeUtilities::getCenterPositions(getWidth(), getHeight());
-    return centerPositions.contains({x, y});
+QVector<QPair<int, int>> Maze::getGoalPositions() const {
+    QVector<QPair<int, int>> positions;
+    for (int x = 0; x < getWidth(); x += 1) {
+        for (int y = 0; y < getHeight(); y += 1) {
+            if (isGoalTile(x, y)) {
+                positions.append({x, y});
+            }
+        }
+    }
+    return positions;
 }
 
 Direction Maze::getOptimalStartingDirection() const {
     if (getHeight() == 0) {
         return Direction::NORTH;
     }
-    if (getTile(0, 0)->isWall(Direction::NORTH) &&
-        !getTile(0, 0)->isWall(Direction::EAST)) {
+    if (isWall(0, 0, Direction::NORTH) &&
+        !isWall(0, 0, Direction::EAST)) {
         return Direction::EAST;
     }
     return Direction::NORTH;
 }
 
-QVector<QVector<Tile>> Maze::initializeFromBasicMaze(const BasicMaze& basicMaze) {
-    // TODO: MACK - assert valid here
-    QVector<QVector<Tile>> maze;
-    for (int x = 0; x < basicMaze.size(); x += 1) {
-        QVector<Tile> column;
-        for (int y = 0; y < basicMaze.at(x).size(); y += 1) {
-            Tile tile;
-            tile.setPos(x, y);
-            for (Direction direction : DIRECTIONS()) {
-                tile.setWall(direction, basicMaze.at(x).at(y).value(direction));
-            }
-            tile.initPolygons(basicMaze.size(), basicMaze.at(x).size());
-            column.push_back(tile);
-        }
-        maze.push_back(column);
-    }
-    maze = setTileDistances(maze);
-    return maze;
-}
-
-BasicMaze Maze::mirrorAcrossVertical(const BasicMaze& basicMaze) {
-    static QMap<Direction, Direction> verticalOpposites {
-        {Direction::NORTH, Direction::NORTH},
-        {Direction::EAST, Direction::WEST},
-        {Direction::SOUTH, Direction::SOUTH},
-        {Direction::WEST, Direction::EAST},
-    };
-    // TODO: MACK - test this
-    BasicMaze mirrored;
-    for (int x = 0; x < basicMaze.size(); x += 1) {
-        QVector<BasicTile> column;
-        for (int y = 0; y < basicMaze.at(x).size(); y += 1) {
-            BasicTile tile;
-            for (Direction direction : DIRECTIONS()) {
-                tile.insert(
-                    direction,
-                    basicMaze
-                        .at(basicMaze.size() - 1 - x)
-                        .at(y)
-                        .value(verticalOpposites.value(direction))
-                );
-            }
-            column.push_back(tile);
-        }
-        mirrored.push_back(column);
-    }
-    return mirrored; 
-}
-
-BasicMaze Maze::rotateCounterClockwise(const BasicMaze& basicMaze) {
-    BasicMaze rotated;
-    for (int x = 0; x < basicMaze.size(); x += 1) {
-        QVector<BasicTile> row;
-        for (int y = basicMaze.at(x).size() - 1; y >= 0; y -= 1) {
-            BasicTile tile;
-            int rotatedTileX = basicMaze.at(x).size() - 1 - y;
-            tile.insert(Direction::NORTH, basicMaze.at(x).at(y).value(Direction::EAST));
-            tile.insert(Direction::EAST, basicMaze.at(x).at(y).value(Direction::SOUTH));
-            tile.insert(Direction::SOUTH, basicMaze.at(x).at(y).value(Direction::WEST));
-            tile.insert(Direction::WEST, basicMaze.at(x).at(y).value(Direction::NORTH));
-            if (rotated.size() <= rotatedTileX) {
-                rotated.push_back({tile});
-            }
-            else {
-                rotated[rotatedTileX].push_back(tile);
-            }
-        }
-    }
-    return rotated;
-}
-
-QVector<QVector<Tile>> Maze::setTileDistances(QVector<QVector<Tile>> maze) {
-
-    // TODO: MACK - dedup some of this with hasNoInaccessibleLocations
-
-    // The maze is guarenteed to be nonempty and rectangular
-    int width = maze.size();
-    int height = maze.at(0).size();
-
-    // Helper lambda for retrieving and adjacent tile if one exists, nullptr if not
-    // TODO: MACK - this should be in maze utilities too
-    auto getNeighbor = [&maze, &width, &height](int x, int y, Direction direction) {
-        switch (direction) {
-            case Direction::NORTH:
-                return (y < height - 1 ? &maze[x][y + 1] : nullptr);
-            case Direction::EAST:
-                return (x < width - 1 ? &maze[x + 1][y] : nullptr);
-            case Direction::SOUTH:
-                return (0 < y ? &maze[x][y - 1] : nullptr);
-            case Direction::WEST:
-                return (0 < x ? &maze[x - 1][y] : nullptr);
-        }
-    };
-
-    // Determine all of the center tiles
-    // TODO: MACK - use the maze checker function for this
-    QVector<Tile*> centerTiles;
-            centerTiles.push_back(&maze[(width - 1) / 2][(height - 1) / 2]);
-    if (width % 2 == 0) {
-            centerTiles.push_back(&maze[ width      / 2][(height - 1) / 2]);
-        if (height % 2 == 0) {
-            centerTiles.push_back(&maze[(width - 1) / 2][ height      / 2]);
-            centerTiles.push_back(&maze[ width      / 2][ height      / 2]);
-        }
-    }
-    else if (height % 2 == 0) {
-            centerTiles.push_back(&maze[(width - 1) / 2][ height      / 2]);
-    }
-
-    // The queue for the BFS
-    QQueue<Tile*> discovered;
-
-    // Set the distances of the center tiles and push them to the queue
-    for (Tile* tile : centerTiles) {
-        tile->setDistance(0); 
-        discovered.enqueue(tile);
-    }
-
-    // Now do a BFS
-    while (!discovered.empty()){
-        Tile* tile = discovered.dequeue();
-        for (Direction direction : DIRECTIONS()) {
-            if (!tile->isWall(direction)) {
-                Tile* neighbor = getNeighbor(tile->getX(), tile->getY(), direction);
-                if (neighbor != nullptr && neighbor->getDistance() == -1) {
-                    neighbor->setDistance(tile->getDistance() + 1);
-                    discovered.enqueue(neighbor);
-                }
-            }
-        }
-    }
-
-    return maze;
-}
-
 } // namespace mms
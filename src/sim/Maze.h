@@ -1,10 +1,15 @@
 #pragma once
 
+#include <QBitArray>
 #include <QByteArray>
+#include <QPair>
 #include <QVector>
 
 #include "BasicMaze.h"
 #include "Direction.h"
+#include "MazeFileUtilities.h"
+#include "MazeSymmetry.h"
+#include "PackedMaze.h"
 #include "Tile.h"
 
 namespace mms {
@@ -15,40 +20,84 @@ public:
 
     static Maze* fromFile(const QString& path);
     static Maze* fromAlgo(const QByteArray& bytes);
-    
+
+    // A view of the same maze, turned over by the given symmetry (relative
+    // to the walls as stored, not to this view). The walls and distances are
+    // shared rather than copied, and only the validity rules that depend on
+    // where the start is are checked again.
+    Maze* withSymmetry(MazeSymmetry symmetry) const;
+    MazeSymmetry getSymmetry() const;
+
+    // A copy of the maze whose goal is the given tiles, as stored (so that
+    // the goal turns over with the maze in every view), rather than the
+    // center tiles. Tiles outside of the maze are dropped, and the goal is
+    // the center again if none are left.
+    Maze* withGoal(const QVector<QPair<int, int>>& goal) const;
+
+    // The size of the view
     int getWidth() const;
     int getHeight() const;
     bool withinMaze(int x, int y) const;
-    const Tile* getTile(int x, int y) const;
+    Tile getTile(int x, int y) const;
+    int getDistance(int x, int y) const;
+
+    // Shift-and-mask lookup into the packed wall store, through the symmetry
+    inline bool isWall(int x, int y, Direction direction) const {
+        return m_walls.isWall(
+            m_symmetry.toSourceX(x, y),
+            m_symmetry.toSourceY(x, y),
+            m_symmetry.toSource(direction));
+    }
+
+    // The walls as stored, i.e., before the symmetry is applied
+    const PackedMaze& getWalls() const;
+
+    // The walls as seen in the view; these are copied unless the symmetry is
+    // the identity, so they're only meant for whole-maze analysis
+    PackedMaze getOrientedWalls() const;
 
     int getMaximumDistance() const;
     bool isValidMaze() const;
     bool isOfficialMaze() const;
-    bool isCenterTile(int x, int y) const;
+
+    // The goal tiles in the view, and a lookup into the goal's bitmap
+    QVector<QPair<int, int>> getGoalPositions() const;
+    inline bool isGoalTile(int x, int y) const {
+        return m_goal.testBit(
+            m_symmetry.toSourceX(x, y) * m_walls.getHeight() +
+            m_symmetry.toSourceY(x, y));
+    }
+
     Direction getOptimalStartingDirection() const;
 
 private:
 
+    // The editor is the only client that changes a maze after construction;
+    // it keeps the walls, distances, and validity below up to date
+    friend class MazeEditor;
+
     // Private constructor forces clients to construct
     // a maze using one of the public static methods
-    explicit Maze(BasicMaze basicMaze);
+    // The metadata, if available, stands in for validation and the
+    // distance computation
+    Maze(const PackedMaze& walls, const MazeMetadata& metadata);
 
-    // Vector to hold all of the tiles
-    QVector<QVector<Tile>> m_maze;
+    // The canonical representation of the walls of the maze; both it and
+    // the distances are implicitly shared between symmetric views
+    PackedMaze m_walls;
 
-    // Cache results to these functions
-    bool m_isValidMaze;
-    bool m_isOfficialMaze;
+    // The goal tiles, and the distance of each tile to the nearest of them,
+    // as stored, i.e., indexed by x * height + y before the symmetry is
+    // applied; both are computed once, whenever the goal changes
+    QBitArray m_goal;
+    QVector<int> m_distances;
 
-    // Initializes all of the tiles of the basic maze
-    static QVector<QVector<Tile>> initializeFromBasicMaze(const BasicMaze& basicMaze);
+    // Maps positions and directions in the view to those stored above
+    MazeSymmetryMap m_symmetry;
 
-    // Basic maze geometric transformations
-    static BasicMaze mirrorAcrossVertical(const BasicMaze& basicMaze);
-    static BasicMaze rotateCounterClockwise(const BasicMaze& basicMaze);
-
-    // (Re)set the distance values for the tiles in maze that are reachable from the center
-    static QVector<QVector<Tile>> setTileDistances(QVector<QVector<Tile>> maze);
+    // Cache results to these functions, for the view
+    bool m_isValidMaze;
+    bool m_isOfficialMaze;
 };
 
 } // namespace mms
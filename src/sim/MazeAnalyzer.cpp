@@ -0,0 +1,370 @@
+#include "MazeAnalyzer.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QPair>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QVariant>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+#include "FunctionTask.h"
+#include "MazeConverter.h"
+#include "MazeFileType.h"
+#include "MazeFileUtilities.h"
+#include "MazeUtilities.h"
+#include "TileBitset.h"
+
+namespace mms {
+
+MazeMetrics MazeAnalyzer::analyze(const PackedMaze& maze, const MazeRunProfile& profile) {
+
+    MazeMetrics metrics;
+    metrics.width = maze.getWidth();
+    metrics.height = maze.getHeight();
+    metrics.validity = MazeChecker::checkMaze(maze);
+    if (metrics.width == 0 || metrics.height == 0) {
+        return metrics;
+    }
+    metrics.canonicalHash = maze.getCanonicalHash();
+    QVector<quint8> openings = getOpenings(maze);
+
+    // Count the ways out of each reachable tile; every passage between two
+    // of them is counted once from each end
+    TileBitset start(metrics.width, metrics.height);
+    start.set(0, 0);
+    TileBitset reachable = TileBitset::flood(maze, start);
+    int openingCount = 0;
+    for (int x = 0; x < metrics.width; x += 1) {
+        for (int y = 0; y < metrics.height; y += 1) {
+            if (!reachable.test(x, y)) {
+                continue;
+            }
+            int ways = 0;
+            for (int i = 0; i < 4; i += 1) {
+                ways += (openings.at(x * metrics.height + y) >> i) & 1;
+            }
+            metrics.reachableTiles += 1;
+            openingCount += ways;
+            if (ways == 1 && (x != 0 || y != 0)) {
+                metrics.deadEnds += 1;
+            }
+            if (3 <= ways) {
+                metrics.junctions += 1;
+            }
+        }
+    }
+    metrics.branchingFactor =
+        static_cast<double>(openingCount) / metrics.reachableTiles;
+    metrics.loops = openingCount / 2 - metrics.reachableTiles + 1;
+
+    // The routes to the center
+    QVector<int> distancesToCenter = MazeUtilities::getDistancesToCenter(maze);
+    metrics.pathLength = distancesToCenter.at(0);
+    if (metrics.pathLength != -1) {
+        metrics.pathTurns = getPathTurns(maze, openings, distancesToCenter);
+        metrics.runSeconds = getRunSeconds(maze, openings, profile);
+    }
+
+    // Both wall followers
+    TileBitset rightHand = MazeChecker::getWallFollowerTiles(maze, false);
+    TileBitset leftHand = MazeChecker::getWallFollowerTiles(maze, true);
+    metrics.rightHandTiles = rightHand.count();
+    metrics.leftHandTiles = leftHand.count();
+    for (const auto& tile :
+            MazeUtilities::getCenterPositions(metrics.width, metrics.height)) {
+        metrics.rightHandSolves |= rightHand.test(tile.first, tile.second);
+        metrics.leftHandSolves |= leftHand.test(tile.first, tile.second);
+    }
+    return metrics;
+}
+
+int MazeAnalyzer::run(
+        const QString& directory,
+        const QString& reportPath,
+        const MazeRunProfile& profile) {
+
+    // Sorted, so that reports of the same directory can be diffed
+    QStringList paths;
+    if (!MazeConverter::findFiles(directory, MAZE_FILE_TYPE_TO_SUFFIX().values(), &paths)) {
+        return 1;
+    }
+    paths.sort();
+
+    // Analyze them all in parallel, each worker writing only its own slot
+    QElapsedTimer timer;
+    timer.start();
+    QVector<MazeMetrics> metrics(paths.size());
+    QVector<bool> loaded(paths.size(), false);
+    MazeMetrics* metricsData = metrics.data();
+    bool* loadedData = loaded.data();
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(QThread::idealThreadCount());
+    for (int i = 0; i < paths.size(); i += 1) {
+        threadPool.start(new FunctionTask([&, i]() {
+            try {
+                metricsData[i] = analyze(MazeFileUtilities::load(paths.at(i)), profile);
+                loadedData[i] = true;
+            }
+            catch (const std::exception& e) {
+                qWarning().noquote().nospace()
+                    << "Unable to load \"" << paths.at(i) << "\": "
+                    << QString(e.what()) << ".";
+            }
+        }));
+    }
+    threadPool.waitForDone();
+
+    QStringList analyzedPaths;
+    QVector<MazeMetrics> analyzed;
+    for (int i = 0; i < paths.size(); i += 1) {
+        if (loaded.at(i)) {
+            analyzedPaths.append(paths.at(i));
+            analyzed.append(metrics.at(i));
+        }
+    }
+    if (!writeReport(reportPath, analyzedPaths, analyzed)) {
+        return 1;
+    }
+
+    // Keep the summary off of stdout, where the report may be going
+    int failedCount = paths.size() - analyzed.size();
+    QTextStream(stderr)
+        << "Analyzed " << analyzed.size() << " of " << paths.size()
+        << " maze files in " << timer.elapsed() / 1000.0 << " s ("
+        << failedCount << " failed)\n";
+    return failedCount == 0 ? 0 : 1;
+}
+
+QVector<quint8> MazeAnalyzer::getOpenings(const PackedMaze& maze) {
+    int height = maze.getHeight();
+    QVector<quint8> openings(maze.getWidth() * height, 0);
+    for (int x = 0; x < maze.getWidth(); x += 1) {
+        for (int y = 0; y < height; y += 1) {
+            for (int i = 0; i < DIRECTIONS().size(); i += 1) {
+                Direction direction = DIRECTIONS().at(i);
+                QPair<int, int> next =
+                    MazeUtilities::positionAfterMovingForward({x, y}, direction);
+                if (!maze.isWall(x, y, direction) &&
+                        maze.withinMaze(next.first, next.second)) {
+                    openings[x * height + y] |= 1 << i;
+                }
+            }
+        }
+    }
+    return openings;
+}
+
+int MazeAnalyzer::getPathTurns(
+        const PackedMaze& maze,
+        const QVector<quint8>& openings,
+        const QVector<int>& distancesToCenter) {
+
+    int height = maze.getHeight();
+    int offsets[4] = {1, height, -1, -height};
+
+    // The tiles that can reach the center, nearest first, so that each one
+    // comes after every tile that a shortest route steps to from it
+    QVector<int> order;
+    for (int tile = 0; tile < distancesToCenter.size(); tile += 1) {
+        if (distancesToCenter.at(tile) != -1) {
+            order.append(tile);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int first, int second) {
+        return distancesToCenter.at(first) < distancesToCenter.at(second);
+    });
+
+    // The fewest turns from each tile to the center, for each heading that
+    // the mouse may have there, indexed by 4 * tile + heading
+    QVector<int> turns(4 * distancesToCenter.size(), 0);
+    for (int tile : order) {
+        int distance = distancesToCenter.at(tile);
+        if (distance == 0) {
+            continue;
+        }
+        for (int heading = 0; heading < 4; heading += 1) {
+            int fewest = std::numeric_limits<int>::max();
+            for (int direction = 0; direction < 4; direction += 1) {
+                int next = tile + offsets[direction];
+                if (!(openings.at(tile) & (1 << direction)) ||
+                        distancesToCenter.at(next) != distance - 1) {
+                    continue;
+                }
+                fewest = std::min(
+                    fewest,
+                    turns.at(4 * next + direction) + (direction == heading ? 0 : 1));
+            }
+            turns[4 * tile + heading] = fewest;
+        }
+    }
+
+    // The start, facing north
+    return turns.at(0);
+}
+
+double MazeAnalyzer::getRunSeconds(
+        const PackedMaze& maze,
+        const QVector<quint8>& openings,
+        const MazeRunProfile& profile) {
+
+    int height = maze.getHeight();
+    int offsets[4] = {1, height, -1, -height};
+    QVector<bool> isCenter(openings.size(), false);
+    for (const auto& tile :
+            MazeUtilities::getCenterPositions(maze.getWidth(), height)) {
+        isCenter[tile.first * height + tile.second] = true;
+    }
+
+    // Dijkstra's algorithm over states 4 * tile + heading, starting from
+    // the start, facing north
+    typedef QPair<double, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    QVector<double> times(4 * openings.size(), std::numeric_limits<double>::infinity());
+    auto relax = [&](int state, double time) {
+        if (time < times.at(state)) {
+            times[state] = time;
+            queue.push({time, state});
+        }
+    };
+    relax(0, 0.0);
+    while (!queue.empty()) {
+        Entry entry = queue.top();
+        queue.pop();
+        if (times.at(entry.second) < entry.first) {
+            continue;
+        }
+        int tile = entry.second / 4;
+        int heading = entry.second % 4;
+        if (isCenter.at(tile)) {
+            return entry.first;
+        }
+        relax(4 * tile + (heading + 1) % 4, entry.first + profile.quarterTurnSeconds);
+        relax(4 * tile + (heading + 3) % 4, entry.first + profile.quarterTurnSeconds);
+        int next = tile;
+        for (int length = 1; openings.at(next) & (1 << heading); length += 1) {
+            next += offsets[heading];
+            relax(
+                4 * next + heading,
+                entry.first + getStraightSeconds(length * profile.tileLength, profile));
+        }
+    }
+    return -1.0;
+}
+
+double MazeAnalyzer::getStraightSeconds(double meters, const MazeRunProfile& profile) {
+    // Too short to reach top speed, the profile is a triangle
+    double rampMeters = profile.maxSpeed * profile.maxSpeed / profile.acceleration;
+    if (meters < rampMeters) {
+        return 2.0 * std::sqrt(meters / profile.acceleration);
+    }
+    return meters / profile.maxSpeed + profile.maxSpeed / profile.acceleration;
+}
+
+bool MazeAnalyzer::writeReport(
+        const QString& reportPath,
+        const QStringList& paths,
+        const QVector<MazeMetrics>& metrics) {
+
+    static const QMap<MazeValidity, QString> validityToString = {
+        {MazeValidity::INVALID, "invalid"},
+        {MazeValidity::DRAWABLE, "drawable"},
+        {MazeValidity::EXPLORABLE, "explorable"},
+        {MazeValidity::OFFICIAL, "official"},
+    };
+    typedef std::function<QVariant(const MazeMetrics&)> Column;
+    static const QVector<QPair<QString, Column>> columns = {
+        {"width", [](const MazeMetrics& m) { return m.width; }},
+        {"height", [](const MazeMetrics& m) { return m.height; }},
+        {"validity", [](const MazeMetrics& m) {
+            return validityToString.value(m.validity);
+        }},
+        {"canonical_hash", [](const MazeMetrics& m) {
+            return QString("%1").arg(m.canonicalHash, 16, 16, QChar('0'));
+        }},
+        {"reachable_tiles", [](const MazeMetrics& m) { return m.reachableTiles; }},
+        {"path_length", [](const MazeMetrics& m) { return m.pathLength; }},
+        {"path_turns", [](const MazeMetrics& m) { return m.pathTurns; }},
+        {"dead_ends", [](const MazeMetrics& m) { return m.deadEnds; }},
+        {"junctions", [](const MazeMetrics& m) { return m.junctions; }},
+        {"branching_factor", [](const MazeMetrics& m) { return m.branchingFactor; }},
+        {"loops", [](const MazeMetrics& m) { return m.loops; }},
+        {"right_hand_solves", [](const MazeMetrics& m) { return m.rightHandSolves; }},
+        {"right_hand_tiles", [](const MazeMetrics& m) { return m.rightHandTiles; }},
+        {"left_hand_solves", [](const MazeMetrics& m) { return m.leftHandSolves; }},
+        {"left_hand_tiles", [](const MazeMetrics& m) { return m.leftHandTiles; }},
+        {"run_seconds", [](const MazeMetrics& m) { return m.runSeconds; }},
+    };
+
+    QFile file(reportPath);
+    bool isOpen = reportPath.isEmpty()
+        ? file.open(stdout, QIODevice::WriteOnly)
+        : file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    if (!isOpen) {
+        qWarning().noquote().nospace()
+            << "Unable to write the report to \"" << reportPath << "\": "
+            << file.errorString() << ".";
+        return false;
+    }
+
+    // Either an array per column, along with the order of the columns
+    // (which a JSON object doesn't keep), or a row per maze
+    if (reportPath.endsWith(".json", Qt::CaseInsensitive)) {
+        QJsonArray names = {"path"};
+        QJsonObject data;
+        data.insert("path", QJsonArray::fromStringList(paths));
+        for (const auto& column : columns) {
+            QJsonArray values;
+            for (const MazeMetrics& m : metrics) {
+                values.append(QJsonValue::fromVariant(column.second(m)));
+            }
+            names.append(column.first);
+            data.insert(column.first, values);
+        }
+        QJsonObject report;
+        report.insert("columns", names);
+        report.insert("rows", metrics.size());
+        report.insert("data", data);
+        file.write(QJsonDocument(report).toJson());
+    }
+    else {
+        QTextStream out(&file);
+        out << "path";
+        for (const auto& column : columns) {
+            out << "," << column.first;
+        }
+        out << "\n";
+        for (int i = 0; i < metrics.size(); i += 1) {
+            QString path = paths.at(i);
+            if (path.contains(',') || path.contains('"') || path.contains('\n')) {
+                path = "\"" + path.replace("\"", "\"\"") + "\"";
+            }
+            out << path;
+            for (const auto& column : columns) {
+                out << "," << column.second(metrics.at(i)).toString();
+            }
+            out << "\n";
+        }
+    }
+    if (file.error() != QFileDevice::NoError) {
+        qWarning().noquote().nospace()
+            << "Unable to write the report to \"" << reportPath << "\": "
+            << file.errorString() << ".";
+        return false;
+    }
+    return true;
+}
+
+} // namespace mms
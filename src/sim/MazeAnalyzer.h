@@ -0,0 +1,110 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "MazeChecker.h"
+#include "PackedMaze.h"
+
+namespace mms {
+
+// How a mouse is assumed to run, for MazeMetrics::runSeconds: it runs each
+// straight from rest to rest, accelerating and braking at a constant rate up
+// to its top speed (a trapezoidal speed profile), and turns in place between
+// straights
+struct MazeRunProfile {
+    double tileLength = 0.18;
+    double maxSpeed = 2.0;
+    double acceleration = 5.0;
+    double quarterTurnSeconds = 0.2;
+};
+
+// What the analyzer measures about a maze. Only the tiles that can be
+// reached from the start are counted, and the measures of the route to the
+// center are -1 if there isn't one.
+struct MazeMetrics {
+    int width = 0;
+    int height = 0;
+    MazeValidity validity = MazeValidity::INVALID;
+    quint64 canonicalHash = 0;
+    int reachableTiles = 0;
+
+    // The fewest moves from the start to the center, and the fewest changes
+    // of heading along a route of that length, starting out facing north
+    int pathLength = -1;
+    int pathTurns = -1;
+
+    // Tiles with one way out (other than the start), tiles with three or
+    // more, and the mean number of ways out of a tile
+    int deadEnds = 0;
+    int junctions = 0;
+    double branchingFactor = 0.0;
+
+    // The number of independent loops, i.e., the number of walls that could
+    // be added without making any tile unreachable
+    int loops = 0;
+
+    // Whether a wall follower with its right (or left) hand on the wall
+    // reaches the center, and how many tiles it visits
+    bool rightHandSolves = false;
+    bool leftHandSolves = false;
+    int rightHandTiles = 0;
+    int leftHandTiles = 0;
+
+    // The least time from the start to the center under the run profile,
+    // over every route (not just the shortest ones), in seconds
+    double runSeconds = -1.0;
+};
+
+// Measures the structure and difficulty of every maze file in a directory,
+// on all cores, to help pick mazes for a test suite, and writes a report
+// with one column per measure and one row per file.
+class MazeAnalyzer {
+
+public:
+
+    // This class is not constructible
+    MazeAnalyzer() = delete;
+
+    static MazeMetrics analyze(const PackedMaze& maze, const MazeRunProfile& profile);
+
+    // Analyzes every maze file in (or under) the directory and writes the
+    // report to the given path, as JSON (an array per column) if it ends in
+    // ".json" and as CSV otherwise, or as CSV to stdout if the path is
+    // empty; returns a process exit code
+    static int run(
+        const QString& directory,
+        const QString& reportPath,
+        const MazeRunProfile& profile);
+
+private:
+
+    // Bit i of a tile's openings is set if a mouse can move from it in
+    // direction DIRECTIONS().at(i) without leaving the maze
+    static QVector<quint8> getOpenings(const PackedMaze& maze);
+
+    // The fewest changes of heading over the shortest routes to the center
+    static int getPathTurns(
+        const PackedMaze& maze,
+        const QVector<quint8>& openings,
+        const QVector<int>& distancesToCenter);
+
+    // A shortest-time search over (tile, heading) states at rest, where a
+    // move is a straight run of any length or a quarter turn in place
+    static double getRunSeconds(
+        const PackedMaze& maze,
+        const QVector<quint8>& openings,
+        const MazeRunProfile& profile);
+
+    // The time to cover the distance from rest to rest
+    static double getStraightSeconds(double meters, const MazeRunProfile& profile);
+
+    // Writes the report; returns false (and warns) if it can't be written
+    static bool writeReport(
+        const QString& reportPath,
+        const QStringList& paths,
+        const QVector<MazeMetrics>& metrics);
+};
+
+} // namespace mms
@@ -0,0 +1,263 @@
+#include "MazeBenchmark.h"
+
+#include <QBitArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QPair>
+#include <QScopedPointer>
+#include <QTextStream>
+
+#include <functional>
+#include <random>
+
+#include "Frame.h"
+#include "FrameRasterizer.h"
+#include "Maze.h"
+#include "MazeChecker.h"
+#include "MazeFileType.h"
+#include "MazeFileUtilities.h"
+#include "MazeUtilities.h"
+#include "MazeView.h"
+#include "Param.h"
+
+namespace mms {
+
+int MazeBenchmark::run(const QVector<int>& sizes) {
+
+    QTextStream out(stdout);
+    bool roundTripsSucceeded = runFormats(sizes);
+    out << "\n";
+    out << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10\n")
+        .arg("size", 9)
+        .arg("load ms", 9)
+        .arg("mzb ms", 9)
+        .arg("check ms", 9)
+        .arg("view ms", 9)
+        .arg("frame ms", 9)
+        .arg("run ms", 9)
+        .arg("render", 7)
+        .arg("rss MB", 8)
+        .arg("peak MB", 8);
+    out.flush();
+
+    for (int size : sizes) {
+
+        QByteArray bytes =
+            MazeFileUtilities::saveBytes(generate(size, size), MazeFileType::MAP);
+        QElapsedTimer timer;
+
+        // Load, which includes validation and distance computation
+        timer.start();
+        QScopedPointer<Maze> maze(Maze::fromAlgo(bytes));
+        double loadMs = timer.nsecsElapsed() / 1e6;
+        bytes.clear();
+        if (maze.isNull() || !maze->isValidMaze()) {
+            out << "Failed to load the generated " << size << "x" << size << " maze\n";
+            return 1;
+        }
+
+        // Load from the binary format, which stores the validation and
+        // distance results
+        QByteArray mzbBytes =
+            MazeFileUtilities::saveBytes(maze->getWalls(), MazeFileType::MZB);
+        timer.restart();
+        delete Maze::fromAlgo(mzbBytes);
+        double mzbMs = timer.nsecsElapsed() / 1e6;
+        mzbBytes.clear();
+
+        // Validation on its own
+        timer.restart();
+        MazeChecker::checkMaze(maze->getWalls());
+        double checkMs = timer.nsecsElapsed() / 1e6;
+
+        // The truth view, as the window builds it
+        timer.restart();
+        MazeView truth(maze.data(), true, false, false, true, true);
+        double viewMs = timer.nsecsElapsed() / 1e6;
+
+        // A frame of the whole map, drawn on the CPU
+        timer.restart();
+        Frame frame;
+        frame.wallWidth = P()->wallWidth();
+        frame.physicalMazeSize = {
+            P()->wallWidth() + size * (P()->wallWidth() + P()->wallLength()),
+            P()->wallWidth() + size * (P()->wallWidth() + P()->wallLength()),
+        };
+        frame.graphicBuffer = *truth.getGraphicCpuBuffer();
+        frame.textureBuffer = *truth.getTextureCpuBuffer();
+        if (truth.getTileImage() != nullptr) {
+            frame.tileImage = *truth.getTileImage();
+        }
+        FrameRasterizer::rasterize(frame, {640, 640}, QImage());
+        double frameMs = timer.nsecsElapsed() / 1e6;
+
+        // A discrete run through the mouse's view: visit every tile depth
+        // first, revealing and declaring its walls like an exploring mouse
+        timer.restart();
+        MazeView view(maze.data(), false, true, true, true, false);
+        MazeGraphic* graphic = view.getMazeGraphic();
+        QBitArray traversed(size * size);
+        QVector<QPair<int, int>> stack {{0, 0}};
+        traversed.setBit(0);
+        while (!stack.isEmpty()) {
+            QPair<int, int> position = stack.takeLast();
+            graphic->setTileFogginess(position.first, position.second, false);
+            graphic->setTileColor(position.first, position.second, Color::DARK_GREEN);
+            for (Direction direction : DIRECTIONS()) {
+                bool isWall = maze->isWall(position.first, position.second, direction);
+                graphic->declareWall(position.first, position.second, direction, isWall);
+                if (isWall) {
+                    continue;
+                }
+                QPair<int, int> next =
+                    MazeUtilities::positionAfterMovingForward(position, direction);
+                int index = next.first * size + next.second;
+                if (!traversed.testBit(index)) {
+                    traversed.setBit(index);
+                    stack.append(next);
+                }
+            }
+        }
+        double runMs = timer.nsecsElapsed() / 1e6;
+
+        QPair<qint64, qint64> memory = getResidentKilobytes();
+        out << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10\n")
+            .arg(QString("%1x%1").arg(size), 9)
+            .arg(loadMs, 9, 'f', 1)
+            .arg(mzbMs, 9, 'f', 1)
+            .arg(checkMs, 9, 'f', 1)
+            .arg(viewMs, 9, 'f', 1)
+            .arg(frameMs, 9, 'f', 1)
+            .arg(runMs, 9, 'f', 1)
+            .arg(truth.getTileImage() != nullptr ? "image" : "poly", 7)
+            .arg(memory.first < 0 ? QString("n/a") : QString::number(memory.first / 1024.0, 'f', 1), 8)
+            .arg(memory.second < 0 ? QString("n/a") : QString::number(memory.second / 1024.0, 'f', 1), 8);
+        out.flush();
+    }
+
+    return roundTripsSucceeded ? 0 : 1;
+}
+
+bool MazeBenchmark::runFormats(const QVector<int>& sizes) {
+
+    QTextStream out(stdout);
+    out << QString("%1 %2 %3 %4 %5 %6\n")
+        .arg("format", 6)
+        .arg("size", 9)
+        .arg("bytes", 10)
+        .arg("write MB/s", 10)
+        .arg("read MB/s", 10)
+        .arg("round trip", 10);
+    out.flush();
+
+    // Repeat each measurement until it's long enough to be meaningful
+    auto throughput = [](int size, const std::function<void()>& function) {
+        QElapsedTimer timer;
+        timer.start();
+        qint64 iterations = 0;
+        do {
+            function();
+            iterations += 1;
+        } while (timer.nsecsElapsed() < 100000000);
+        return size * iterations / (timer.nsecsElapsed() / 1e9) / 1e6;
+    };
+
+    bool succeeded = true;
+    for (int size : sizes) {
+        PackedMaze maze = generate(size, size);
+        for (MazeFileType type : MAZE_FILE_TYPE_TO_STRING().keys()) {
+
+            // .MAZ files are always 16x16
+            if (type == MazeFileType::MAZ && size != 16) {
+                continue;
+            }
+
+            QByteArray bytes = MazeFileUtilities::saveBytes(maze, type);
+            bool roundTripped = (
+                MazeFileUtilities::detectType(bytes) == type &&
+                MazeFileUtilities::loadBytes(bytes) == maze
+            );
+            succeeded = succeeded && roundTripped;
+
+            double writeRate = throughput(bytes.size(), [&]() {
+                MazeFileUtilities::saveBytes(maze, type);
+            });
+            double readRate = throughput(bytes.size(), [&]() {
+                MazeFileUtilities::loadBytes(bytes);
+            });
+
+            out << QString("%1 %2 %3 %4 %5 %6\n")
+                .arg(MAZE_FILE_TYPE_TO_STRING().value(type), 6)
+                .arg(QString("%1x%1").arg(size), 9)
+                .arg(bytes.size(), 10)
+                .arg(writeRate, 10, 'f', 1)
+                .arg(readRate, 10, 'f', 1)
+                .arg(roundTripped ? "ok" : "FAILED", 10);
+            out.flush();
+        }
+    }
+    return succeeded;
+}
+
+PackedMaze MazeBenchmark::generate(int width, int height) {
+
+    PackedMaze maze(width, height);
+    for (int x = 0; x < width; x += 1) {
+        for (int y = 0; y < height; y += 1) {
+            for (Direction direction : DIRECTIONS()) {
+                maze.setWall(x, y, direction, true);
+            }
+        }
+    }
+
+    std::mt19937 generator(width * 7919 + height);
+    QBitArray visited(width * height);
+    QVector<QPair<int, int>> stack {{0, 0}};
+    visited.setBit(0);
+    while (!stack.isEmpty()) {
+        QPair<int, int> position = stack.last();
+        QVector<Direction> options;
+        for (Direction direction : DIRECTIONS()) {
+            QPair<int, int> next =
+                MazeUtilities::positionAfterMovingForward(position, direction);
+            if (maze.withinMaze(next.first, next.second) &&
+                    !visited.testBit(next.first * height + next.second)) {
+                options.append(direction);
+            }
+        }
+        if (options.isEmpty()) {
+            stack.removeLast();
+            continue;
+        }
+        Direction direction = options.at(generator() % options.size());
+        QPair<int, int> next =
+            MazeUtilities::positionAfterMovingForward(position, direction);
+        maze.setWall(position.first, position.second, direction, false);
+        visited.setBit(next.first * height + next.second);
+        stack.append(next);
+    }
+    return maze;
+}
+
+QPair<qint64, qint64> MazeBenchmark::getResidentKilobytes() {
+    qint64 resident = -1;
+    qint64 peak = -1;
+    QFile file("/proc/self/status");
+    if (file.open(QIODevice::ReadOnly)) {
+        for (const QByteArray& line : file.readAll().split('\n')) {
+            QList<QByteArray> tokens = line.simplified().split(' ');
+            if (tokens.size() < 2) {
+                continue;
+            }
+            if (tokens.at(0) == "VmRSS:") {
+                resident = tokens.at(1).toLongLong();
+            }
+            else if (tokens.at(0) == "VmHWM:") {
+                peak = tokens.at(1).toLongLong();
+            }
+        }
+    }
+    return {resident, peak};
+}
+
+} // namespace mms
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QPair>
+#include <QVector>
+
+#include "PackedMaze.h"
+
+namespace mms {
+
+// Times each stage of the maze pipeline - loading (which includes validation
+// and distance computation), validation on its own, building the rendering
+// buffers, drawing a frame, and a discrete run that explores every tile - on
+// generated mazes of increasing size, and prints one row per size to stdout.
+// Before that, each maze file format is round-tripped and its read and write
+// throughput is measured. Run it with "--benchmark" to see how the numbers
+// scale; it fails if any round trip doesn't reproduce the maze.
+class MazeBenchmark {
+
+public:
+
+    // This class is not constructible
+    MazeBenchmark() = delete;
+
+    // Returns a process exit code
+    static int run(const QVector<int>& sizes);
+
+private:
+
+    // A perfect maze (every tile reachable by exactly one path), generated
+    // by a randomized depth-first search with a fixed seed
+    static PackedMaze generate(int width, int height);
+
+    // Returns whether or not every format round-tripped
+    static bool runFormats(const QVector<int>& sizes);
+
+    // The process's resident and peak resident memory, in kilobytes, as
+    // reported by /proc (-1 where unavailable)
+    static QPair<qint64, qint64> getResidentKilobytes();
+};
+
+} // namespace mms
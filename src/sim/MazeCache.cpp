@@ -0,0 +1,216 @@
+#include "MazeCache.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+#include <limits>
+
+#include "FunctionTask.h"
+#include "TileGraphic.h"
+
+namespace mms {
+
+MazeCache::MazeCache(const ViewFactory& factory, qint64 capacity, QObject* parent) :
+        QObject(parent),
+        m_factory(factory),
+        m_capacity(capacity),
+        m_bytes(0),
+        m_clock(0),
+        m_current(nullptr) {
+    // Leave most of the cores to the GUI and the mouse algorithm
+    m_threadPool.setMaxThreadCount(2);
+    m_timer.setInterval(50);
+    connect(&m_timer, &QTimer::timeout, this, &MazeCache::applyLoaded);
+}
+
+MazeCache::~MazeCache() {
+    m_threadPool.clear();
+    m_threadPool.waitForDone();
+    for (const Loaded& loaded : m_loaded) {
+        delete loaded.maze;
+    }
+    for (const Entry& entry : m_entries) {
+        delete entry.view;
+        delete entry.maze;
+    }
+}
+
+QPair<Maze*, MazeView*> MazeCache::get(const QString& path) {
+    m_clock += 1;
+    if (isFresh(path)) {
+        Entry& entry = m_entries[path];
+        entry.lastUsed = m_clock;
+        return {entry.maze, entry.view};
+    }
+    QPair<qint64, qint64> stamp = getFileStamp(path);
+    Maze* maze = Maze::fromFile(path);
+    if (maze == nullptr) {
+        return {nullptr, nullptr};
+    }
+    insert({path, stamp.first, stamp.second, maze});
+    evict(path);
+    const Entry& entry = m_entries[path];
+    return {entry.maze, entry.view};
+}
+
+void MazeCache::preload(const QStringList& paths) {
+    if (m_capacity == 0) {
+        return;
+    }
+    for (const QString& path : paths) {
+        if (m_loading.contains(path) || isFresh(path)) {
+            continue;
+        }
+        m_loading.insert(path);
+        m_threadPool.start(new FunctionTask([=]() {
+            // Stamp the file before reading it, so that a change made while
+            // it's being read leaves the entry stale rather than wrong
+            QPair<qint64, qint64> stamp = getFileStamp(path);
+            Maze* maze = Maze::fromFile(path);
+            QMutexLocker locker(&m_mutex);
+            m_loaded.append({path, stamp.first, stamp.second, maze});
+        }));
+    }
+    if (!m_loading.isEmpty()) {
+        m_timer.start();
+    }
+}
+
+bool MazeCache::owns(const Maze* maze) const {
+    for (const Entry& entry : m_entries) {
+        if (entry.maze == maze) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MazeCache::release(const Maze* maze) {
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it.value().maze == maze) {
+            m_bytes -= it.value().bytes;
+            m_entries.erase(it);
+            return;
+        }
+    }
+}
+
+void MazeCache::setCurrent(const Maze* maze) {
+    m_current = maze;
+    evict(QString());
+}
+
+QVector<MazeView*> MazeCache::getViews() const {
+    QVector<MazeView*> views;
+    for (const Entry& entry : m_entries) {
+        views.append(entry.view);
+    }
+    return views;
+}
+
+bool MazeCache::isFresh(const QString& path) const {
+    auto it = m_entries.find(path);
+    if (it == m_entries.end()) {
+        return false;
+    }
+    QPair<qint64, qint64> stamp = getFileStamp(path);
+    return (
+        it.value().lastModified == stamp.first &&
+        it.value().fileSize == stamp.second
+    );
+}
+
+void MazeCache::insert(const Loaded& loaded) {
+    remove(loaded.path);
+    m_clock += 1;
+    Entry entry;
+    entry.lastModified = loaded.lastModified;
+    entry.fileSize = loaded.fileSize;
+    entry.maze = loaded.maze;
+    entry.view = m_factory(loaded.maze);
+    entry.bytes = estimateBytes(entry.maze, entry.view);
+    entry.lastUsed = m_clock;
+    m_entries.insert(loaded.path, entry);
+    m_bytes += entry.bytes;
+}
+
+void MazeCache::remove(const QString& path) {
+    auto it = m_entries.find(path);
+    if (it == m_entries.end()) {
+        return;
+    }
+    m_bytes -= it.value().bytes;
+    if (it.value().maze != m_current) {
+        delete it.value().view;
+        delete it.value().maze;
+    }
+    m_entries.erase(it);
+}
+
+void MazeCache::evict(const QString& keep) {
+    while (m_capacity < m_bytes) {
+        QString oldest;
+        qint64 oldestUse = std::numeric_limits<qint64>::max();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it.value().maze != m_current && it.key() != keep &&
+                    it.value().lastUsed < oldestUse) {
+                oldest = it.key();
+                oldestUse = it.value().lastUsed;
+            }
+        }
+        if (oldest.isNull()) {
+            break;
+        }
+        remove(oldest);
+    }
+}
+
+void MazeCache::applyLoaded() {
+
+    Loaded loaded;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_loaded.isEmpty()) {
+            return;
+        }
+        loaded = m_loaded.takeFirst();
+    }
+    m_loading.remove(loaded.path);
+    if (m_loading.isEmpty()) {
+        m_timer.stop();
+    }
+
+    // The file may have been selected, and so loaded, in the meantime
+    if (loaded.maze == nullptr) {
+        return;
+    }
+    if (isFresh(loaded.path)) {
+        delete loaded.maze;
+        return;
+    }
+    insert(loaded);
+    evict(loaded.path);
+}
+
+QPair<qint64, qint64> MazeCache::getFileStamp(const QString& path) {
+    QFileInfo info(path);
+    return {info.lastModified().toMSecsSinceEpoch(), info.size()};
+}
+
+qint64 MazeCache::estimateBytes(const Maze* maze, MazeView* view) {
+
+    // Per tile: the distance, the graphic, and the graphic's walls and text
+    static const qint64 TILE_BYTES = sizeof(int) + sizeof(TileGraphic) + 192;
+
+    qint64 bytes = qint64(maze->getWidth()) * maze->getHeight() * TILE_BYTES;
+    bytes += view->getGraphicCpuBuffer()->capacity() * sizeof(TriangleGraphic);
+    bytes += view->getTextureCpuBuffer()->capacity() * sizeof(TriangleTexture);
+    if (view->getTileImage() != nullptr) {
+        const QImage& image = view->getTileImage()->getImage();
+        bytes += qint64(image.bytesPerLine()) * image.height();
+    }
+    return bytes;
+}
+
+} // namespace mms
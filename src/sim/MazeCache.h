@@ -0,0 +1,114 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+
+#include <functional>
+
+#include "Maze.h"
+#include "MazeView.h"
+
+namespace mms {
+
+// Recently loaded mazes, along with their truth views, so that switching back
+// to a maze needs neither a reload nor a rebuild of the view. Entries are
+// keyed by path, and dropped once the file's modification time or size no
+// longer match. The least recently used entries are evicted once the
+// estimated memory exceeds the capacity, except for the current maze.
+class MazeCache : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    // Builds the truth view of a maze; only ever called on the GUI thread
+    typedef std::function<MazeView*(const Maze*)> ViewFactory;
+
+    MazeCache(const ViewFactory& factory, qint64 capacity, QObject* parent = nullptr);
+    ~MazeCache();
+
+    // Returns the maze and its truth view, loading the file if it isn't cached
+    // or has changed since it was; both are null if it can't be loaded. The
+    // cache keeps ownership of both.
+    QPair<Maze*, MazeView*> get(const QString& path);
+
+    // Loads and checks the files in the background, and then builds their
+    // views on the GUI thread, one at a time so as not to stall it
+    void preload(const QStringList& paths);
+
+    bool owns(const Maze* maze) const;
+
+    // Hands ownership of the maze and its view to the caller, e.g., because
+    // it's about to be edited and will no longer match its file
+    void release(const Maze* maze);
+
+    // The current maze is never evicted
+    void setCurrent(const Maze* maze);
+
+    QVector<MazeView*> getViews() const;
+
+private:
+
+    struct Entry {
+        qint64 lastModified;
+        qint64 fileSize;
+        Maze* maze;
+        MazeView* view;
+        qint64 bytes;
+        // When the entry was last used, by m_clock
+        qint64 lastUsed;
+    };
+
+    // A maze loaded by a worker, waiting for its view to be built
+    struct Loaded {
+        QString path;
+        qint64 lastModified;
+        qint64 fileSize;
+        Maze* maze;
+    };
+
+    // The cache holds a few dozen mazes at most, so the least recently used
+    // entry is simply found by a linear scan
+    ViewFactory m_factory;
+    qint64 m_capacity;
+    qint64 m_bytes;
+    qint64 m_clock;
+    QHash<QString, Entry> m_entries;
+    const Maze* m_current;
+
+    // The paths being loaded by the workers, and their results; only the
+    // results are touched by the workers
+    QSet<QString> m_loading;
+    QMutex m_mutex;
+    QVector<Loaded> m_loaded;
+
+    QThreadPool m_threadPool;
+    QTimer m_timer;
+
+    bool isFresh(const QString& path) const;
+    void insert(const Loaded& loaded);
+
+    // Deletes the entry's maze and view, unless it's the current maze, in
+    // which case they now belong to the caller
+    void remove(const QString& path);
+
+    // Evicts the least recently used entries until the cache fits, other than
+    // the current maze and the given path
+    void evict(const QString& keep);
+
+    // Builds the view of a maze that a worker has loaded
+    void applyLoaded();
+
+    static QPair<qint64, qint64> getFileStamp(const QString& path);
+    static qint64 estimateBytes(const Maze* maze, MazeView* view);
+};
+
+} // namespace mms
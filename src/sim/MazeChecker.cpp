@@ -1,160 +1,280 @@
 #include "MazeChecker.h"
 
-#include <QPair>
-#include <QQueue>
+#include <QSemaphore>
+#include <QStringList>
+#include <QThreadPool>
 
 #include "Direction.h"
+#include "FunctionTask.h"
 #include "MazeUtilities.h"
 
 namespace mms {
 
+const QMap<MazeRule, QString>& MAZE_RULE_TO_STRING() {
+    static const QMap<MazeRule, QString> map = {
+        {MazeRule::NONEMPTY, "Nonempty"},
+        {MazeRule::ENCLOSED, "Enclosed"},
+        {MazeRule::CONSISTENT_WALLS, "Consistent walls"},
+        {MazeRule::NO_INACCESSIBLE_LOCATIONS, "No inaccessible locations"},
+        {MazeRule::THREE_STARTING_WALLS, "Three starting walls"},
+        {MazeRule::ONE_ENTRANCE_TO_CENTER, "One entrance to center"},
+        {MazeRule::HOLLOW_CENTER, "Hollow center"},
+        {MazeRule::WALL_ATTACHED_TO_EACH_NON_CENTER_POST, "Wall attached to each non-center post"},
+        {MazeRule::UNSOLVABLE_BY_WALL_FOLLOWER, "Unsolvable by wall follower"},
+    };
+    return map;
+}
+
 MazeValidity MazeChecker::checkMaze(const BasicMaze& maze) {
-    bool drawable =  (
+    if (!isDrawable(maze)) {
+        return MazeValidity::INVALID;
+    }
+    return checkMaze(PackedMaze::fromBasicMaze(maze));
+}
+
+bool MazeChecker::isDrawable(const BasicMaze& maze) {
+    return (
         isNonempty(maze) &&
         isRectangular(maze)
     );
-    if (!drawable) {
+}
+
+const QVector<QPair<MazeRule, MazeChecker::Rule>>& MazeChecker::getExplorableRules() {
+    static const QVector<QPair<MazeRule, Rule>> rules = {
+        {MazeRule::ENCLOSED, &MazeChecker::isEnclosed},
+        {MazeRule::CONSISTENT_WALLS, &MazeChecker::hasConsistentWalls},
+    };
+    return rules;
+}
+
+const QVector<QPair<MazeRule, MazeChecker::Rule>>& MazeChecker::getOfficialRules() {
+    // Cheapest first, so that checking stops as early as possible
+    static const QVector<QPair<MazeRule, Rule>> rules = {
+        {MazeRule::THREE_STARTING_WALLS, &MazeChecker::hasThreeStartingWalls},
+        {MazeRule::ONE_ENTRANCE_TO_CENTER, &MazeChecker::hasOneEntranceToCenter},
+        {MazeRule::HOLLOW_CENTER, &MazeChecker::hasHollowCenter},
+        {MazeRule::WALL_ATTACHED_TO_EACH_NON_CENTER_POST,
+            &MazeChecker::hasWallAttachedToEachNonCenterPost},
+        {MazeRule::NO_INACCESSIBLE_LOCATIONS, &MazeChecker::hasNoInaccessibleLocations},
+        {MazeRule::UNSOLVABLE_BY_WALL_FOLLOWER, &MazeChecker::isUnsolvableByWallFollower},
+    };
+    return rules;
+}
+
+MazeValidity MazeChecker::checkMaze(const PackedMaze& maze) {
+    if (maze.getWidth() == 0 || maze.getHeight() == 0) {
         return MazeValidity::INVALID;
     }
-    bool explorable = (
-        isEnclosed(maze) &&
-        hasConsistentWalls(maze)
-    );
-    if (!explorable) {
+    if (!checkRules(maze, getExplorableRules(), nullptr)) {
         return MazeValidity::DRAWABLE;
     }
-    bool official = (
-        hasNoInaccessibleLocations(maze) &&
-        hasThreeStartingWalls(maze) &&
-        hasOneEntranceToCenter(maze) &&
-        hasHollowCenter(maze) &&
-        hasWallAttachedToEachNonCenterPost(maze) &&
-        isUnsolvableByWallFollower(maze)
-    );
-    if (!official) {
+    if (!checkRules(maze, getOfficialRules(), nullptr)) {
         return MazeValidity::EXPLORABLE;
     }
     return MazeValidity::OFFICIAL;
 }
 
-bool MazeChecker::isNonempty(const BasicMaze& maze) {
-    return (
-        0 < maze.size() &&
-        0 < maze.at(0).size()
-    );
+bool MazeChecker::checkRule(const PackedMaze& maze, MazeRule rule) {
+    if (maze.getWidth() == 0 || maze.getHeight() == 0) {
+        return false;
+    }
+    for (const auto& rules : {getExplorableRules(), getOfficialRules()}) {
+        for (const auto& pair : rules) {
+            if (pair.first == rule) {
+                return pair.second(maze, nullptr);
+            }
+        }
+    }
+    return true;
 }
 
-bool MazeChecker::isRectangular(const BasicMaze& maze) {
-    for (int i = 0; i < maze.size() - 1; i += 1) {
-        if (maze.at(i).size() != maze.at(i + 1).size()) {
+bool MazeChecker::checkWallFollower(const PackedMaze& maze, PackedMaze* lookedAt) {
+    if (lookedAt != nullptr) {
+        *lookedAt = PackedMaze(maze.getWidth(), maze.getHeight());
+    }
+    TileBitset reachable = followWalls(maze, identity(maze), false, lookedAt);
+    for (const auto& tile :
+            MazeUtilities::getCenterPositions(maze.getWidth(), maze.getHeight())) {
+        if (reachable.test(tile.first, tile.second)) {
             return false;
         }
     }
     return true;
 }
 
-bool MazeChecker::isEnclosed(const BasicMaze& maze) {
-    for (int x = 0; x < maze.size(); x += 1) {
-        for (int y = 0; y < maze.at(x).size(); y += 1) {
-            BasicTile walls = maze.at(x).at(y);
-            if (x == 0 && !walls.value(Direction::WEST)) {
-                return false;
-            }
-            if (y == 0 && !walls.value(Direction::SOUTH)) {
-                return false;
-            }
-            if (x == maze.size() - 1 && !walls.value(Direction::EAST)) {
-                return false;
-            }
-            if (y == maze.at(x).size() - 1 && !walls.value(Direction::NORTH)) {
-                return false;
-            }
+TileBitset MazeChecker::getWallFollowerTiles(const PackedMaze& maze, bool leftHanded) {
+    return followWalls(maze, identity(maze), leftHanded, nullptr);
+}
+
+MazeValidity MazeChecker::checkSymmetry(
+        const PackedMaze& maze,
+        const MazeSymmetryMap& symmetry,
+        MazeValidity validity) {
+
+    // Being enclosed, with consistent walls, doesn't depend on the start
+    if (validity != MazeValidity::EXPLORABLE && validity != MazeValidity::OFFICIAL) {
+        return validity;
+    }
+
+    // Nor do the rules about the center, the posts, and connectedness, but
+    // an explorable maze may have broken them
+    if (validity == MazeValidity::EXPLORABLE && !(
+            hasNoInaccessibleLocations(maze, nullptr) &&
+            hasOneEntranceToCenter(maze, nullptr) &&
+            hasHollowCenter(maze, nullptr) &&
+            hasWallAttachedToEachNonCenterPost(maze, nullptr))) {
+        return MazeValidity::EXPLORABLE;
+    }
+
+    // The start is one of the maze's corners
+    int count = 0;
+    for (Direction direction : DIRECTIONS()) {
+        if (maze.isWall(symmetry.toSourceX(0, 0), symmetry.toSourceY(0, 0), direction)) {
+            count += 1;
         }
     }
-    return true;
+    if (count != 3) {
+        return MazeValidity::EXPLORABLE;
+    }
+
+    // The center is the same in every view
+    TileBitset reachable = followWalls(maze, symmetry, false, nullptr);
+    for (const auto& tile :
+            MazeUtilities::getCenterPositions(maze.getWidth(), maze.getHeight())) {
+        if (reachable.test(tile.first, tile.second)) {
+            return MazeValidity::EXPLORABLE;
+        }
+    }
+    return MazeValidity::OFFICIAL;
 }
 
-bool MazeChecker::hasConsistentWalls(const BasicMaze& maze) {
-    for (int x = 0; x < maze.size(); x += 1) {
-        for (int y = 0; y < maze.at(x).size(); y += 1) {
-            BasicTile walls = maze.at(x).at(y);
-            if (
-                0 < x &&
-                walls.value(Direction::WEST) &&
-                !maze.at(x - 1).at(y).value(Direction::EAST)
-            ) {
-                return false;
-            }
-            if (
-                0 < y &&
-                walls.value(Direction::SOUTH) &&
-                !maze.at(x).at(y - 1).value(Direction::NORTH)
-            ) {
-                return false;
-            }
-            if (
-                x < maze.size() - 1 &&
-                walls.value(Direction::EAST) &&
-                !maze.at(x + 1).at(y).value(Direction::WEST)
-            ) {
-                return false;
+MazeReport MazeChecker::getReport(const PackedMaze& maze) {
+    MazeReport report;
+    if (maze.getWidth() == 0 || maze.getHeight() == 0) {
+        report.validity = MazeValidity::INVALID;
+        report.failures.append({MazeRule::NONEMPTY, 1, {}});
+        return report;
+    }
+    bool explorable = checkRules(maze, getExplorableRules(), &report.failures);
+    bool official = checkRules(maze, getOfficialRules(), &report.failures);
+    report.validity = (
+        !explorable ? MazeValidity::DRAWABLE :
+        !official ? MazeValidity::EXPLORABLE :
+        MazeValidity::OFFICIAL
+    );
+    return report;
+}
+
+QString MazeChecker::describe(const MazeReport& report) {
+    if (report.failures.isEmpty()) {
+        return "The maze follows every rule";
+    }
+    QStringList lines;
+    for (const MazeRuleFailure& failure : report.failures) {
+        QString line = MAZE_RULE_TO_STRING().value(failure.rule) + ": failed";
+        if (!failure.tiles.isEmpty()) {
+            QStringList tiles;
+            for (const QPair<int, int>& tile : failure.tiles) {
+                tiles.append(QString("(%1, %2)").arg(tile.first).arg(tile.second));
             }
-            if (
-                y < maze.at(x).size() - 1 &&
-                walls.value(Direction::NORTH) &&
-                !maze.at(x).at(y + 1).value(Direction::SOUTH)
-            ) {
-                return false;
+            line += " at " + tiles.join(", ");
+            if (failure.tiles.size() < failure.count) {
+                line += QString(" and %1 more").arg(
+                    failure.count - failure.tiles.size());
             }
         }
+        lines.append(line);
+    }
+    return lines.join("\n");
+}
+
+bool MazeChecker::isNonempty(const BasicMaze& maze) {
+    return (
+        0 < maze.size() &&
+        0 < maze.at(0).size()
+    );
+}
+
+bool MazeChecker::isRectangular(const BasicMaze& maze) {
+    for (int i = 0; i < maze.size() - 1; i += 1) {
+        if (maze.at(i).size() != maze.at(i + 1).size()) {
+            return false;
+        }
     }
     return true;
 }
 
-bool MazeChecker::hasNoInaccessibleLocations(const BasicMaze& maze) {
-    QSet<QPair<int, int>> discovered;
-    QQueue<QPair<int, int>> queue;
-    QPair<int, int> start = {0, 0};
-    discovered.insert(start);
-    queue.enqueue(start);
-    while (!queue.isEmpty()) {
-        QPair<int, int> tile = queue.dequeue();
-        for (Direction direction : DIRECTIONS()) {
-            if (maze.at(tile.first).at(tile.second).value(direction)) {
-                continue;
-            }
-            QPair<int, int> neighbor =
-                MazeUtilities::positionAfterMovingForward(tile, direction);
-            if (!discovered.contains(neighbor)) {
-                discovered.insert(neighbor);
-                queue.enqueue(neighbor);
-            }
+bool MazeChecker::isEnclosed(const PackedMaze& maze, MazeRuleFailure* failure) {
+    // The tiles beside each missing border wall (corners may appear twice)
+    int width = maze.getWidth();
+    int height = maze.getHeight();
+    bool enclosed = true;
+    auto check = [&](int x, int y, Direction direction) {
+        if (maze.isWall(x, y, direction)) {
+            return true;
+        }
+        enclosed = false;
+        if (failure == nullptr) {
+            return false;
+        }
+        addTile(failure, x, y);
+        return true;
+    };
+    for (int x = 0; x < width; x += 1) {
+        if (!check(x, 0, Direction::SOUTH) ||
+                !check(x, height - 1, Direction::NORTH)) {
+            return false;
         }
     }
-    for (int x = 0; x < maze.size(); x += 1) {
-        for (int y = 0; y < maze.at(x).size(); y += 1) {
-            if (!discovered.contains({x, y})) {
-                return false;
-            }
+    for (int y = 0; y < height; y += 1) {
+        if (!check(0, y, Direction::WEST) ||
+                !check(width - 1, y, Direction::EAST)) {
+            return false;
         }
     }
-    return true;
+    return enclosed;
 }
 
-bool MazeChecker::hasThreeStartingWalls(const BasicMaze& maze) {
+bool MazeChecker::hasConsistentWalls(const PackedMaze& maze, MazeRuleFailure* failure) {
+    // The packed store holds each wall once, so any disagreement
+    // between wall halves was recorded when it was built, without a
+    // location; the failure has no tiles
+    Q_UNUSED(failure);
+    return maze.hasConsistentWalls();
+}
+
+bool MazeChecker::hasNoInaccessibleLocations(const PackedMaze& maze, MazeRuleFailure* failure) {
+    // The tiles that can't be reached from the start
+    TileBitset seeds(maze.getWidth(), maze.getHeight());
+    seeds.set(0, 0);
+    TileBitset reached = TileBitset::flood(maze, seeds);
+    int inaccessible = maze.getWidth() * maze.getHeight() - reached.count();
+    if (inaccessible != 0 && failure != nullptr) {
+        failure->count = inaccessible;
+        failure->tiles = reached.getTiles(MAX_REPORTED_TILES, false);
+    }
+    return inaccessible == 0;
+}
+
+bool MazeChecker::hasThreeStartingWalls(const PackedMaze& maze, MazeRuleFailure* failure) {
+    // The starting tile
     int count = 0;
     for (Direction direction : DIRECTIONS()) {
-        if (maze.at(0).at(0).value(direction)) {
+        if (maze.isWall(0, 0, direction)) {
             count += 1;
         }
     }
+    if (count != 3 && failure != nullptr) {
+        addTile(failure, 0, 0);
+    }
     return count == 3;
 }
 
-bool MazeChecker::hasOneEntranceToCenter(const BasicMaze& maze) {
+bool MazeChecker::hasOneEntranceToCenter(const PackedMaze& maze, MazeRuleFailure* failure) {
+    // The center tiles with an entrance, or all of them if there's none
     const auto& centerPositions =
-        MazeUtilities::getCenterPositions(maze.size(), maze.at(0).size()); 
-    int numberOfEntrances = 0;
+        MazeUtilities::getCenterPositions(maze.getWidth(), maze.getHeight());
+    QVector<QPair<int, int>> entrances;
     for (QPair<int, int> tile : centerPositions) {
         for (Direction direction : DIRECTIONS()) {
             if (centerPositions.contains(
@@ -162,94 +282,205 @@ bool MazeChecker::hasOneEntranceToCenter(const BasicMaze& maze) {
             )) {
                 continue;
             }
-            if (!maze.at(tile.first).at(tile.second).value(direction)) {
-                numberOfEntrances += 1;
+            if (!maze.isWall(tile.first, tile.second, direction)) {
+                entrances.append(tile);
             }
         }
     }
-    return numberOfEntrances == 1;
+    if (entrances.size() != 1 && failure != nullptr) {
+        for (QPair<int, int> tile : entrances.isEmpty() ? centerPositions : entrances) {
+            addTile(failure, tile.first, tile.second);
+        }
+    }
+    return entrances.size() == 1;
 }
 
-bool MazeChecker::hasHollowCenter(const BasicMaze& maze) {
+bool MazeChecker::hasHollowCenter(const PackedMaze& maze, MazeRuleFailure* failure) {
+    // The center tiles with a wall between them and another center tile
     const auto& centerPositions =
-        MazeUtilities::getCenterPositions(maze.size(), maze.at(0).size()); 
+        MazeUtilities::getCenterPositions(maze.getWidth(), maze.getHeight());
+    bool hollow = true;
     for (const auto& tile : centerPositions) {
-        for (const auto& other : centerPositions) {
-            for (const auto& direction : DIRECTIONS()) {
-                if (
-                    MazeUtilities::positionAfterMovingForward(tile, direction)
-                    != other
-                ) {
-                    continue;
-                }
-                if (maze.at(tile.first).at(tile.second).value(direction)) {
+        for (const auto& direction : DIRECTIONS()) {
+            if (!centerPositions.contains(
+                MazeUtilities::positionAfterMovingForward(tile, direction)
+            )) {
+                continue;
+            }
+            if (maze.isWall(tile.first, tile.second, direction)) {
+                hollow = false;
+                if (failure == nullptr) {
                     return false;
                 }
+                addTile(failure, tile.first, tile.second);
+                break;
             }
         }
     }
-    return true;
+    return hollow;
 }
 
-bool MazeChecker::hasWallAttachedToEachNonCenterPost(const BasicMaze& maze) {
+bool MazeChecker::hasWallAttachedToEachNonCenterPost(const PackedMaze& maze, MazeRuleFailure* failure) {
+    // The tiles whose northeast post is bare. The post at the northeast
+    // of (x, y) is bare if there's no wall north or east of (x, y), north
+    // of (x + 1, y), or east of (x, y + 1). Openings exclude the border, so
+    // only interior posts are considered, and a word of posts is checked at
+    // a time.
+    int height = maze.getHeight();
+    TileBitset north = TileBitset::getOpenings(maze, Direction::NORTH);
+    TileBitset east = TileBitset::getOpenings(maze, Direction::EAST);
+    TileBitset bare = north;
+    bare &= east;
+    bare &= north.shifted(height);
+    bare &= east.shifted(1);
     const auto& centerPositions =
-        MazeUtilities::getCenterPositions(maze.size(), maze.at(0).size());
-    for (int x = 0; x < maze.size() - 1; x += 1) {
-        for (int y = 0; y < maze.at(x).size() - 1; y += 1) {
-            // There is a wall attached
-            if (
-                maze.at(x).at(y).value(Direction::NORTH) ||
-                maze.at(x).at(y).value(Direction::EAST) ||
-                maze.at(x + 1).at(y + 1).value(Direction::SOUTH) ||
-                maze.at(x + 1).at(y + 1).value(Direction::WEST)
-            ) {
-                continue;
-            }
-            // It is the center post
-            QPair<int, int> position = {x, y};
-            if (
-                centerPositions.size() == 4 &&
-                position == MazeUtilities::getMinPosition(centerPositions)
-            ) {
-                continue;
+        MazeUtilities::getCenterPositions(maze.getWidth(), height);
+    if (centerPositions.size() == 4) {
+        QPair<int, int> position = MazeUtilities::getMinPosition(centerPositions);
+        bare.reset(position.first, position.second);
+    }
+    int count = bare.count();
+    if (count != 0 && failure != nullptr) {
+        failure->count = count;
+        failure->tiles = bare.getTiles(MAX_REPORTED_TILES);
+    }
+    return count == 0;
+}
+
+bool MazeChecker::isUnsolvableByWallFollower(const PackedMaze& maze, MazeRuleFailure* failure) {
+    // The center tiles that the wall follower reaches
+    TileBitset reachable = followWalls(maze, identity(maze), false, nullptr);
+    bool unsolvable = true;
+    for (const auto& tile :
+            MazeUtilities::getCenterPositions(maze.getWidth(), maze.getHeight())) {
+        if (reachable.test(tile.first, tile.second)) {
+            unsolvable = false;
+            if (failure == nullptr) {
+                break;
             }
-            return false; 
+            addTile(failure, tile.first, tile.second);
         }
     }
-    return true;
+    return unsolvable;
 }
 
-bool MazeChecker::isUnsolvableByWallFollower(const BasicMaze& maze) {
-    const auto& centerPositions =
-        MazeUtilities::getCenterPositions(maze.size(), maze.at(0).size());
-    QSet<QPair<int, int>> reachable;
-    QPair<int, int> start = {0, 0};
+TileBitset MazeChecker::followWalls(
+        const PackedMaze& maze,
+        const MazeSymmetryMap& symmetry,
+        bool leftHanded,
+        PackedMaze* lookedAt) {
+    // Steps out of the maze are treated as walls, so unenclosed mazes are
+    // safe to walk
+    auto isBlocked = [&](QPair<int, int> position, int direction) {
+        Direction actual = DIRECTIONS().at(direction);
+        if (lookedAt != nullptr) {
+            lookedAt->setWall(position.first, position.second, actual, true);
+        }
+        QPair<int, int> next =
+            MazeUtilities::positionAfterMovingForward(position, actual);
+        return (
+            maze.isWall(position.first, position.second, actual) ||
+            !maze.withinMaze(next.first, next.second)
+        );
+    };
+    TileBitset reachable(maze.getWidth(), maze.getHeight());
+    QPair<int, int> start = {symmetry.toSourceX(0, 0), symmetry.toSourceY(0, 0)};
     QPair<int, int> position = start;
-    Direction direction = Direction::NORTH;
+    // An index into DIRECTIONS(), which run clockwise from north, so that
+    // turning is arithmetic rather than a map lookup; in a mirrored view,
+    // turning right is turning counter-clockwise in the maze. A left-hand
+    // follower is a right-hand one with the turns swapped.
+    int direction = DIRECTIONS().indexOf(symmetry.toSource(Direction::NORTH));
+    int right = symmetry.isMirrored() != leftHanded ? 3 : 1;
+    int left = 4 - right;
     do {
-        reachable.insert(position);
-        Direction oldDirection = direction;
-        Direction newDirection = DIRECTION_ROTATE_RIGHT().value(direction);
-        if (!maze.at(position.first).at(position.second).value(newDirection)) {
+        reachable.set(position.first, position.second);
+        int oldDirection = direction;
+        int newDirection = (direction + right) % 4;
+        if (!isBlocked(position, newDirection)) {
             direction = newDirection;
         }
-        while (maze.at(position.first).at(position.second).value(direction)) {
-            direction = DIRECTION_ROTATE_LEFT().value(direction);
+        while (isBlocked(position, direction)) {
+            direction = (direction + left) % 4;
             if (direction == oldDirection) {
                 // We're surrounded by walls
-                return !centerPositions.contains(position);
+                return reachable;
             }
         }
-        position =
-            MazeUtilities::positionAfterMovingForward(position, direction);
+        position = MazeUtilities::positionAfterMovingForward(
+            position, DIRECTIONS().at(direction));
     }
     while (position != start);
-    for (const auto& tile : centerPositions) {
-        if (reachable.contains(tile)) {
-            return false;
+    return reachable;
+}
+
+MazeSymmetryMap MazeChecker::identity(const PackedMaze& maze) {
+    return MazeSymmetryMap(MazeSymmetry::IDENTITY, maze.getWidth(), maze.getHeight());
+}
+
+bool MazeChecker::checkRules(
+        const PackedMaze& maze,
+        const QVector<QPair<MazeRule, Rule>>& rules,
+        QVector<MazeRuleFailure>* failures) {
+
+    QVector<MazeRuleFailure> results;
+    for (const auto& rule : rules) {
+        results.append({rule.first, 0, {}});
+    }
+    QVector<bool> held(rules.size(), true);
+
+    // Each rule writes only to its own slot, so nothing is shared but the
+    // (read-only) maze
+    MazeRuleFailure* resultData = results.data();
+    bool* heldData = held.data();
+    auto runRule = [&](int i) {
+        heldData[i] = rules.at(i).second(
+            maze, failures == nullptr ? nullptr : &resultData[i]);
+    };
+
+    if (PARALLEL_TILE_COUNT <= maze.getWidth() * maze.getHeight() && 1 < rules.size()) {
+        // Walking a large maze dominates, so the rules are run side by side;
+        // any that the pool has no room for are run here instead
+        QSemaphore done;
+        for (int i = 0; i < rules.size(); i += 1) {
+            FunctionTask* task = new FunctionTask([&, i]() {
+                runRule(i);
+                done.release();
+            });
+            if (!QThreadPool::globalInstance()->tryStart(task)) {
+                delete task;
+                runRule(i);
+                done.release();
+            }
         }
+        done.acquire(rules.size());
+    }
+    else {
+        for (int i = 0; i < rules.size(); i += 1) {
+            runRule(i);
+            if (!held.at(i) && failures == nullptr) {
+                return false;
+            }
+        }
+    }
+
+    bool allHeld = true;
+    for (int i = 0; i < rules.size(); i += 1) {
+        if (!held.at(i)) {
+            allHeld = false;
+            if (failures != nullptr) {
+                failures->append(results.at(i));
+            }
+        }
+    }
+    return allHeld;
+}
+
+void MazeChecker::addTile(MazeRuleFailure* failure, int x, int y) {
+    failure->count += 1;
+    if (failure->tiles.size() < MAX_REPORTED_TILES) {
+        failure->tiles.append({x, y});
     }
-    return true;
 }
 
 } // namespace mms
@@ -1,6 +1,14 @@
 #pragma once
 
+#include <QMap>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
 #include "BasicMaze.h"
+#include "MazeSymmetry.h"
+#include "PackedMaze.h"
+#include "TileBitset.h"
 
 namespace mms {
 
@@ -14,25 +22,121 @@ enum class MazeValidity {
     OFFICIAL,
 };
 
+// The rules that a maze is checked against; the first is required for the
+// maze to be drawable, the next two for it to be explorable, and the rest
+// for it to be official
+enum class MazeRule {
+    NONEMPTY,
+    ENCLOSED,
+    CONSISTENT_WALLS,
+    NO_INACCESSIBLE_LOCATIONS,
+    THREE_STARTING_WALLS,
+    ONE_ENTRANCE_TO_CENTER,
+    HOLLOW_CENTER,
+    WALL_ATTACHED_TO_EACH_NON_CENTER_POST,
+    UNSOLVABLE_BY_WALL_FOLLOWER,
+};
+
+const QMap<MazeRule, QString>& MAZE_RULE_TO_STRING();
+
+// A rule that a maze breaks, along with the tiles that break it. Only the
+// first few tiles are kept, but all of them are counted. Each rule says
+// what its tiles are: e.g., the tiles that can't be reached, or the tiles
+// whose northeast post has no walls attached.
+struct MazeRuleFailure {
+    MazeRule rule;
+    int count;
+    QVector<QPair<int, int>> tiles;
+};
+
+// Why a maze is (or isn't) valid
+struct MazeReport {
+    MazeValidity validity;
+    QVector<MazeRuleFailure> failures;
+};
+
 class MazeChecker {
 
 public:
 
     MazeChecker() = delete;
     static MazeValidity checkMaze(const BasicMaze& maze);
+    static MazeValidity checkMaze(const PackedMaze& maze);
+
+    // Checks every rule, rather than stopping at the first one that fails
+    static MazeReport getReport(const PackedMaze& maze);
+    static QString describe(const MazeReport& report);
+
+    // Whether or not the maze can be packed without dropping any tiles
+    static bool isDrawable(const BasicMaze& maze);
+
+    // Checks a single rule, e.g., one that an edit may have affected
+    static bool checkRule(const PackedMaze& maze, MazeRule rule);
+
+    // Checks the wall follower rule, and fills in every wall that the
+    // follower looked at (if not null); editing any other wall can't change
+    // the outcome
+    static bool checkWallFollower(const PackedMaze& maze, PackedMaze* lookedAt);
+
+    // The tiles that a wall follower visits from the start, facing north,
+    // with its right (or left) hand on the wall
+    static TileBitset getWallFollowerTiles(const PackedMaze& maze, bool leftHanded);
+
+    // The validity of a symmetric view of the maze, given the validity of
+    // any view of it (e.g., the maze itself). Only the start moves between
+    // views, so only the rules that depend on it are checked again, unless
+    // the given validity doesn't say whether the others hold.
+    static MazeValidity checkSymmetry(
+        const PackedMaze& maze,
+        const MazeSymmetryMap& symmetry,
+        MazeValidity validity);
 
 private:
 
+    // The number of tiles at which the rules that walk the whole maze are
+    // run concurrently
+    static const int PARALLEL_TILE_COUNT = 512 * 512;
+
+    // The number of tiles kept per failure
+    static const int MAX_REPORTED_TILES = 16;
+
     static bool isNonempty(const BasicMaze& maze);
     static bool isRectangular(const BasicMaze& maze);
-    static bool isEnclosed(const BasicMaze& maze);
-    static bool hasConsistentWalls(const BasicMaze& maze);
-    static bool hasNoInaccessibleLocations(const BasicMaze& maze);
-    static bool hasThreeStartingWalls(const BasicMaze& maze);
-    static bool hasOneEntranceToCenter(const BasicMaze& maze);
-    static bool hasHollowCenter(const BasicMaze& maze);
-    static bool hasWallAttachedToEachNonCenterPost(const BasicMaze& maze);
-    static bool isUnsolvableByWallFollower(const BasicMaze& maze);
+
+    // Each of these returns whether or not the rule holds. If the failure is
+    // null, they return as soon as the rule is known to be broken, and if
+    // not, they record every tile that breaks it.
+    static bool isEnclosed(const PackedMaze& maze, MazeRuleFailure* failure);
+    static bool hasConsistentWalls(const PackedMaze& maze, MazeRuleFailure* failure);
+    static bool hasNoInaccessibleLocations(const PackedMaze& maze, MazeRuleFailure* failure);
+    static bool hasThreeStartingWalls(const PackedMaze& maze, MazeRuleFailure* failure);
+    static bool hasOneEntranceToCenter(const PackedMaze& maze, MazeRuleFailure* failure);
+    static bool hasHollowCenter(const PackedMaze& maze, MazeRuleFailure* failure);
+    static bool hasWallAttachedToEachNonCenterPost(const PackedMaze& maze, MazeRuleFailure* failure);
+    static bool isUnsolvableByWallFollower(const PackedMaze& maze, MazeRuleFailure* failure);
+
+    // The tiles that a right-hand (or left-hand) wall follower visits from
+    // the start of the view, facing its north; these and the walls looked at
+    // are in the maze's coordinates
+    static TileBitset followWalls(
+        const PackedMaze& maze,
+        const MazeSymmetryMap& symmetry,
+        bool leftHanded,
+        PackedMaze* lookedAt);
+    static MazeSymmetryMap identity(const PackedMaze& maze);
+
+    // The rules for each level of validity; checkRules() runs the given
+    // rules, concurrently if the maze is large, and returns whether or not
+    // all of them held (failures may be null)
+    typedef bool (*Rule)(const PackedMaze&, MazeRuleFailure*);
+    static const QVector<QPair<MazeRule, Rule>>& getExplorableRules();
+    static const QVector<QPair<MazeRule, Rule>>& getOfficialRules();
+    static bool checkRules(
+        const PackedMaze& maze,
+        const QVector<QPair<MazeRule, Rule>>& rules,
+        QVector<MazeRuleFailure>* failures);
+
+    static void addTile(MazeRuleFailure* failure, int x, int y);
 
 };
 
@@ -0,0 +1,165 @@
+#include "MazeConverter.h"
+
+#include <QAtomicInt>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QPair>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+
+#include <algorithm>
+
+#include "FunctionTask.h"
+#include "MazeFileType.h"
+#include "MazeFileUtilities.h"
+
+namespace mms {
+
+int MazeConverter::run(const QString& directory) {
+
+    // Find all of the maze files that can be converted
+    QString targetSuffix = MAZE_FILE_TYPE_TO_SUFFIX().value(MazeFileType::MZB);
+    QStringList suffixes = MAZE_FILE_TYPE_TO_SUFFIX().values();
+    suffixes.removeAll(targetSuffix);
+    QStringList sources;
+    if (!findFiles(directory, suffixes, &sources)) {
+        return 1;
+    }
+
+    // Convert them all in parallel
+    QElapsedTimer timer;
+    timer.start();
+    QAtomicInt converted(0);
+    QAtomicInt failed(0);
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(QThread::idealThreadCount());
+    for (const QString& source : sources) {
+        threadPool.start(new FunctionTask([&, source]() {
+            try {
+                if (convert(source, source + "." + targetSuffix)) {
+                    converted.fetchAndAddRelaxed(1);
+                }
+            }
+            catch (const std::exception& e) {
+                failed.fetchAndAddRelaxed(1);
+                qWarning().noquote().nospace()
+                    << "Unable to convert \"" << source << "\": "
+                    << QString(e.what()) << ".";
+            }
+        }));
+    }
+    threadPool.waitForDone();
+
+    int convertedCount = converted.load();
+    int failedCount = failed.load();
+    QTextStream(stdout)
+        << "Converted " << convertedCount << " of " << sources.size()
+        << " maze files in " << timer.elapsed() / 1000.0 << " s ("
+        << sources.size() - convertedCount - failedCount << " up to date, "
+        << failedCount << " failed)\n";
+    return failedCount == 0 ? 0 : 1;
+}
+
+int MazeConverter::hash(const QString& directory) {
+
+    QStringList paths;
+    if (!findFiles(directory, MAZE_FILE_TYPE_TO_SUFFIX().values(), &paths)) {
+        return 1;
+    }
+
+    // Hash them all in parallel, each worker writing only its own slot
+    QElapsedTimer timer;
+    timer.start();
+    QVector<quint64> hashes(paths.size());
+    QVector<bool> loaded(paths.size(), false);
+    quint64* hashData = hashes.data();
+    bool* loadedData = loaded.data();
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(QThread::idealThreadCount());
+    for (int i = 0; i < paths.size(); i += 1) {
+        threadPool.start(new FunctionTask([&, i]() {
+            try {
+                hashData[i] = MazeFileUtilities::load(paths.at(i)).getCanonicalHash();
+                loadedData[i] = true;
+            }
+            catch (const std::exception& e) {
+                qWarning().noquote().nospace()
+                    << "Unable to load \"" << paths.at(i) << "\": "
+                    << QString(e.what()) << ".";
+            }
+        }));
+    }
+    threadPool.waitForDone();
+
+    QVector<QPair<quint64, QString>> results;
+    for (int i = 0; i < paths.size(); i += 1) {
+        if (loaded.at(i)) {
+            results.append({hashes.at(i), paths.at(i)});
+        }
+    }
+    std::sort(results.begin(), results.end());
+
+    QTextStream out(stdout);
+    int distinctCount = 0;
+    for (int i = 0; i < results.size(); i += 1) {
+        if (i == 0 || results.at(i).first != results.at(i - 1).first) {
+            distinctCount += 1;
+        }
+        out << QString("%1").arg(results.at(i).first, 16, 16, QChar('0'))
+            << "\t" << results.at(i).second << "\n";
+    }
+    out.flush();
+
+    // Keep the summary off of stdout, so that the listing can be piped
+    int failedCount = paths.size() - results.size();
+    QTextStream(stderr)
+        << "Hashed " << results.size() << " of " << paths.size()
+        << " maze files in " << timer.elapsed() / 1000.0 << " s ("
+        << distinctCount << " distinct, " << failedCount << " failed)\n";
+    return failedCount == 0 ? 0 : 1;
+}
+
+bool MazeConverter::findFiles(
+        const QString& directory,
+        const QStringList& suffixes,
+        QStringList* files) {
+    if (!QFileInfo(directory).isDir()) {
+        qWarning().noquote().nospace()
+            << "\"" << directory << "\" is not a directory.";
+        return false;
+    }
+    QStringList nameFilters;
+    for (const QString& suffix : suffixes) {
+        nameFilters.append(QString("*.") + suffix);
+    }
+    QDirIterator iterator(
+        directory,
+        nameFilters,
+        QDir::Files,
+        QDirIterator::Subdirectories);
+    while (iterator.hasNext()) {
+        files->append(iterator.next());
+    }
+    return true;
+}
+
+bool MazeConverter::convert(const QString& source, const QString& target) {
+    QFileInfo sourceInfo(source);
+    QFileInfo targetInfo(target);
+    if (targetInfo.exists() && sourceInfo.lastModified() <= targetInfo.lastModified()) {
+        return false;
+    }
+    MazeFileUtilities::save(
+        MazeFileUtilities::load(source),
+        target,
+        MazeFileType::MZB);
+    return true;
+}
+
+} // namespace mms
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+namespace mms {
+
+// Converts every .map, .num, .MZ2, and .MAZ file in a directory (and its
+// subdirectories) to the binary .MZB format, on all cores. Each file is
+// written next to its source, with ".mzb" appended, and files whose .MZB is
+// newer than the source are skipped, so reconverting a corpus is cheap. Can
+// also hash every maze file in a directory, to find duplicates.
+class MazeConverter {
+
+public:
+
+    // This class is not constructible
+    MazeConverter() = delete;
+
+    // Returns a process exit code
+    static int run(const QString& directory);
+
+    // Prints the canonical hash (see PackedMaze::getCanonicalHash()) and path
+    // of every maze file in the directory, sorted by hash so that copies of a
+    // maze, rotated, mirrored, or in another format, are adjacent; returns a
+    // process exit code
+    static int hash(const QString& directory);
+
+    // Lists every file in (or under) the directory with one of the given
+    // suffixes; returns false (and warns) if the directory doesn't exist
+    static bool findFiles(
+        const QString& directory,
+        const QStringList& suffixes,
+        QStringList* files);
+
+private:
+
+    // Returns whether or not the target was written (rather than skipped);
+    // throws a std::runtime_error on failure
+    static bool convert(const QString& source, const QString& target);
+};
+
+} // namespace mms
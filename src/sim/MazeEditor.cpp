@@ -0,0 +1,355 @@
+#include "MazeEditor.h"
+
+#include <algorithm>
+
+#include "Assert.h"
+#include "MazeUtilities.h"
+
+namespace mms {
+
+MazeEditor::MazeEditor(Maze* maze, MazeGraphic* graphic) :
+        m_maze(maze),
+        m_graphic(graphic),
+        m_missingBorderWalls(0),
+        m_barePosts(0),
+        m_unreachableTiles(0),
+        m_goalIsCenter(false),
+        m_wallFollowerIsStale(true),
+        m_isUnsolvableByWallFollower(false),
+        m_affected(maze->getWidth() * maze->getHeight()) {
+
+    // Edits go straight to the stored walls
+    ASSERT_TR(m_maze->getSymmetry() == MazeSymmetry::IDENTITY);
+
+    int width = m_maze->getWidth();
+    int height = m_maze->getHeight();
+    for (int x = 0; x < width; x += 1) {
+        m_missingBorderWalls += !m_maze->isWall(x, 0, Direction::SOUTH);
+        m_missingBorderWalls += !m_maze->isWall(x, height - 1, Direction::NORTH);
+    }
+    for (int y = 0; y < height; y += 1) {
+        m_missingBorderWalls += !m_maze->isWall(0, y, Direction::WEST);
+        m_missingBorderWalls += !m_maze->isWall(width - 1, y, Direction::EAST);
+    }
+    for (int x = 0; x < width - 1; x += 1) {
+        for (int y = 0; y < height - 1; y += 1) {
+            m_barePosts += isBarePost(x, y);
+        }
+    }
+    for (int i = 0; i < width * height; i += 1) {
+        m_unreachableTiles += getDistance(i) == -1;
+    }
+    QBitArray center(width * height);
+    for (const QPair<int, int>& position : MazeUtilities::getCenterPositions(width, height)) {
+        center.setBit(position.first * height + position.second);
+    }
+    m_goalIsCenter = (m_maze->m_goal == center);
+    if (0 < width && 0 < height) {
+        updateValidity();
+    }
+}
+
+bool MazeEditor::setWall(int x, int y, Direction direction, bool isWall) {
+    ASSERT_TR(m_maze->withinMaze(x, y));
+    if (m_maze->isWall(x, y, direction) == isWall) {
+        return false;
+    }
+
+    // Update the walls, along with the counts that only depend on the walls
+    // near the edited one
+    int barePosts = countBarePosts(x, y, direction);
+    m_maze->m_walls.setWall(x, y, direction, isWall);
+    m_barePosts += countBarePosts(x, y, direction) - barePosts;
+    if (isBorderWall(x, y, direction)) {
+        m_missingBorderWalls += isWall ? -1 : 1;
+    }
+    if (!m_wallFollowerIsStale && m_wallFollowerWalls.isWall(x, y, direction)) {
+        m_wallFollowerIsStale = true;
+    }
+
+    // Update the distances
+    int index = x * m_maze->getHeight() + y;
+    int neighbor = getNeighbor(x, y, direction);
+    QVector<int> changed;
+    if (neighbor != -1) {
+        changed = isWall ? closePassage(index, neighbor) : openPassage(index, neighbor);
+    }
+    updateValidity();
+
+    // Push the changes to the graphic
+    if (m_graphic != nullptr) {
+        m_graphic->refreshTile(x, y);
+        if (neighbor != -1) {
+            changed.append(neighbor);
+        }
+        for (int tile : changed) {
+            m_graphic->refreshTile(tile / m_maze->getHeight(), tile % m_maze->getHeight());
+        }
+    }
+    return true;
+}
+
+void MazeEditor::toggleWall(int x, int y, Direction direction) {
+    setWall(x, y, direction, !m_maze->isWall(x, y, direction));
+}
+
+MazeValidity MazeEditor::getValidity() const {
+    return (
+        m_maze->isOfficialMaze() ? MazeValidity::OFFICIAL :
+        m_maze->isValidMaze() ? MazeValidity::EXPLORABLE :
+        MazeValidity::DRAWABLE
+    );
+}
+
+int MazeEditor::getDistance(int index) const {
+    return m_maze->m_distances.at(index);
+}
+
+void MazeEditor::setDistance(int index, int distance) {
+    m_unreachableTiles += (distance == -1) - (getDistance(index) == -1);
+    m_maze->m_distances[index] = distance;
+}
+
+QVector<int> MazeEditor::getOpenNeighbors(int index) const {
+    int height = m_maze->getHeight();
+    int x = index / height;
+    int y = index % height;
+    QVector<int> neighbors;
+    for (Direction direction : DIRECTIONS()) {
+        if (m_maze->isWall(x, y, direction)) {
+            continue;
+        }
+        int neighbor = getNeighbor(x, y, direction);
+        if (neighbor != -1) {
+            neighbors.append(neighbor);
+        }
+    }
+    return neighbors;
+}
+
+int MazeEditor::getNeighbor(int x, int y, Direction direction) const {
+    QPair<int, int> position =
+        MazeUtilities::positionAfterMovingForward({x, y}, direction);
+    if (!m_maze->withinMaze(position.first, position.second)) {
+        return -1;
+    }
+    return position.first * m_maze->getHeight() + position.second;
+}
+
+QVector<int> MazeEditor::openPassage(int a, int b) {
+
+    // At most one side gets closer to the center, and a breadth-first search
+    // from there only reaches the tiles that get closer too
+    m_queue.clear();
+    for (QPair<int, int> pair : {qMakePair(a, b), qMakePair(b, a)}) {
+        int distance = getDistance(pair.first);
+        int other = getDistance(pair.second);
+        if (distance != -1 && (other == -1 || distance + 1 < other)) {
+            setDistance(pair.second, distance + 1);
+            m_queue.append(pair.second);
+        }
+    }
+    for (int i = 0; i < m_queue.size(); i += 1) {
+        int distance = getDistance(m_queue.at(i)) + 1;
+        for (int neighbor : getOpenNeighbors(m_queue.at(i))) {
+            int other = getDistance(neighbor);
+            if (other == -1 || distance < other) {
+                setDistance(neighbor, distance);
+                m_queue.append(neighbor);
+            }
+        }
+    }
+    return m_queue;
+}
+
+QVector<int> MazeEditor::closePassage(int a, int b) {
+
+    // Nothing changes unless the passage was on a shortest path, i.e., unless
+    // the farther tile has no other neighbor that's one step closer
+    int distanceA = getDistance(a);
+    int distanceB = getDistance(b);
+    if (distanceA == -1 || distanceB == -1 || qAbs(distanceA - distanceB) != 1) {
+        return {};
+    }
+    auto hasSupport = [&](int tile) {
+        for (int neighbor : getOpenNeighbors(tile)) {
+            if (!m_affected.testBit(neighbor) &&
+                    getDistance(neighbor) == getDistance(tile) - 1) {
+                return true;
+            }
+        }
+        return false;
+    };
+    int farther = distanceA < distanceB ? b : a;
+    if (hasSupport(farther)) {
+        return {};
+    }
+
+    // Find every tile whose shortest paths all went through the passage.
+    // Tiles are visited in order of distance, so all of a tile's closer
+    // neighbors have been classified by the time the tile is.
+    m_queue.clear();
+    m_queue.append(farther);
+    m_affected.setBit(farther);
+    for (int i = 0; i < m_queue.size(); i += 1) {
+        int tile = m_queue.at(i);
+        for (int neighbor : getOpenNeighbors(tile)) {
+            if (!m_affected.testBit(neighbor) &&
+                    getDistance(neighbor) == getDistance(tile) + 1 &&
+                    !hasSupport(neighbor)) {
+                m_affected.setBit(neighbor);
+                m_queue.append(neighbor);
+            }
+        }
+    }
+
+    // Each affected tile starts from its best unaffected neighbor, if any
+    QVector<int> oldDistances;
+    for (int tile : m_queue) {
+        oldDistances.append(getDistance(tile));
+        setDistance(tile, -1);
+    }
+    m_seeds.clear();
+    for (int tile : m_queue) {
+        int best = -1;
+        for (int neighbor : getOpenNeighbors(tile)) {
+            int distance = getDistance(neighbor);
+            if (!m_affected.testBit(neighbor) && distance != -1 &&
+                    (best == -1 || distance + 1 < best)) {
+                best = distance + 1;
+            }
+        }
+        if (best != -1) {
+            m_seeds.append({best, tile});
+        }
+    }
+    std::sort(m_seeds.begin(), m_seeds.end());
+
+    // Then it's a breadth-first search within the affected tiles, with the
+    // seeds merged in (by distance) as the search reaches them
+    QVector<int> relaxed;
+    int seedIndex = 0;
+    int relaxedIndex = 0;
+    while (seedIndex < m_seeds.size() || relaxedIndex < relaxed.size()) {
+        int tile = -1;
+        if (relaxedIndex == relaxed.size() || (
+                seedIndex < m_seeds.size() &&
+                m_seeds.at(seedIndex).first <= getDistance(relaxed.at(relaxedIndex)))) {
+            int distance = m_seeds.at(seedIndex).first;
+            tile = m_seeds.at(seedIndex).second;
+            seedIndex += 1;
+            if (getDistance(tile) != -1 && getDistance(tile) <= distance) {
+                continue;
+            }
+            setDistance(tile, distance);
+        }
+        else {
+            tile = relaxed.at(relaxedIndex);
+            relaxedIndex += 1;
+        }
+        int distance = getDistance(tile) + 1;
+        for (int neighbor : getOpenNeighbors(tile)) {
+            int other = getDistance(neighbor);
+            if (m_affected.testBit(neighbor) && (other == -1 || distance < other)) {
+                setDistance(neighbor, distance);
+                relaxed.append(neighbor);
+            }
+        }
+    }
+
+    QVector<int> changed;
+    for (int i = 0; i < m_queue.size(); i += 1) {
+        m_affected.clearBit(m_queue.at(i));
+        if (getDistance(m_queue.at(i)) != oldDistances.at(i)) {
+            changed.append(m_queue.at(i));
+        }
+    }
+    return changed;
+}
+
+bool MazeEditor::isBarePost(int x, int y) const {
+    int width = m_maze->getWidth();
+    int height = m_maze->getHeight();
+    if (x < 0 || width - 1 <= x || y < 0 || height - 1 <= y) {
+        return false;
+    }
+    const auto& centerPositions = MazeUtilities::getCenterPositions(width, height);
+    if (centerPositions.size() == 4 &&
+            qMakePair(x, y) == MazeUtilities::getMinPosition(centerPositions)) {
+        return false;
+    }
+    return !(
+        m_maze->isWall(x, y, Direction::NORTH) ||
+        m_maze->isWall(x, y, Direction::EAST) ||
+        m_maze->isWall(x + 1, y + 1, Direction::SOUTH) ||
+        m_maze->isWall(x + 1, y + 1, Direction::WEST)
+    );
+}
+
+int MazeEditor::countBarePosts(int x, int y, Direction direction) const {
+    // Name the wall by the tile to its south or west
+    if (direction == Direction::SOUTH) {
+        y -= 1;
+        direction = Direction::NORTH;
+    }
+    else if (direction == Direction::WEST) {
+        x -= 1;
+        direction = Direction::EAST;
+    }
+    if (direction == Direction::NORTH) {
+        return isBarePost(x - 1, y) + isBarePost(x, y);
+    }
+    return isBarePost(x, y - 1) + isBarePost(x, y);
+}
+
+bool MazeEditor::isBorderWall(int x, int y, Direction direction) const {
+    switch (direction) {
+        case Direction::NORTH:
+            return y == m_maze->getHeight() - 1;
+        case Direction::EAST:
+            return x == m_maze->getWidth() - 1;
+        case Direction::SOUTH:
+            return y == 0;
+        case Direction::WEST:
+            return x == 0;
+    }
+    return false;
+}
+
+void MazeEditor::updateValidity() {
+
+    // The cheap rules come first, so the wall follower is only walked (and
+    // then only if a wall it looked at changed) when it could matter. With a
+    // hollow center as the goal, every tile has a distance if and only if
+    // it's reachable from the start; any other goal may be split among parts
+    // of the maze that the start can't reach, so reachability is checked
+    // directly instead.
+    const PackedMaze& walls = m_maze->m_walls;
+    bool explorable = (
+        m_missingBorderWalls == 0 &&
+        walls.hasConsistentWalls()
+    );
+    auto isUnsolvableByWallFollower = [&]() {
+        if (m_wallFollowerIsStale) {
+            m_isUnsolvableByWallFollower =
+                MazeChecker::checkWallFollower(walls, &m_wallFollowerWalls);
+            m_wallFollowerIsStale = false;
+        }
+        return m_isUnsolvableByWallFollower;
+    };
+    bool official = (
+        explorable &&
+        m_barePosts == 0 &&
+        MazeChecker::checkRule(walls, MazeRule::THREE_STARTING_WALLS) &&
+        MazeChecker::checkRule(walls, MazeRule::ONE_ENTRANCE_TO_CENTER) &&
+        MazeChecker::checkRule(walls, MazeRule::HOLLOW_CENTER) &&
+        (m_goalIsCenter
+            ? m_unreachableTiles == 0
+            : MazeChecker::checkRule(walls, MazeRule::NO_INACCESSIBLE_LOCATIONS)) &&
+        isUnsolvableByWallFollower()
+    );
+    m_maze->m_isValidMaze = explorable;
+    m_maze->m_isOfficialMaze = official;
+}
+
+} // namespace mms
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QBitArray>
+#include <QPair>
+#include <QVector>
+
+#include "Direction.h"
+#include "Maze.h"
+#include "MazeChecker.h"
+#include "MazeGraphic.h"
+#include "PackedMaze.h"
+
+namespace mms {
+
+// Edits a maze in place, one wall at a time. Rather than rebuilding the maze,
+// each edit updates only what it can affect: distances to the center change
+// by a dynamic shortest-path update that's bounded by the tiles whose
+// distances actually change, and each validity rule is kept as a running
+// count or re-checked only if the edited wall could have changed it. The
+// changed tiles are pushed straight to the graphic, if there is one.
+class MazeEditor {
+
+public:
+
+    // The maze must not be edited while a mouse is running in it, and it
+    // can't be a symmetric view of another maze
+    MazeEditor(Maze* maze, MazeGraphic* graphic);
+
+    // Returns whether or not the wall changed; walls on the edge of the maze
+    // may be edited too, but they don't change any distances
+    bool setWall(int x, int y, Direction direction, bool isWall);
+    void toggleWall(int x, int y, Direction direction);
+
+    MazeValidity getValidity() const;
+
+private:
+
+    // No ownership here - only pointers
+    Maze* m_maze;
+    MazeGraphic* m_graphic;
+
+    // Running counts for the rules that depend on the whole maze
+    int m_missingBorderWalls;
+    int m_barePosts;
+    int m_unreachableTiles;
+
+    // Whether the goal is the center, in which case (with a hollow center)
+    // a tile has a distance if and only if it's reachable from the start
+    bool m_goalIsCenter;
+
+    // The outcome of the last wall follower walk, and the walls it looked
+    // at; it's only walked again when one of those walls changes
+    bool m_wallFollowerIsStale;
+    bool m_isUnsolvableByWallFollower;
+    PackedMaze m_wallFollowerWalls;
+
+    // Scratch space for the distance update, kept between edits so that an
+    // edit doesn't allocate anything proportional to the maze
+    QBitArray m_affected;
+    QVector<int> m_queue;
+    QVector<QPair<int, int>> m_seeds;
+
+    int getDistance(int index) const;
+    void setDistance(int index, int distance);
+
+    // The tiles across from the tile that aren't walled off
+    QVector<int> getOpenNeighbors(int index) const;
+
+    // Edge tiles may be walled on the outside of the maze, in which case the
+    // neighbor is -1
+    int getNeighbor(int x, int y, Direction direction) const;
+
+    // Distances can only shrink when a passage opens, and only grow when one
+    // closes; both return the tiles whose distances changed
+    QVector<int> openPassage(int a, int b);
+    QVector<int> closePassage(int a, int b);
+
+    // Posts are named by the tile to their southwest; only interior posts,
+    // other than the center post, need a wall attached. countBarePosts()
+    // looks at the two posts at the ends of the given wall.
+    bool isBarePost(int x, int y) const;
+    int countBarePosts(int x, int y, Direction direction) const;
+    bool isBorderWall(int x, int y, Direction direction) const;
+
+    void updateValidity();
+};
+
+} // namespace mms
@@ -9,6 +9,7 @@ const QMap<MazeFileType, QString>& MAZE_FILE_TYPE_TO_STRING() {
         {MazeFileType::MAP, "MAP"},
         {MazeFileType::MAZ, "MAZ"},
         {MazeFileType::MZ2, "MZ2"},
+        {MazeFileType::MZB, "MZB"},
         {MazeFileType::NUM, "NUM"},
     };
     return map;
@@ -25,6 +26,7 @@ const QMap<MazeFileType, QString>& MAZE_FILE_TYPE_TO_SUFFIX() {
         {MazeFileType::MAP, "map"},
         {MazeFileType::MAZ, "MAZ"},
         {MazeFileType::MZ2, "MZ2"},
+        {MazeFileType::MZB, "mzb"},
         {MazeFileType::NUM, "num"},
     };
     return map;
@@ -32,7 +34,7 @@ const QMap<MazeFileType, QString>& MAZE_FILE_TYPE_TO_SUFFIX() {
 
 const QMap<QString, MazeFileType>& SUFFIX_TO_MAZE_FILE_TYPE() {
     static const QMap<QString, MazeFileType> map =
-        ContainerUtilities::inverse(MAZE_FILE_TYPE_TO_STRING());
+        ContainerUtilities::inverse(MAZE_FILE_TYPE_TO_SUFFIX());
     return map;
 }
 
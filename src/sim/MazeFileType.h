@@ -12,6 +12,8 @@ enum class MazeFileType {
     MAP,
     MAZ,
     MZ2,
+    // The simulator's own binary format; see MazeFileUtilities
+    MZB,
     NUM,
 };
 
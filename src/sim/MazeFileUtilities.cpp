@@ -1,322 +1,296 @@
 #include "MazeFileUtilities.h"
 
-#include <QChar>
+#include <QBitArray>
 #include <QFile>
+#include <QPair>
+#include <QSaveFile>
 #include <QString>
+#include <QVector>
+#include <QtEndian>
 
-#include "Logging.h"
-#include "MazeChecker.h"
-#include "SimUtilities.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "MazeUtilities.h"
 
 namespace mms {
 
-BasicMaze MazeFileUtilities::load(const QString& path) {
+// The layout of a .MZB file, in which every field is little-endian:
+//
+//      offset  size    field
+//      0       8       magic number
+//      8       4       version
+//      12      4       width
+//      16      4       height
+//      20      4       validity (a MazeValidity)
+//      24      4       flags (bit 0: the walls were consistent)
+//      28      4       reserved
+//      32      8       hash of the walls (PackedMaze::getHash)
+//      40      ...     horizontal wall words, then vertical wall words (in
+//                      the layout of PackedMaze), then the distance of each
+//                      tile to the center (as in MazeMetadata), as 32-bit
+//                      signed integers
+//
+// Everything a Maze computes when it's constructed is stored, so loading
+// one is a matter of copying words out of the (mapped) file.
+static const char MZB_MAGIC[8] = {'\x89', 'M', 'Z', 'B', '\r', '\n', '\x1a', '\n'};
+static const quint32 MZB_VERSION = 1;
+static const int MZB_HEADER_SIZE = 40;
+
+PackedMaze MazeFileUtilities::load(const QString& path, MazeMetadata* metadata) {
     QFile file(path);
-    // TODO: MACK - replace with QFile::exists
     if (!file.open(QIODevice::ReadOnly)) {
-        throw std::runtime_error("file doesn't exist");
+        throw std::runtime_error("unable to open the file");
+    }
+    if (std::numeric_limits<int>::max() < file.size()) {
+        throw std::runtime_error("the file is too large");
     }
-    return loadBytes(file.readAll());
-}
 
-BasicMaze MazeFileUtilities::loadBytes(const QByteArray& bytes) {
-
-    // Since we don't know anything about the file type ahead of time, we
-    // simply brute force try each of the file types until either one succeeds
-    // or they all fail
-
-    #define TRY(expression, validate)\
-    try {\
-        BasicMaze maze = expression;\
-        MazeValidity validity = MazeChecker::checkMaze(maze);\
-        if (validity != MazeValidity::INVALID) {\
-            if (\
-                !validate ||\
-                validity == MazeValidity::EXPLORABLE ||\
-                validity == MazeValidity::OFFICIAL\
-            ) {\
-                return maze;\
-            }\
-        }\
-    }\
-    catch (...) { }
-
-    TRY(deserializeMazType(bytes), true);
-    TRY(deserializeMz2Type(bytes), true);
-    TRY(deserializeNumType(bytes), true);
-    TRY(deserializeMapType(bytes), false);
-    throw std::runtime_error("invalid format");
+    // Parse the file where it lies rather than copying it into memory. The
+    // mapping is released when the file is closed. Not every file can be
+    // mapped (e.g., empty files and pipes), so fall back to reading those.
+    uchar* data = (file.size() == 0 ? nullptr : file.map(0, file.size()));
+    if (data == nullptr) {
+        return loadBytes(file.readAll(), metadata);
+    }
+    return loadBytes(
+        QByteArray::fromRawData(
+            reinterpret_cast<const char*>(data),
+            static_cast<int>(file.size())),
+        metadata);
 }
 
-void MazeFileUtilities::save(
-    const BasicMaze& maze,
-    const QString& path,
-    MazeFileType type) {
-
-    // TODO: MACK - should throw exception
-    QByteArray bytes;
-    switch (type) {
-        case MazeFileType::MAP:
-            bytes = serializeMapType(maze);
+PackedMaze MazeFileUtilities::loadBytes(
+        const QByteArray& bytes,
+        MazeMetadata* metadata) {
+    if (metadata != nullptr) {
+        *metadata = MazeMetadata();
+    }
+    switch (detectType(bytes)) {
         case MazeFileType::MAZ:
-            bytes = serializeMazType(maze);
+            return deserializeMazType(bytes);
         case MazeFileType::MZ2:
-            bytes = serializeMz2Type(maze);
+            return deserializeMz2Type(bytes);
+        case MazeFileType::MZB:
+            return deserializeMzbType(bytes, metadata);
         case MazeFileType::NUM:
-            bytes = serializeNumType(maze);
-        default:
-            // TODO: MACK
-            SimUtilities::quit();
+            return deserializeNumType(bytes);
+        case MazeFileType::MAP:
+            break;
     }
-    // TODO: MACK - write to file
+    return deserializeMapType(bytes);
 }
 
-BasicMaze MazeFileUtilities::deserializeMapType(const QByteArray& bytes) {
+MazeFileType MazeFileUtilities::detectType(const QByteArray& bytes) {
 
-    // First, convert the bytes to lines
-    QStringList lines = SimUtilities::splitLines(QString(bytes).trimmed());
-
-    // The maze to be returned
-    BasicMaze upsideDownMaze;
-
-    // The character representing a maze post
-    QChar delimiter('\0');
-
-    // The number of horizontal spaces between columns
-    QVector<int> spaces;
-
-    // Keep track of what row of the maze we're reading
-    int rowsFromTopOfMaze = -1;
+    // .MZB files start with a magic number
+    if (bytes.startsWith(QByteArray(MZB_MAGIC, sizeof(MZB_MAGIC)))) {
+        return MazeFileType::MZB;
+    }
 
-    // Iterate over all of the lines
-    for (int i = 0; i < lines.size(); i += 1) {
-        QString line = lines.at(i);
+    // .MAZ files are exactly one byte per tile of a 16x16 maze, and only the
+    // lower four bits of each byte are used
+    if (bytes.size() == 256 && std::all_of(
+            bytes.constData(),
+            bytes.constData() + bytes.size(),
+            [](char byte) { return (byte & 0xF0) == 0; })) {
+        return MazeFileType::MAZ;
+    }
 
-        // Special case for the first line of the file
-        if (i == 0) {
-            if (line.size() == 0) {
-                // TODO: MACK - clean this up
-                throw std::runtime_error("Invalid first line");
-            }
-            delimiter = line.at(0);
-            QStringList tokens = line.split(delimiter, QString::SkipEmptyParts);
-            for (int j = 0; j < tokens.size(); j += 1) {
-                QVector<BasicTile> column;
-                upsideDownMaze.push_back(column);
-                spaces.push_back(tokens.at(j).size());
-            }
+    // .MZ2 files start with the high nibble of the length of the maze's
+    // name, which is never printable. It may well be a tab, newline, or
+    // carriage return, though, as may the start of a text file, so the
+    // header has to agree with the size of the data too.
+    if (!bytes.isEmpty()) {
+        char first = bytes.at(0);
+        if (0 <= first && first < 0x10 && hasMz2Size(bytes)) {
+            return MazeFileType::MZ2;
         }
+    }
 
-        // Extract horizontal wall info, tiles structs don't already exist
-        if (line.at(0) == delimiter) {
-            rowsFromTopOfMaze += 1;
-            int position = (spaces.at(0) + 1) / 2; // Center of the wall
-            for (int j = 0; j < spaces.size(); j += 1) {
-                if (line.size() <= position) {
-                    break;
-                }
-                BasicTile tile;
-                for (Direction direction : DIRECTIONS()) {
-                    tile.insert(direction, false);
-                }
-                upsideDownMaze[j].push_back(tile);
-                if (0 < spaces.at(j)) {
-                    bool isWall = line.at(position) != ' ';
-                    upsideDownMaze[j][rowsFromTopOfMaze][Direction::NORTH] = isWall;
-                    if (0 < rowsFromTopOfMaze) {
-                        upsideDownMaze[j][rowsFromTopOfMaze - 1][Direction::SOUTH] = isWall;
-                    }
-                }
-                if (j < spaces.size() - 1) {
-                    position += 1 + spaces.at(j) / 2; // Position of the next corner
-                    position += (spaces.at(j + 1) + 1) / 2; // Center of the wall
-                }
-            }
+    // The text formats: .NUM files start with a tile's coordinates, and
+    // .MAP files start with a post
+    for (char byte : bytes) {
+        if (byte == ' ' || byte == '\t' || byte == '\n' || byte == '\r') {
+            continue;
         }
-
-        // Extract vertical wall info, tiles structs already exist
-        else if (lines.at(i - 1).at(0) == delimiter) {
-            int position = 0;
-            for (int j = 0; j <= spaces.size(); j += 1) {
-                if (line.size() <= position) {
-                    break;
-                }
-                bool isWall = line.at(position) != ' ';
-                if (0 < j) {
-                    upsideDownMaze[j - 1][rowsFromTopOfMaze][Direction::EAST] = isWall;
-                }
-                if (j < spaces.size()) {
-                    upsideDownMaze[j][rowsFromTopOfMaze][Direction::WEST] = isWall;
-                    position += spaces.at(j) + 1;
-                }
-            }
+        if (('0' <= byte && byte <= '9') || byte == '-') {
+            return MazeFileType::NUM;
         }
+        return MazeFileType::MAP;
     }
+    throw std::runtime_error("the maze data is empty");
+}
 
-    // Strip off of the last extraneous row
-    for (int i = 0; i < upsideDownMaze.size(); i += 1) {
-        upsideDownMaze[i].pop_back();
-    }
-
-    // Flip the maze so that it's right side up
-    BasicMaze rightSideUpMaze;
-    for (int i = 0; i < upsideDownMaze.size(); i += 1) {
-        QVector<BasicTile> column;
-        for (int j = upsideDownMaze.at(i).size() - 1; j >= 0; j -= 1) {
-            column.push_back(upsideDownMaze.at(i).at(j));
-        }
-        rightSideUpMaze.push_back(column);
+void MazeFileUtilities::save(
+        const PackedMaze& maze,
+        const QString& path,
+        MazeFileType type) {
+    QByteArray bytes = saveBytes(maze, type);
+    // Written to a temporary file that replaces the target only once it's
+    // complete, so that a failed or interrupted save leaves no partial file
+    // (which, being newer than its source, would never be rewritten)
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        throw std::runtime_error("unable to open the file for writing");
+    }
+    if (file.write(bytes) != bytes.size()) {
+        file.cancelWriting();
+        throw std::runtime_error("unable to write the file");
+    }
+    if (!file.commit()) {
+        throw std::runtime_error("unable to write the file");
     }
-
-    return rightSideUpMaze;
 }
 
-BasicMaze MazeFileUtilities::deserializeMazType(const QByteArray& bytes) {
-
-    // TODO: MACK - QVector aborts the application without this
-    throw std::runtime_error("MACK");
-
-    // TODO: MACK Convert this to use Qt
-    QVector<char> characters;
-    for (int i = 0; i < bytes.size(); i += 1) {
-        characters.push_back(bytes.at(i));
+QByteArray MazeFileUtilities::saveBytes(const PackedMaze& maze, MazeFileType type) {
+    if (maze.getWidth() == 0 || maze.getHeight() == 0) {
+        throw std::runtime_error("the maze is empty");
     }
-    
-    // The maze to be returned
-    BasicMaze maze;
-
-    // This maze file format is written to only accomodate 16x16 mazes
-    // We can hardcode this becuase all the load functions run in try blocks
-    for (int x = 0; x < 16; x += 1) {
-        QVector<BasicTile> column;
-        for (int y = 0; y < 16; y += 1) {
-            int walls = characters.at(x * 16 + y);
-            BasicTile tile;
-            //Each byte reprsents the walls like this: 'X X X X W S E N'
-            tile[Direction::WEST]  = (walls & 1 << 3) != 0;
-            tile[Direction::SOUTH] = (walls & 1 << 2) != 0;
-            tile[Direction::EAST]  = (walls & 1 << 1) != 0;
-            tile[Direction::NORTH] = (walls & 1 << 0) != 0;
-            column.push_back(tile);
-        }
-        maze.push_back(column);
+    switch (type) {
+        case MazeFileType::MAZ:
+            return serializeMazType(maze);
+        case MazeFileType::MZ2:
+            return serializeMz2Type(maze);
+        case MazeFileType::MZB:
+            return serializeMzbType(maze);
+        case MazeFileType::NUM:
+            return serializeNumType(maze);
+        case MazeFileType::MAP:
+            break;
     }
-
-    return maze;
+    return serializeMapType(maze);
 }
 
-BasicMaze MazeFileUtilities::deserializeMz2Type(const QByteArray& bytes) {
-
-    // TODO: Convert this to use Qt
-    QVector<char> characters;
-    for (int i = 0; i < bytes.size(); i += 1) {
-        characters.push_back(bytes.at(i));
-    }
-
-    // Reverse the vector order so we can pop back for the next character
-    std::reverse(characters.begin(), characters.end());
-
-    // Why oh why can't cant iterators throw exceptions when derefrencing to invalid locations
-    // Pop back and get popped element
-    auto getPopBack = [](QVector<char>* v) {if(v->size()==0){throw std::exception();}
-                                                      auto e = v->back();
-                                                      v->pop_back();
-                                                      return e;};
-
-    uint32_t stringLength = (getPopBack(&characters) << 4) +
-                             getPopBack(&characters);
-
-    QString mazeName; // The title is not used, but here if needed
-                          // It is a UTF-8 formatted sring
-
-    if (stringLength != 0) {
-        while (stringLength != 0) {
-            unsigned char character = getPopBack(&characters);
-            mazeName += character;
-            if (character >> 7 == 0 ||
-                character >> 6 == 3) { // 11 in binary
-                // This is a utf-8 formated string.  Only decrement the counter
-                // if it is the first character of a sequence.
-                stringLength--;
+PackedMaze MazeFileUtilities::deserializeMapType(const QByteArray& bytes) {
+
+    //  +---+---+---+     The first non-blank line is the northern edge of
+    //  |           |     the maze. Its first character is the post, and the
+    //  +   +---+   +     other posts on that line determine the columns. Each
+    //  |   |       |     later line that starts with a post holds horizontal
+    //  +---+---+---+     walls, at the center of each column, and the line
+    //                    right after it holds vertical walls, at the posts.
+
+    // Index the lines, without their line endings
+    const char* data = bytes.constData();
+    int size = bytes.size();
+    QVector<QPair<int, int>> lines;
+    for (int start = 0; start < size;) {
+        const char* newline = static_cast<const char*>(
+            std::memchr(data + start, '\n', size - start));
+        int end = (newline == nullptr ? size : static_cast<int>(newline - data));
+        int next = end + 1;
+        if (start < end && data[end - 1] == '\r') {
+            end -= 1;
+        }
+        lines.append({start, end});
+        start = next;
+    }
+
+    // Characters beyond the end of a line are treated as spaces, since
+    // trailing whitespace is often stripped
+    auto lineLength = [&](int line) {
+        return lines.at(line).second - lines.at(line).first;
+    };
+    auto charAt = [&](int line, int column) {
+        return column < lineLength(line) ? data[lines.at(line).first + column] : ' ';
+    };
+
+    // Find the first row of posts
+    int first = 0;
+    while (
+        first < lines.size() &&
+        std::all_of(
+            data + lines.at(first).first,
+            data + lines.at(first).second,
+            [](char c) { return c == ' ' || c == '\t'; })
+    ) {
+        first += 1;
+    }
+    if (first == lines.size()) {
+        throw textError(first + 1, 1, "expected a row of posts");
+    }
+
+    // Whitespace before the first post is skipped, as though the text had
+    // been trimmed
+    while (data[lines.at(first).first] == ' ' || data[lines.at(first).first] == '\t') {
+        lines[first].first += 1;
+    }
+    char post = charAt(first, 0);
+
+    // Determine the columns from the posts of the first row; a missing
+    // final post is implied by the end of the line
+    QVector<int> postColumns {0};
+    for (int column = 1; column < lineLength(first); column += 1) {
+        if (charAt(first, column) == post) {
+            if (postColumns.last() + 1 < column) {
+                postColumns.append(column);
+            }
+            else {
+                postColumns.last() = column;
             }
         }
     }
-
-    uint32_t width = (getPopBack(&characters) << 24) +
-                     (getPopBack(&characters) << 16) +
-                     (getPopBack(&characters) << 8) +
-                     (getPopBack(&characters));
-
-    uint32_t height = (getPopBack(&characters) << 24) +
-                      (getPopBack(&characters) << 16) +
-                      (getPopBack(&characters) << 8) +
-                      (getPopBack(&characters));
-    
-    // Let's make sure we do not read a massive size and go on forerver
-    if (width > 256 || height > 256) {
-        throw std::exception();
+    if (postColumns.last() + 1 < lineLength(first)) {
+        postColumns.append(lineLength(first));
+    }
+    int width = postColumns.size() - 1;
+    if (width < 1) {
+        throw textError(first + 1, lineLength(first) + 1, "expected at least one column");
+    }
+    QVector<int> wallColumns;
+    for (int x = 0; x < width; x += 1) {
+        wallColumns.append(postColumns.at(x) + (postColumns.at(x + 1) - postColumns.at(x)) / 2);
     }
 
-    BasicMaze maze;
-
-    for (auto x = 0; x < width; x++) {
-        QVector<BasicTile> column;
-        for (auto y = 0; y < height; y++) {
-            BasicTile tile;
-            for (Direction direction : DIRECTIONS()) {
-                // Make a filled maze so we get the maze border for free
-                // and don't need any special logic to make it happen
-                tile.insert(direction, true);
+    // Find the other rows of posts
+    QVector<int> postLines;
+    for (int line = first; line < lines.size(); line += 1) {
+        if (0 < lineLength(line) && charAt(line, 0) == post) {
+            if (lineLength(line) <= wallColumns.last()) {
+                throw textError(
+                    line + 1,
+                    lineLength(line) + 1,
+                    QString("expected %1 columns").arg(width));
             }
-            column.push_back(tile);
+            postLines.append(line);
         }
-        maze.push_back(column);
     }
-
-    int numberOfBits = 0;
-    int numberOfBytes = 0;
-    unsigned char byte = getPopBack(&characters);
-
-    for (auto y = 0; y < height - 1; y++) {
-        for (auto x = 0; x < width; x++) {
-            bool wallExists = (byte & 1) == 1;
-            byte >>= 1;
-
-            maze[x][height - 1 - y][Direction::SOUTH] = wallExists;
-            maze[x][height - 1 - y - 1][Direction::NORTH] = wallExists;
-
-            numberOfBits = (numberOfBits + 1) % 8;
-
-            if (numberOfBits == 0) {
-                byte = getPopBack(&characters);
-                numberOfBytes = (numberOfBytes + 1) % 8; // Add one to the number of bytes
+    int height = postLines.size() - 1;
+    if (height < 1) {
+        throw textError(
+            lines.size(),
+            lineLength(lines.size() - 1) + 1,
+            "expected a second row of posts");
+    }
+
+    // The lines run from north to south
+    PackedMaze maze(width, height);
+    for (int row = 0; row <= height; row += 1) {
+        int line = postLines.at(row);
+        int y = height - 1 - row;
+        for (int x = 0; x < width; x += 1) {
+            if (charAt(line, wallColumns.at(x)) != ' ') {
+                if (row < height) {
+                    maze.setWall(x, y, Direction::NORTH, true);
+                }
+                else {
+                    maze.setWall(x, 0, Direction::SOUTH, true);
+                }
             }
         }
-    }
-
-    if (numberOfBytes != 0) {
-        for (auto i = 0; i < (7 - numberOfBytes); i += 1) {
-            getPopBack(&characters); // Padding so the number of bytes is a muliple of 8
+        if (row == height || line + 1 == postLines.at(row + 1)) {
+            continue;
         }
-        numberOfBytes = 0;
-    }
-    numberOfBits = 0;
-
-    byte = getPopBack(&characters);
-
-    for (auto x = 0; x < width - 1; x++) {
-        for (auto y = 0; y < height; y++) {
-            bool wallExists = (byte & 1) == 1;
-            byte >>= 1;
-
-            maze[x][height - 1 - y][Direction::EAST] = wallExists;
-            maze[x + 1][height - 1 - y][Direction::WEST] = wallExists;
-            
-            numberOfBits = (numberOfBits + 1) % 8;
-
-            if (numberOfBits == 0) {
-                byte = getPopBack(&characters);
-                numberOfBytes = (numberOfBytes + 1) % 8; // Add one to the number of bytes
+        for (int x = 0; x <= width; x += 1) {
+            if (charAt(line + 1, postColumns.at(x)) != ' ') {
+                if (x < width) {
+                    maze.setWall(x, y, Direction::WEST, true);
+                }
+                else {
+                    maze.setWall(width - 1, y, Direction::EAST, true);
+                }
             }
         }
     }
@@ -324,325 +298,492 @@ BasicMaze MazeFileUtilities::deserializeMz2Type(const QByteArray& bytes) {
     return maze;
 }
 
-BasicMaze MazeFileUtilities::deserializeNumType(const QByteArray& bytes) {
-
-    // The maze to be returned
-    BasicMaze maze;
-
-    // The column to be appended
-    QVector<BasicTile> column;
-
-    // Iterate over all of the lines
-    QStringList lines = SimUtilities::splitLines(QString(bytes).trimmed());
-    for (QString line : lines) {
+PackedMaze MazeFileUtilities::deserializeMazType(const QByteArray& bytes) {
+
+    // This format only accommodates 16x16 mazes. Each byte is a tile, in
+    // column-major order, with walls 'X X X X W S E N'.
+    if (bytes.size() != 256) {
+        throw binaryError(qMin(bytes.size(), 256), "expected exactly 256 bytes");
+    }
+    // The bits already match the layout of the packed store's tile walls,
+    // so decoding is a masked copy. The unused bits are OR-ed together so
+    // that the loop doesn't branch, and are only examined afterward.
+    const quint8* data = reinterpret_cast<const quint8*>(bytes.constData());
+    QVector<quint8> tileWalls(256);
+    quint8* walls = tileWalls.data();
+    quint8 unused = 0;
+    for (int i = 0; i < 256; i += 1) {
+        unused |= data[i];
+        walls[i] = data[i] & 0xF;
+    }
+    if (unused & 0xF0) {
+        for (int i = 0; i < 256; i += 1) {
+            if (data[i] & 0xF0) {
+                throw binaryError(i, "expected a value below 16");
+            }
+        }
+    }
+    return PackedMaze::fromTileWalls(16, 16, tileWalls);
+}
 
-        // Put the tokens in a vector
-        QStringList tokens = line.split(" ", QString::SkipEmptyParts);
-        if (tokens.size() < 6) {
-            throw std::runtime_error("Not enough tokens");
+PackedMaze MazeFileUtilities::deserializeMz2Type(const QByteArray& bytes) {
+
+    const uchar* data = reinterpret_cast<const uchar*>(bytes.constData());
+    int size = bytes.size();
+    int width = 0;
+    int height = 0;
+    int offset = readMz2Header(bytes, &width, &height);
+
+    // Next are the bits of the walls between rows, from north to south and
+    // west to east, and then those between columns, from west to east and
+    // north to south; the border walls are implied. Both sections are
+    // padded, but the padding of the last one is optional.
+    qint64 horizontalBytes =
+        getMz2SectionSize(static_cast<qint64>(width) * (height - 1));
+    qint64 verticalBits = static_cast<qint64>(width - 1) * height;
+    qint64 verticalBytes = (verticalBits + 7) / 8;
+    if (size < offset + horizontalBytes + verticalBytes) {
+        throw binaryError(size, QString("expected %1 bytes of walls for a %2x%3 maze")
+            .arg(horizontalBytes + verticalBytes).arg(width).arg(height));
+    }
+    auto bitAt = [&](qint64 start, qint64 index) {
+        return ((data[start + index / 8] >> (index % 8)) & 1) == 1;
+    };
+
+    PackedMaze maze(width, height);
+    for (int x = 0; x < width; x += 1) {
+        maze.setWall(x, 0, Direction::SOUTH, true);
+        maze.setWall(x, height - 1, Direction::NORTH, true);
+    }
+    for (int y = 0; y < height; y += 1) {
+        maze.setWall(0, y, Direction::WEST, true);
+        maze.setWall(width - 1, y, Direction::EAST, true);
+    }
+    for (int row = 0; row < height - 1; row += 1) {
+        for (int x = 0; x < width; x += 1) {
+            if (bitAt(offset, row * width + x)) {
+                maze.setWall(x, height - 1 - row, Direction::SOUTH, true);
+            }
         }
-        for (const QString& token : tokens) {
-            if (!SimUtilities::isInt(token)) {
-                throw std::runtime_error("Non-numeric token");
+    }
+    offset += horizontalBytes;
+    for (int x = 0; x < width - 1; x += 1) {
+        for (int row = 0; row < height; row += 1) {
+            if (bitAt(offset, x * height + row)) {
+                maze.setWall(x, height - 1 - row, Direction::EAST, true);
             }
         }
+    }
 
-        // Fill the BasicTile object with the values
-        BasicTile tile;
-        for (Direction direction : DIRECTIONS()) {
-            QString num = tokens.at(2 + DIRECTIONS().indexOf(direction));
-            tile.insert(
-                direction,
-                SimUtilities::strToInt(num) == 1
-            );
-        }
+    return maze;
+}
 
-        // If the tile belongs to a new column,
-        // append the current column and empty it
-        if (maze.size() < SimUtilities::strToInt(tokens.at(0))) {
-            maze.push_back(column);
-            column.clear();
+PackedMaze MazeFileUtilities::deserializeMzbType(
+        const QByteArray& bytes,
+        MazeMetadata* metadata) {
+
+    const uchar* data = reinterpret_cast<const uchar*>(bytes.constData());
+    int size = bytes.size();
+    if (size < MZB_HEADER_SIZE) {
+        throw binaryError(size, "unexpected end of header");
+    }
+    quint32 version = qFromLittleEndian<quint32>(data + 8);
+    if (version != MZB_VERSION) {
+        throw binaryError(8, QString("unsupported version %1").arg(version));
+    }
+    quint32 width = qFromLittleEndian<quint32>(data + 12);
+    quint32 height = qFromLittleEndian<quint32>(data + 16);
+    if (width < 1 || 32768 < width || height < 1 || 32768 < height) {
+        throw binaryError(12, QString("invalid maze size %1x%2").arg(width).arg(height));
+    }
+    quint32 validity = qFromLittleEndian<quint32>(data + 20);
+    if (static_cast<quint32>(MazeValidity::OFFICIAL) < validity) {
+        throw binaryError(20, QString("invalid validity %1").arg(validity));
+    }
+    quint32 flags = qFromLittleEndian<quint32>(data + 24);
+    quint64 hash = qFromLittleEndian<quint64>(data + 32);
+
+    int horizontalWords = (width * (height + 1) + 63) / 64;
+    int verticalWords = ((width + 1) * height + 63) / 64;
+    int tiles = width * height;
+    qint64 expectedSize =
+        MZB_HEADER_SIZE + 8 * (horizontalWords + verticalWords) + 4 * qint64(tiles);
+    if (size < expectedSize) {
+        throw binaryError(size, QString("expected %1 bytes").arg(expectedSize));
+    }
+
+    QVector<quint64> horizontal(horizontalWords);
+    QVector<quint64> vertical(verticalWords);
+    const uchar* words = data + MZB_HEADER_SIZE;
+    for (int i = 0; i < horizontalWords; i += 1) {
+        horizontal[i] = qFromLittleEndian<quint64>(words + 8 * i);
+    }
+    words += 8 * horizontalWords;
+    for (int i = 0; i < verticalWords; i += 1) {
+        vertical[i] = qFromLittleEndian<quint64>(words + 8 * i);
+    }
+    PackedMaze maze = PackedMaze::fromWords(width, height, flags & 1, horizontal, vertical);
+    if (maze.getHash() != hash) {
+        throw binaryError(32, "the walls don't match the hash");
+    }
+
+    if (metadata != nullptr) {
+        const uchar* distances = words + 8 * verticalWords;
+        metadata->distances.resize(tiles);
+        for (int i = 0; i < tiles; i += 1) {
+            qint32 distance = qFromLittleEndian<qint32>(distances + 4 * i);
+            if (distance < -1) {
+                throw binaryError(
+                    static_cast<int>(distances + 4 * i - data),
+                    QString("invalid distance %1").arg(distance));
+            }
+            metadata->distances[i] = distance;
         }
-
-        // Always append the current tile to the current column
-        column.push_back(tile);
+        metadata->validity = static_cast<MazeValidity>(validity);
+        metadata->isAvailable = true;
     }
 
-    // Make sure to append the last column
-    maze.push_back(column);
-
     return maze;
 }
 
-QByteArray MazeFileUtilities::serializeMapType(const BasicMaze& maze) {
-
-    // TODO: MACK - FIXME
-    // TODO: MACK - deduplicate this with the maze algo code
-    /*
-    // The characters to use in the file
-    char post = '+';
-    char space = ' ';
-    char vertical = '|';
-    char horizontal = '-';
-
-    // A blank line, and a list of all lines to be written
-    QString blankLine(4 * maze.size() + 1, space);
-    QVector<QString> upsideDownLines {blankLine};
-
-    // For all tiles in the maze
-    for (int i = 0; i < maze.size(); i += 1) {
-        for (int j = 0; j < maze.at(i).size(); j += 1) {
-
-            // Insert more lines if necessary
-            if (upsideDownLines.size() <= 2 * j + 1) {
-                upsideDownLines.push_back(blankLine);
-                upsideDownLines.push_back(blankLine);
+PackedMaze MazeFileUtilities::deserializeNumType(const QByteArray& bytes) {
+
+    // Each line is "x y north east south west", possibly followed by more
+    // numbers (which are ignored), and a wall exists where its number is 1.
+    // The tiles may be listed in any order, but each exactly once.
+    struct Entry {
+        int x;
+        int y;
+        quint8 walls;
+        int line;
+    };
+    QVector<Entry> entries;
+    int width = 0;
+    int height = 0;
+
+    const char* data = bytes.constData();
+    int size = bytes.size();
+    auto isSeparator = [](char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    };
+    int position = 0;
+    int line = 1;
+    while (position < size) {
+        int lineStart = position;
+        int values[6];
+        int count = 0;
+        while (position < size && data[position] != '\n') {
+            if (isSeparator(data[position])) {
+                position += 1;
+                continue;
             }
-
-            // Insert posts at the boundaries
-            int left = 4 * i;
-            int right = 4 * (i + 1);
-            int up = 2 * (j + 1);
-            int down = 2 * j;
-            upsideDownLines.at(down).at(left) = post;
-            upsideDownLines.at(down).at(right) = post;
-            upsideDownLines.at(up).at(left) = post;
-            upsideDownLines.at(up).at(right) = post;
-
-            // Insert walls if they exist
-            if (maze.at(i).at(j).at(Direction::NORTH)) {
-                for (int k = 0; k < 3; k += 1) {
-                    upsideDownLines.at(up).at(left + 1 + k) = horizontal;
-                }
+            int tokenStart = position;
+            bool negative = (data[position] == '-');
+            if (negative) {
+                position += 1;
             }
-            if (maze.at(i).at(j).at(Direction::SOUTH)) {
-                for (int k = 0; k < 3; k += 1) {
-                    upsideDownLines.at(down).at(left + 1 + k) = horizontal;
+            int value = 0;
+            int digits = 0;
+            while (position < size && '0' <= data[position] && data[position] <= '9') {
+                if ((std::numeric_limits<int>::max() - 9) / 10 < value) {
+                    throw textError(line, tokenStart - lineStart + 1, "number is too large");
                 }
+                value = 10 * value + (data[position] - '0');
+                position += 1;
+                digits += 1;
+            }
+            if (
+                digits == 0 || (
+                    position < size &&
+                    data[position] != '\n' &&
+                    !isSeparator(data[position])
+                )
+            ) {
+                throw textError(line, position - lineStart + 1, "expected an integer");
             }
-            if (maze.at(i).at(j).at(Direction::EAST)) {
-                upsideDownLines.at(down + 1).at(right) = vertical;
+            if (count < 6) {
+                values[count] = (negative ? -value : value);
             }
-            if (maze.at(i).at(j).at(Direction::WEST)) {
-                upsideDownLines.at(down + 1).at(left) = vertical;
+            count += 1;
+        }
+        if (0 < count && count < 6) {
+            throw textError(
+                line,
+                position - lineStart + 1,
+                QString("expected 6 numbers, found %1").arg(count));
+        }
+        if (0 < count) {
+            if (values[0] < 0 || values[1] < 0) {
+                throw textError(line, 1, "expected non-negative tile coordinates");
             }
+            quint8 walls = 0;
+            for (int i = 0; i < DIRECTIONS().size(); i += 1) {
+                if (values[2 + i] == 1) {
+                    walls |= 1 << i;
+                }
+            }
+            entries.append({values[0], values[1], walls, line});
+            width = std::max(width, values[0] + 1);
+            height = std::max(height, values[1] + 1);
+        }
+        position += 1;
+        line += 1;
+    }
+    if (entries.isEmpty()) {
+        throw textError(line, 1, "expected at least one tile");
+    }
+    if (entries.size() < static_cast<qint64>(width) * height) {
+        throw textError(
+            line,
+            1,
+            QString("expected %1 tiles for a %2x%3 maze, found %4")
+                .arg(static_cast<qint64>(width) * height)
+                .arg(width)
+                .arg(height)
+                .arg(entries.size()));
+    }
+
+    QVector<quint8> tileWalls(width * height, 0);
+    QBitArray listed(width * height);
+    for (const Entry& entry : entries) {
+        int index = entry.x * height + entry.y;
+        if (listed.testBit(index)) {
+            throw textError(
+                entry.line,
+                1,
+                QString("tile (%1, %2) is listed twice").arg(entry.x).arg(entry.y));
         }
+        listed.setBit(index);
+        tileWalls[index] = entry.walls;
     }
+    return PackedMaze::fromTileWalls(width, height, tileWalls);
+}
 
-    // Flip the lines so that they're right side up
-    QVector<QString> rightSideUpLines;
-    for (int i = upsideDownLines.size() - 1; i >= 0; i -= 1) {
-        rightSideUpLines.push_back(upsideDownLines.at(i));
+QByteArray MazeFileUtilities::serializeMapType(const PackedMaze& maze) {
+    // +---+---+
+    // |       |
+    // +   +---+
+    int width = maze.getWidth();
+    int height = maze.getHeight();
+    QByteArray bytes;
+    bytes.reserve((4 * width + 2) * (2 * height + 1));
+    for (int y = height - 1; y >= -1; y -= 1) {
+        // The northern walls of row y (or the southern walls of row 0)
+        for (int x = 0; x < width; x += 1) {
+            bool isWall = (
+                0 <= y
+                ? maze.isWall(x, y, Direction::NORTH)
+                : maze.isWall(x, 0, Direction::SOUTH)
+            );
+            bytes.append(isWall ? "+---" : "+   ");
+        }
+        bytes.append("+\n");
+        if (y < 0) {
+            break;
+        }
+        for (int x = 0; x < width; x += 1) {
+            bytes.append(maze.isWall(x, y, Direction::WEST) ? "|   " : "    ");
+        }
+        bytes.append(maze.isWall(width - 1, y, Direction::EAST) ? "|\n" : " \n");
     }
+    return bytes;
+}
 
-    // Create the stream
-    std::ofstream file(mazeFilePath.toStdString(), std::ios::trunc);
-
-    // Make sure the file is open
-    if (!file.is_open()) {
-        return false;
+QByteArray MazeFileUtilities::serializeMazType(const PackedMaze& maze) {
+    if (maze.getWidth() != 16 || maze.getHeight() != 16) {
+        throw std::runtime_error("the .MAZ format only supports 16x16 mazes");
     }
-
-    // Write to the file
-    for (QString line : rightSideUpLines) {
-        file << line << '\n'; // std::endl flushes the buffer everytime its called
+    QByteArray bytes(256, '\0');
+    for (int x = 0; x < 16; x += 1) {
+        for (int y = 0; y < 16; y += 1) {
+            bytes[x * 16 + y] = static_cast<char>(
+                (maze.isWall(x, y, Direction::NORTH) << 0) |
+                (maze.isWall(x, y, Direction::EAST) << 1) |
+                (maze.isWall(x, y, Direction::SOUTH) << 2) |
+                (maze.isWall(x, y, Direction::WEST) << 3));
+        }
     }
-
-    // Make sure to close the file
-    file.close();
-
-    // Return success
-    return true;
-    */
-    throw std::exception();
+    return bytes;
 }
 
-QByteArray MazeFileUtilities::serializeMazType(const BasicMaze& maze) {
+QByteArray MazeFileUtilities::serializeMz2Type(const PackedMaze& maze) {
 
-    // TODO: MACK - FIXME
-    /*
-    if (maze.size() != 16) {
-        return false; // We only support 16x16 mazes
+    int width = maze.getWidth();
+    int height = maze.getHeight();
+    if (32768 < width || 32768 < height) {
+        throw std::runtime_error("the .MZ2 format only supports mazes up to 32768x32768");
     }
+    int horizontalSize = getMz2SectionSize(static_cast<qint64>(width) * (height - 1));
+    int verticalSize = getMz2SectionSize(static_cast<qint64>(width - 1) * height);
 
-    if (maze.at(0).size() != 16) {
-        // Lets assume the maze is at least rectangular. I don't know if it cannot be
-
-        return false; // We only support 16x16 mazes
+    // An empty name, followed by the big-endian dimensions
+    QByteArray bytes(2 + 8 + horizontalSize + verticalSize, '\0');
+    for (int i = 0; i < 4; i += 1) {
+        bytes[2 + i] = static_cast<char>(width >> (24 - 8 * i));
+        bytes[6 + i] = static_cast<char>(height >> (24 - 8 * i));
     }
 
-    // Create the stream
-    std::ofstream file(mazeFilePath.toStdString(), std::ios::trunc | std::ios::binary);
-    file.imbue(std::locale::classic());
-
-    // Make sure the file is open
-    if (!file.is_open()) {
-        return false;
+    // See deserializeMz2Type for the order of the bits
+    char* horizontal = bytes.data() + 10;
+    for (int row = 0; row < height - 1; row += 1) {
+        for (int x = 0; x < width; x += 1) {
+            int index = row * width + x;
+            horizontal[index / 8] |=
+                maze.isWall(x, height - 1 - row, Direction::SOUTH) << (index % 8);
+        }
     }
-
-    // We hardcode values becuase we specifically checked that the maze
-    // was 16x16 above.
-    for (auto x = 0; x < 16; x++) {
-        for (auto y = 0; y < 16; y++) {
-            BasicTile tile = maze.at(x).at(y);
-            //Each byte reprsents the walls like this: 'X X X X W S E N'
-            int representation = (tile[Direction::WEST]  << 3) +
-                                 (tile[Direction::SOUTH] << 2) +
-                                 (tile[Direction::EAST]  << 1) +
-                                 (tile[Direction::NORTH] << 0);
-
-            file.put(representation);
+    char* vertical = horizontal + horizontalSize;
+    for (int x = 0; x < width - 1; x += 1) {
+        for (int row = 0; row < height; row += 1) {
+            int index = x * height + row;
+            vertical[index / 8] |=
+                maze.isWall(x, height - 1 - row, Direction::EAST) << (index % 8);
         }
     }
 
-    // Make sure to close the file
-    file.close();
-
-    // Return success
-    return true;
-    */
-    throw std::exception();
+    return bytes;
 }
 
-QByteArray MazeFileUtilities::serializeMz2Type(const BasicMaze& maze) {
-
-    // TODO: MACK - FIXME
-    /*
-    // Create the stream
-    std::ofstream file(mazeFilePath.toStdString(), std::ios::trunc | std::ios::binary);
-    file.imbue(std::locale::classic());
-
-    // Make sure the file is open
-    if (!file.is_open()) {
-        return false;
-    }
-
-    file.put(0);  // Hardcoded name is: 'Auto Generated Maze' (length: 19)
-    file.put(19); // I am assuming that the length is encoded in 16 bits.
-                  // The spec is unclear
-    
-    file << "Auto Generated Maze";
-
-    uint32_t width = maze.size();
-    uint32_t height = 0;
-
-    if (maze.size() > 0) {
-        height = maze.at(0).size();
-        if (height == 0)
-            return false; // I don't think this should be allowed?
-    }
-    else
-        return false; // I don't think this should be allowed?
-
-    file.put(width >> 24); // width
-    file.put(width >> 16);
-    file.put(width >> 8);
-    file.put(width);
-
-    file.put(height >> 24); // height
-    file.put(height >> 16);
-    file.put(height >> 8);
-    file.put(height);
-
-    int numberOfBits = 0;
-    int numberOfBytes = 0;
-    unsigned char toWrite = 0;
-
-    for (auto y = 0; y < height - 1; y++) {
-        for (auto x = 0; x < width; x++) {
-            BasicTile tile = maze.at(x).at(height - 1 - y);
-
-            toWrite >>= 1;
-            if (tile[Direction::SOUTH] == true) {
-                toWrite |= 1 << 7; // Set the MSB bit as one
-            }
-            numberOfBits = (numberOfBits + 1) % 8;
+QByteArray MazeFileUtilities::serializeMzbType(const PackedMaze& maze) {
+
+    MazeValidity validity = MazeChecker::checkMaze(maze);
+    QVector<int> distances = MazeUtilities::getDistancesToCenter(maze);
+    const QVector<quint64>& horizontal = maze.getHorizontalWords();
+    const QVector<quint64>& vertical = maze.getVerticalWords();
+
+    QByteArray bytes(
+        MZB_HEADER_SIZE +
+        8 * (horizontal.size() + vertical.size()) +
+        4 * distances.size(),
+        '\0');
+    uchar* data = reinterpret_cast<uchar*>(bytes.data());
+    std::copy(MZB_MAGIC, MZB_MAGIC + sizeof(MZB_MAGIC), data);
+    qToLittleEndian<quint32>(MZB_VERSION, data + 8);
+    qToLittleEndian<quint32>(maze.getWidth(), data + 12);
+    qToLittleEndian<quint32>(maze.getHeight(), data + 16);
+    qToLittleEndian<quint32>(static_cast<quint32>(validity), data + 20);
+    qToLittleEndian<quint32>(maze.hasConsistentWalls() ? 1 : 0, data + 24);
+    qToLittleEndian<quint64>(maze.getHash(), data + 32);
+
+    uchar* position = data + MZB_HEADER_SIZE;
+    for (quint64 word : horizontal) {
+        qToLittleEndian<quint64>(word, position);
+        position += 8;
+    }
+    for (quint64 word : vertical) {
+        qToLittleEndian<quint64>(word, position);
+        position += 8;
+    }
+    for (int distance : distances) {
+        qToLittleEndian<qint32>(distance, position);
+        position += 4;
+    }
+
+    return bytes;
+}
 
-            if (numberOfBits == 0) {
-                file.put(toWrite); // Write the byte when it is full
-                numberOfBytes = (numberOfBytes + 1) % 8; // Add one to the number of bytes
+QByteArray MazeFileUtilities::serializeNumType(const PackedMaze& maze) {
+    QByteArray bytes;
+    bytes.reserve(16 * maze.getWidth() * maze.getHeight());
+    for (int x = 0; x < maze.getWidth(); x += 1) {
+        for (int y = 0; y < maze.getHeight(); y += 1) {
+            bytes.append(QByteArray::number(x));
+            bytes.append(' ');
+            bytes.append(QByteArray::number(y));
+            for (Direction direction : DIRECTIONS()) {
+                bytes.append(maze.isWall(x, y, direction) ? " 1" : " 0");
             }
+            bytes.append('\n');
         }
     }
+    return bytes;
+}
 
-    if (numberOfBits != 0) {
-        file.put(toWrite >> (8 - numberOfBits));
-        numberOfBits = 0; // Write the last byte out 
-    }
-    
-    if (numberOfBytes != 0) {
-        for (auto i = 0; i < (7 - numberOfBytes); i += 1 {
-            file.put(0); // Padding so the number of bytes is a muliple of 8
-        }
-        numberOfBytes = 0;
-    }
-
-    for (auto x = 0; x < width - 1; x++) {
-        for (auto y = 0; y < height; y++) {
-            BasicTile tile = maze.at(x).at(height - 1 - y);
+int MazeFileUtilities::getMz2SectionSize(qint64 bits) {
+    // One byte more than the whole bytes of bits, and then padded to a
+    // multiple of eight bytes if that isn't one already
+    qint64 wholeBytes = bits / 8;
+    return static_cast<int>(1 + wholeBytes + (wholeBytes % 8 == 0 ? 0 : 7 - wholeBytes % 8));
+}
 
-            toWrite >>= 1;
-            if (tile[Direction::EAST] == true) {
-                toWrite |= 1 << 7; // Set the MSB bit as one
-            }
-            numberOfBits = (numberOfBits + 1) % 8;
+int MazeFileUtilities::readMz2Header(const QByteArray& bytes, int* width, int* height) {
 
-            if (numberOfBits == 0) {
-                file.put(toWrite); // Write the byte when it is full
-                numberOfBytes = (numberOfBytes + 1) % 8; // Add one to the number of bytes
-            }
+    const uchar* data = reinterpret_cast<const uchar*>(bytes.constData());
+    int size = bytes.size();
+    auto byteAt = [&](int offset) {
+        if (size <= offset) {
+            throw binaryError(offset, "unexpected end of data");
         }
+        return data[offset];
+    };
+
+    // The name of the maze, which isn't used. It's UTF-8, and its length is
+    // in characters, so only the first byte of each character is counted.
+    int nameLength = (byteAt(0) << 4) + byteAt(1);
+    int offset = 2;
+    while (0 < nameLength || (offset < size && (data[offset] >> 6) == 2)) {
+        uchar character = byteAt(offset);
+        if ((character >> 7) == 0 || (character >> 6) == 3) {
+            nameLength -= 1;
+        }
+        offset += 1;
     }
 
-    if (numberOfBits != 0) {
-        file.put(toWrite >> (8 - numberOfBits));
-    }
-
-    if (numberOfBytes != 0) {
-        for (auto i = 0; i < (7 - numberOfBytes); i += 1 {
-            file.put(0); // Padding so the number of bytes is a muliple of 8
+    // The dimensions, as big-endian 32-bit integers
+    qint64 dimensions[2];
+    for (int i = 0; i < 2; i += 1) {
+        dimensions[i] = 0;
+        for (int j = 0; j < 4; j += 1) {
+            dimensions[i] = (dimensions[i] << 8) + byteAt(offset + 4 * i + j);
         }
     }
-
-    // Make sure to close the file
-    file.close();
-
-    // Return success
-    return true;
-    */
-    throw std::exception();
+    if (
+        dimensions[0] < 1 || 32768 < dimensions[0] ||
+        dimensions[1] < 1 || 32768 < dimensions[1]
+    ) {
+        throw binaryError(
+            offset,
+            QString("invalid maze size %1x%2").arg(dimensions[0]).arg(dimensions[1]));
+    }
+    *width = static_cast<int>(dimensions[0]);
+    *height = static_cast<int>(dimensions[1]);
+    return offset + 8;
 }
 
-QByteArray MazeFileUtilities::serializeNumType(const BasicMaze& maze) {
-
-    // TODO: MACK - FIXME
-    /*
-    // Create the stream
-    std::ofstream file(mazeFilePath.toStdString(), std::ios::trunc);
-
-    // Make sure the file is open
-    if (!file.is_open()) {
-        return false;
+bool MazeFileUtilities::hasMz2Size(const QByteArray& bytes) {
+    int width = 0;
+    int height = 0;
+    int offset = 0;
+    try {
+        offset = readMz2Header(bytes, &width, &height);
     }
-
-    // Write to the file
-    for (int x = 0; x < maze.size(); x += 1) {
-        for (int y = 0; y < maze.at(x).size(); y += 1) {
-            file << x << " " << y;
-            for (Direction direction : DIRECTIONS()) {
-                file << " " << (maze.at(x).at(y).at(direction) ? 1 : 0);
-            }
-            file << "\n"; // std::endl flushes the buffer everytime its called
-        }
+    catch (const std::runtime_error&) {
+        return false;
     }
+    // The padding of the last section is optional
+    qint64 verticalBits = static_cast<qint64>(width - 1) * height;
+    qint64 walls = offset + getMz2SectionSize(static_cast<qint64>(width) * (height - 1));
+    return (
+        walls + (verticalBits + 7) / 8 <= bytes.size() &&
+        bytes.size() <= walls + getMz2SectionSize(verticalBits)
+    );
+}
 
-    // Make sure to close the file
-    file.close();
+std::runtime_error MazeFileUtilities::textError(
+        int line,
+        int column,
+        const QString& message) {
+    return std::runtime_error(
+        QString("line %1, column %2: %3")
+            .arg(line)
+            .arg(column)
+            .arg(message)
+            .toStdString());
+}
 
-    // Return success
-    return true;
-    */
-    throw std::exception();
+std::runtime_error MazeFileUtilities::binaryError(int offset, const QString& message) {
+    return std::runtime_error(
+        QString("byte %1: %2").arg(offset).arg(message).toStdString());
 }
 
 } //namespace mms
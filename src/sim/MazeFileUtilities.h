@@ -2,37 +2,82 @@
 
 #include <QByteArray>
 #include <QString>
+#include <QVector>
 
-#include "BasicMaze.h"
+#include <stdexcept>
+
+#include "MazeChecker.h"
 #include "MazeFileType.h"
+#include "PackedMaze.h"
 
 namespace mms {
 
+// What a .MZB file stores alongside the walls, so that loading it needs
+// neither validation nor a distance computation
+struct MazeMetadata {
+    bool isAvailable = false;
+    MazeValidity validity = MazeValidity::INVALID;
+    // Indexed by x * height + y, -1 for tiles that can't reach the center
+    QVector<int> distances;
+};
+
 class MazeFileUtilities {
 
 public:
 
     MazeFileUtilities() = delete;
 
-    static BasicMaze load(const QString& path);
-    static BasicMaze loadBytes(const QByteArray& bytes);
+    // Both of these detect the format from the first few bytes and parse
+    // it in a single pass, straight into the packed store. Malformed input
+    // throws a std::runtime_error whose message says where parsing stopped,
+    // as a line and column for text formats or a byte offset otherwise.
+    // Files are memory-mapped rather than read. If metadata isn't null, it's
+    // filled in for formats that store it, and marked unavailable otherwise.
+    static PackedMaze load(const QString& path, MazeMetadata* metadata = nullptr);
+    static PackedMaze loadBytes(
+        const QByteArray& bytes,
+        MazeMetadata* metadata = nullptr);
+
+    static MazeFileType detectType(const QByteArray& bytes);
 
+    // The serializers write to memory; these throw a std::runtime_error if
+    // the maze can't be written in the given format (.MAZ is 16x16 only).
+    // The file is either written completely or left as it was.
     static void save(
-        const BasicMaze& maze,
+        const PackedMaze& maze,
         const QString& path,
         MazeFileType type);
+    static QByteArray saveBytes(const PackedMaze& maze, MazeFileType type);
 
 private:
 
-    static BasicMaze deserializeMapType(const QByteArray& bytes);
-    static BasicMaze deserializeMazType(const QByteArray& bytes);
-    static BasicMaze deserializeMz2Type(const QByteArray& bytes);
-    static BasicMaze deserializeNumType(const QByteArray& bytes);
+    static PackedMaze deserializeMapType(const QByteArray& bytes);
+    static PackedMaze deserializeMazType(const QByteArray& bytes);
+    static PackedMaze deserializeMz2Type(const QByteArray& bytes);
+    static PackedMaze deserializeMzbType(
+        const QByteArray& bytes,
+        MazeMetadata* metadata);
+    static PackedMaze deserializeNumType(const QByteArray& bytes);
+
+    static QByteArray serializeMapType(const PackedMaze& maze);
+    static QByteArray serializeMazType(const PackedMaze& maze);
+    static QByteArray serializeMz2Type(const PackedMaze& maze);
+    static QByteArray serializeMzbType(const PackedMaze& maze);
+    static QByteArray serializeNumType(const PackedMaze& maze);
+
+    // The number of bytes taken by a section of .MZ2 wall bits
+    static int getMz2SectionSize(qint64 bits);
+
+    // Reads the name and dimensions that start an .MZ2 file, and returns the
+    // offset of the wall bits; throws if they can't be read
+    static int readMz2Header(const QByteArray& bytes, int* width, int* height);
+
+    // Whether the data is exactly as long as the .MZ2 header at its start says
+    static bool hasMz2Size(const QByteArray& bytes);
 
-    static QByteArray serializeMapType(const BasicMaze& maze);
-    static QByteArray serializeMazType(const BasicMaze& maze);
-    static QByteArray serializeMz2Type(const BasicMaze& maze);
-    static QByteArray serializeNumType(const BasicMaze& maze);
+    // Lines and columns are one-based, byte offsets are zero-based
+    static std::runtime_error textError(int line, int column, const QString& message);
+    static std::runtime_error binaryError(int offset, const QString& message);
 };
 
 } // namespace mms
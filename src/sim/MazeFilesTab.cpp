@@ -1,20 +1,25 @@
 #include "MazeFilesTab.h"
 
+#include <QDir>
 #include <QFileDialog>
-#include <QFileInfo>
 #include <QHBoxLayout>
 #include <QHeaderView>
-#include <QPushButton>
-#include <QTableWidget>
+#include <QItemSelectionModel>
+#include <QLineEdit>
 #include <QVBoxLayout>
 
+#include "Assert.h"
 #include "MazeFileType.h"
 #include "Resources.h"
 #include "SettingsMazeFiles.h"
 
 namespace mms {
 
-MazeFilesTab::MazeFilesTab() : m_table(new QTableWidget()) {
+MazeFilesTab::MazeFilesTab() :
+        m_library(new MazeLibrary(this)),
+        m_proxy(new QSortFilterProxyModel(this)),
+        m_table(new QTableView()),
+        m_removeButton(new QPushButton("Remove Selected")) {
 
     // Set up the layout
     QVBoxLayout* layout = new QVBoxLayout();
@@ -22,37 +27,64 @@ MazeFilesTab::MazeFilesTab() : m_table(new QTableWidget()) {
     QHBoxLayout* buttonsLayout = new QHBoxLayout();
     layout->addLayout(buttonsLayout);
 
-    // Create the import button
+    // Create the import buttons
     QPushButton* importButton = new QPushButton("Import Maze File(s)");
     connect(importButton, &QPushButton::clicked, this, &MazeFilesTab::import);
     buttonsLayout->addWidget(importButton);
+    QPushButton* importDirectoryButton = new QPushButton("Import Directory");
+    connect(
+        importDirectoryButton, &QPushButton::clicked,
+        this, &MazeFilesTab::importDirectory);
+    buttonsLayout->addWidget(importDirectoryButton);
 
-    // Create the remove button
-    QPushButton* removeButton = new QPushButton("Remove Selected File");
-    connect(removeButton, &QPushButton::clicked, this, &MazeFilesTab::remove);
-    connect(m_table, &QTableWidget::itemSelectionChanged, this, [=](){
-        // TODO: upforgrabs
-        // We should disable the remove button for the builtin mazes
-        removeButton->setEnabled(0 < m_table->selectedItems().size());
+    // Create the remove button, which removes the selected file, or the
+    // directory it was found in; the builtin mazes can't be removed
+    connect(m_removeButton, &QPushButton::clicked, this, &MazeFilesTab::remove);
+    m_removeButton->setEnabled(false);
+    buttonsLayout->addWidget(m_removeButton);
+
+    // Create the filter, which matches against every column
+    QLineEdit* filterEdit = new QLineEdit();
+    filterEdit->setPlaceholderText("Filter");
+    filterEdit->setClearButtonEnabled(true);
+    connect(filterEdit, &QLineEdit::textChanged, this, [=](const QString& text){
+        m_proxy->setFilterFixedString(text);
     });
-    removeButton->setEnabled(false);
-    buttonsLayout->addWidget(removeButton);
+    buttonsLayout->addWidget(filterEdit);
+
+    // Sort by each column's sort key rather than its text
+    m_proxy->setSourceModel(m_library);
+    m_proxy->setSortRole(MazeLibrary::SORT_ROLE);
+    m_proxy->setFilterKeyColumn(-1);
+    m_proxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
+    m_proxy->setDynamicSortFilter(true);
 
     // Initialize the table
+    m_table->setModel(m_proxy);
     m_table->horizontalHeader()->setHighlightSections(false);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->verticalHeader()->setDefaultSectionSize(MazeLibrary::THUMBNAIL_SIZE + 4);
+    m_table->setIconSize(QSize(MazeLibrary::THUMBNAIL_SIZE, MazeLibrary::THUMBNAIL_SIZE));
     m_table->setAutoScroll(false);
     m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
     m_table->setHorizontalScrollMode(QAbstractItemView::ScrollPerPixel);
     m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_table->setSelectionMode(QAbstractItemView::SingleSelection);
     m_table->setSortingEnabled(true);
-    connect(m_table, &QTableWidget::itemSelectionChanged, this, [=](){
-        const auto& selected = m_table->selectedItems();
-        if (0 < selected.size()) {
-            QString path = m_table->item(m_table->currentRow(), 1)->text();
-            emit mazeFileChanged(path);
+    m_table->sortByColumn(MazeLibrary::NAME, Qt::AscendingOrder);
+    m_table->setColumnWidth(MazeLibrary::NAME, 240);
+    connect(
+        m_table->selectionModel(), &QItemSelectionModel::selectionChanged,
+        this, [=](){
+            QString path = getSelectedPath();
+            m_removeButton->setEnabled(!path.isEmpty() && !path.startsWith(":"));
+            if (!path.isEmpty()) {
+                emit mazeFileChanged(path);
+                emit mazeFileNeighborsChanged(getNeighborPaths());
+            }
         }
-    });
+    );
     layout->addWidget(m_table);
 
     // Adds the entries to the table
@@ -79,29 +111,64 @@ void MazeFilesTab::import() {
     refresh();
 }
 
+void MazeFilesTab::importDirectory() {
+    QString path = QFileDialog::getExistingDirectory(this, "Import Directory");
+    if (path.isEmpty() ||
+            SettingsMazeFiles::getSettingsMazeDirectories().contains(path)) {
+        return;
+    }
+    SettingsMazeFiles::addMazeDirectory(path);
+    refresh();
+}
+
 void MazeFilesTab::remove() {
-    const auto& selected = m_table->selectedItems();
-    ASSERT_LT(0, selected.size());
-    QString path = m_table->item(m_table->currentRow(), 1)->text();
-    SettingsMazeFiles::removeMazeFile(path);
+    QString path = getSelectedPath();
+    ASSERT_FA(path.isEmpty());
+    if (SettingsMazeFiles::getSettingsMazeFiles().contains(path)) {
+        SettingsMazeFiles::removeMazeFile(path);
+    }
+    else {
+        for (const QString& directory : SettingsMazeFiles::getSettingsMazeDirectories()) {
+            if (path.startsWith(QDir(directory).absolutePath() + "/")) {
+                SettingsMazeFiles::removeMazeDirectory(directory);
+            }
+        }
+    }
     refresh();
 }
 
 void MazeFilesTab::refresh() {
-    m_table->clear();
-    m_table->setColumnCount(2);
-    m_table->setHorizontalHeaderLabels({"File Name", "File Path"});
     QStringList mazeFiles;
     mazeFiles += Resources::getMazes();
     mazeFiles += SettingsMazeFiles::getSettingsMazeFiles();
-    m_table->setRowCount(mazeFiles.size());
-    for (int i = 0; i < mazeFiles.size(); i += 1) {
-        QString path = mazeFiles.at(i);
-        QString name = QFileInfo(path).fileName();
-        m_table->setItem(i, 0, new QTableWidgetItem(name));
-        m_table->setItem(i, 1, new QTableWidgetItem(path));
+    m_library->refresh(mazeFiles, SettingsMazeFiles::getSettingsMazeDirectories());
+}
+
+QString MazeFilesTab::getSelectedPath() const {
+    QModelIndexList selected = m_table->selectionModel()->selectedRows();
+    if (selected.isEmpty()) {
+        return QString();
+    }
+    return m_library->getPath(m_proxy->mapToSource(selected.first()).row());
+}
+
+QStringList MazeFilesTab::getNeighborPaths() const {
+    QModelIndexList selected = m_table->selectionModel()->selectedRows();
+    if (selected.isEmpty()) {
+        return QStringList();
+    }
+    // Nearest first, in the order that they're shown
+    QStringList paths;
+    int row = selected.first().row();
+    for (int distance = 1; distance <= NEIGHBOR_COUNT; distance += 1) {
+        for (int neighbor : {row + distance, row - distance}) {
+            if (0 <= neighbor && neighbor < m_proxy->rowCount()) {
+                QModelIndex index = m_proxy->index(neighbor, 0);
+                paths.append(m_library->getPath(m_proxy->mapToSource(index).row()));
+            }
+        }
     }
-    m_table->resizeColumnsToContents();
+    return paths;
 }
 
 } // namespace mms
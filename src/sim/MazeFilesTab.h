@@ -1,8 +1,12 @@
 #pragma once
 
-#include <QTableWidget>
+#include <QPushButton>
+#include <QSortFilterProxyModel>
+#include <QTableView>
 #include <QWidget>
 
+#include "MazeLibrary.h"
+
 namespace mms {
 
 class MazeFilesTab : public QWidget {
@@ -17,13 +21,31 @@ signals:
 
     void mazeFileChanged(const QString& path);
 
+    // The files listed on either side of the selected one, which are likely
+    // to be selected next
+    void mazeFileNeighborsChanged(const QStringList& paths);
+
 private:
 
-    QTableWidget* m_table;
+    // The library indexes the files in the background, the proxy sorts and
+    // filters them, and the table shows them
+    MazeLibrary* m_library;
+    QSortFilterProxyModel* m_proxy;
+    QTableView* m_table;
+    QPushButton* m_removeButton;
+
     void import();
+    void importDirectory();
     void remove();
     void refresh();
 
+    // The number of rows on each side of the selection that are preloaded
+    static const int NEIGHBOR_COUNT = 2;
+
+    // Empty if nothing is selected
+    QString getSelectedPath() const;
+    QStringList getNeighborPaths() const;
+
 };
 
 } // namespace mms
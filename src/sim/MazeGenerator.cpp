@@ -0,0 +1,284 @@
+#include "MazeGenerator.h"
+
+#include <QAtomicInt>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QLibrary>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+
+#include <random>
+
+#include "FunctionTask.h"
+#include "MazeFileType.h"
+#include "MazeFileUtilities.h"
+#include "TomaszMazeGenerator.h"
+
+namespace mms {
+
+// Generates straight into the packed store; each worker reuses one of these,
+// reseeding it for each maze
+class PackedMazeGeneratorInterface : public MazeGeneratorInterface {
+
+public:
+
+    PackedMazeGeneratorInterface(int width, int height) :
+            m_maze(width, height),
+            m_hasFailed(false) {
+    }
+
+    void reset(quint64 seed) {
+        m_maze = PackedMaze(m_maze.getWidth(), m_maze.getHeight());
+        m_random.seed(seed);
+        m_hasFailed = false;
+    }
+
+    const PackedMaze& getMaze() const {
+        return m_maze;
+    }
+
+    bool hasFailed() const {
+        return m_hasFailed;
+    }
+
+    int getWidth() {
+        return m_maze.getWidth();
+    }
+
+    int getHeight() {
+        return m_maze.getHeight();
+    }
+
+    double getRandomFloat() {
+        // The top 53 bits, so that every double in [0, 1) is equally likely
+        return (m_random() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    void setWall(int x, int y, char direction, bool wallExists) {
+        Direction wall = Direction::NORTH;
+        switch (direction) {
+            case 'n':
+                wall = Direction::NORTH;
+                break;
+            case 'e':
+                wall = Direction::EAST;
+                break;
+            case 's':
+                wall = Direction::SOUTH;
+                break;
+            case 'w':
+                wall = Direction::WEST;
+                break;
+            default:
+                m_hasFailed = true;
+                return;
+        }
+        if (!m_maze.withinMaze(x, y)) {
+            m_hasFailed = true;
+            return;
+        }
+        m_maze.setWall(x, y, wall, wallExists);
+    }
+
+private:
+
+    PackedMaze m_maze;
+    std::mt19937_64 m_random;
+    bool m_hasFailed;
+};
+
+// Forwards a plugin's calls to the in-process interface
+static int hostGetWidth(void* context) {
+    return static_cast<MazeGeneratorInterface*>(context)->getWidth();
+}
+
+static int hostGetHeight(void* context) {
+    return static_cast<MazeGeneratorInterface*>(context)->getHeight();
+}
+
+static double hostGetRandomFloat(void* context) {
+    return static_cast<MazeGeneratorInterface*>(context)->getRandomFloat();
+}
+
+static void hostSetWall(void* context, int x, int y, char direction, int wallExists) {
+    static_cast<MazeGeneratorInterface*>(context)->setWall(
+        x, y, direction, wallExists != 0);
+}
+
+QStringList MazeGenerator::getBuiltInNames() {
+    return getBuiltIns().keys();
+}
+
+bool MazeGenerator::load(const QString& nameOrPath, Algorithm* algorithm) {
+
+    if (getBuiltIns().contains(nameOrPath)) {
+        *algorithm = getBuiltIns().value(nameOrPath);
+        return true;
+    }
+
+    // The library is deliberately left loaded when this goes out of scope
+    typedef void (*Entry)(MmsMazeGeneratorHost*);
+    QLibrary library(nameOrPath);
+    Entry entry = reinterpret_cast<Entry>(library.resolve("mmsGenerateMaze"));
+    if (entry == nullptr) {
+        qWarning().noquote().nospace()
+            << "\"" << nameOrPath << "\" is neither a built-in maze algorithm ("
+            << getBuiltInNames().join(", ") << ") nor a maze algorithm plugin: "
+            << library.errorString();
+        return false;
+    }
+    *algorithm = [entry](MazeGeneratorInterface* interface) {
+        MmsMazeGeneratorHost host = {
+            interface,
+            &hostGetWidth,
+            &hostGetHeight,
+            &hostGetRandomFloat,
+            &hostSetWall,
+        };
+        entry(&host);
+    };
+    return true;
+}
+
+MazeGenerationResult MazeGenerator::generate(
+        const Algorithm& algorithm,
+        int width,
+        int height,
+        int count,
+        quint64 seed,
+        MazeValidity minimum,
+        const Consumer& consumer) {
+
+    QElapsedTimer timer;
+    timer.start();
+    QAtomicInt next(0);
+    QAtomicInt generated(0);
+    QAtomicInt accepted(0);
+    QAtomicInt failed(0);
+
+    // Rather than a task per maze, each worker claims the next index until
+    // there are none left, which keeps the overhead flat for huge batches
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(QThread::idealThreadCount());
+    int workerCount = qMin(threadPool.maxThreadCount(), count);
+    for (int i = 0; i < workerCount; i += 1) {
+        threadPool.start(new FunctionTask([&]() {
+            PackedMazeGeneratorInterface interface(width, height);
+            for (int index = next.fetchAndAddRelaxed(1);
+                    index < count;
+                    index = next.fetchAndAddRelaxed(1)) {
+                interface.reset(getStreamSeed(seed, index));
+                bool succeeded = false;
+                try {
+                    algorithm(&interface);
+                    succeeded = !interface.hasFailed();
+                }
+                catch (const std::exception& e) {
+                    qWarning().noquote().nospace()
+                        << "Maze " << index << " failed to generate: "
+                        << QString(e.what()) << ".";
+                }
+                generated.fetchAndAddRelaxed(1);
+                if (!succeeded) {
+                    failed.fetchAndAddRelaxed(1);
+                    continue;
+                }
+                MazeValidity validity = MazeChecker::checkMaze(interface.getMaze());
+                if (static_cast<int>(validity) < static_cast<int>(minimum)) {
+                    continue;
+                }
+                accepted.fetchAndAddRelaxed(1);
+                consumer(index, interface.getMaze(), validity);
+            }
+        }));
+    }
+    threadPool.waitForDone();
+
+    MazeGenerationResult result;
+    result.generated = generated.load();
+    result.accepted = accepted.load();
+    result.failed = failed.load();
+    result.seconds = timer.elapsed() / 1000.0;
+    return result;
+}
+
+int MazeGenerator::run(
+        const QString& directory,
+        const QString& nameOrPath,
+        int width,
+        int height,
+        int count,
+        quint64 seed,
+        MazeValidity minimum) {
+
+    Algorithm algorithm;
+    if (!load(nameOrPath, &algorithm)) {
+        return 1;
+    }
+    if (!QDir().mkpath(directory)) {
+        qWarning().noquote().nospace()
+            << "Unable to create the directory \"" << directory << "\".";
+        return 1;
+    }
+
+    // Pad the names so that they sort in the order they were generated
+    QString suffix = MAZE_FILE_TYPE_TO_SUFFIX().value(MazeFileType::MZB);
+    int digits = QString::number(qMax(count - 1, 0)).size();
+    QAtomicInt unwritten(0);
+    MazeGenerationResult result = generate(
+        algorithm, width, height, count, seed, minimum,
+        [&](int index, const PackedMaze& maze, MazeValidity validity) {
+            Q_UNUSED(validity);
+            QString path = QDir(directory).filePath(
+                QString("%1.%2").arg(index, digits, 10, QChar('0')).arg(suffix));
+            try {
+                MazeFileUtilities::save(maze, path, MazeFileType::MZB);
+            }
+            catch (const std::exception& e) {
+                unwritten.fetchAndAddRelaxed(1);
+                qWarning().noquote().nospace()
+                    << "Unable to write \"" << path << "\": "
+                    << QString(e.what()) << ".";
+            }
+        });
+
+    int unwrittenCount = unwritten.load();
+    QTextStream(stdout)
+        << "Generated " << result.generated << " " << width << "x" << height
+        << " mazes in " << result.seconds << " s ("
+        << result.accepted - unwrittenCount << " written, "
+        << result.generated - result.accepted - result.failed << " rejected, "
+        << result.failed << " failed, " << unwrittenCount << " unwritable)\n";
+    return result.failed == 0 && unwrittenCount == 0 ? 0 : 1;
+}
+
+const QMap<QString, MazeGenerator::Algorithm>& MazeGenerator::getBuiltIns() {
+    static const QMap<QString, Algorithm> map = {
+        // The same as maze/algos/random_c++
+        {"random", [](MazeGeneratorInterface* interface) {
+            static const char directions[] = {'n', 'e', 's', 'w'};
+            for (int x = 0; x < interface->getWidth(); x += 1) {
+                for (int y = 0; y < interface->getHeight(); y += 1) {
+                    for (char direction : directions) {
+                        bool wallExists = interface->getRandomFloat() <= 0.40;
+                        interface->setWall(x, y, direction, wallExists);
+                    }
+                }
+            }
+        }},
+        {"tomasz", &TomaszMazeGenerator::generate},
+    };
+    return map;
+}
+
+quint64 MazeGenerator::getStreamSeed(quint64 seed, int index) {
+    // SplitMix64's output function, applied to evenly spaced inputs
+    quint64 z = seed + (static_cast<quint64>(index) + 1) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+} // namespace mms
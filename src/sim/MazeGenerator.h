@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+#include "MazeChecker.h"
+#include "PackedMaze.h"
+
+// What a maze generation plugin is given. This is the C equivalent of the
+// Interface class in maze/templates/c++, so that plugins built with another
+// compiler (or in another language) can be loaded; it must match the copy in
+// maze/templates/c++/Plugin.cpp. A plugin is a shared library that exports
+//
+//     extern "C" void mmsGenerateMaze(MmsMazeGeneratorHost* host);
+//
+// which generates a single maze. It may be called on several threads at
+// once, each with its own host, so it mustn't touch any global state.
+extern "C" {
+struct MmsMazeGeneratorHost {
+    void* context;
+    int (*getWidth)(void* context);
+    int (*getHeight)(void* context);
+    double (*getRandomFloat)(void* context);
+    void (*setWall)(void* context, int x, int y, char direction, int wallExists);
+};
+}
+
+namespace mms {
+
+// What a maze generation algorithm is given when it's run in-process; the
+// methods are those of the Interface class in maze/templates/c++. Walls are
+// set in both of the tiles they separate, random floats are in [0, 1), and
+// every wall starts out missing.
+class MazeGeneratorInterface {
+
+public:
+
+    virtual ~MazeGeneratorInterface() {}
+
+    virtual int getWidth() = 0;
+    virtual int getHeight() = 0;
+    virtual double getRandomFloat() = 0;
+
+    // An invalid position or direction fails the maze
+    virtual void setWall(int x, int y, char direction, bool wallExists) = 0;
+};
+
+// What a batch of generation did; mazes that are generated but fall short
+// of the requested validity are rejected, and mazes whose algorithm made an
+// invalid call (or threw) have failed
+struct MazeGenerationResult {
+    int generated = 0;
+    int accepted = 0;
+    int failed = 0;
+    double seconds = 0.0;
+};
+
+// Generates mazes in-process, without the round trip through a separate
+// program and its printed output. Each maze i of a batch is generated from
+// its own random stream, seeded from (seed, i), so a batch is reproducible
+// no matter how many workers it's spread over.
+class MazeGenerator {
+
+public:
+
+    // Generates a single maze
+    typedef std::function<void(MazeGeneratorInterface*)> Algorithm;
+
+    // Called with each accepted maze, its index in the batch, and its
+    // validity, on the worker threads, concurrently
+    typedef std::function<void(int, const PackedMaze&, MazeValidity)> Consumer;
+
+    // This class is not constructible
+    MazeGenerator() = delete;
+
+    // The algorithms that are compiled into the simulator
+    static QStringList getBuiltInNames();
+
+    // Finds a built-in algorithm by name, or else loads the plugin at the
+    // given path; returns false (and warns) if neither exists. Plugins are
+    // never unloaded.
+    static bool load(const QString& nameOrPath, Algorithm* algorithm);
+
+    // Generates mazes 0 through count - 1 on all cores, passing each one
+    // that's at least the minimum validity to the consumer
+    static MazeGenerationResult generate(
+        const Algorithm& algorithm,
+        int width,
+        int height,
+        int count,
+        quint64 seed,
+        MazeValidity minimum,
+        const Consumer& consumer);
+
+    // Generates mazes into the directory, one .MZB file per accepted maze,
+    // named by its index, and prints a summary; returns a process exit code
+    static int run(
+        const QString& directory,
+        const QString& nameOrPath,
+        int width,
+        int height,
+        int count,
+        quint64 seed,
+        MazeValidity minimum);
+
+private:
+
+    static const QMap<QString, Algorithm>& getBuiltIns();
+
+    // The seed of maze i's random stream; nearby indices get unrelated seeds
+    static quint64 getStreamSeed(quint64 seed, int index);
+};
+
+} // namespace mms
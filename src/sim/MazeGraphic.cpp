@@ -16,7 +16,9 @@ MazeGraphic::MazeGraphic(
         QVector<TileGraphic> column;
         for (int y = 0; y < maze->getHeight(); y += 1) {
             column.push_back(TileGraphic(
-                maze->getTile(x, y),
+                maze,
+                x,
+                y,
                 bufferInterface,
                 wallTruthVisible,
                 tileColorsVisible,
@@ -55,6 +57,11 @@ void MazeGraphic::setTileText(int x, int y, const QString& text) {
     m_tileGraphics[x][y].setText(text);
 }
 
+void MazeGraphic::refreshTile(int x, int y) {
+    ASSERT_TR(withinMaze(x, y));
+    m_tileGraphics[x][y].refresh();
+}
+
 void MazeGraphic::setWallTruthVisible(bool visible) {
     for (int x = 0; x < getWidth(); x += 1) {
         for (int y = 0; y < getHeight(); y += 1) {
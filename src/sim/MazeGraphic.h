@@ -28,6 +28,9 @@ public:
     void setTileFogginess(int x, int y, bool foggy);
     void setTileText(int x, int y, const QString& text);
 
+    // Redraws the tile's walls and distance after the maze was edited
+    void refreshTile(int x, int y);
+
     void setWallTruthVisible(bool visible);
     void setTileColorsVisible(bool visible);
     void setTileFogVisible(bool visible);
@@ -0,0 +1,496 @@
+#include "MazeLibrary.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QMap>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+
+#include <algorithm>
+
+#include "FunctionTask.h"
+#include "MazeFileType.h"
+#include "MazeFileUtilities.h"
+#include "MazeUtilities.h"
+
+namespace mms {
+
+// Bump the version whenever the entry layout changes; old indices are then
+// ignored (and rebuilt) rather than misread
+static const quint32 INDEX_MAGIC = 0x4d5a4c49; // "MZLI"
+static const quint32 INDEX_VERSION = 2;
+
+MazeLibrary::MazeLibrary(QObject* parent) :
+        QAbstractTableModel(parent),
+        m_indexIsDirty(false),
+        m_generation(0),
+        m_scanIsFinished(false),
+        m_outstandingTasks(0) {
+    m_threadPool.setMaxThreadCount(QThread::idealThreadCount());
+    m_timer.setInterval(100);
+    connect(&m_timer, &QTimer::timeout, this, &MazeLibrary::applyPending);
+    loadIndex();
+}
+
+MazeLibrary::~MazeLibrary() {
+    {
+        QMutexLocker locker(&m_mutex);
+        m_generation += 1;
+    }
+    m_threadPool.clear();
+    m_threadPool.waitForDone();
+    if (m_indexIsDirty) {
+        saveIndex();
+    }
+}
+
+void MazeLibrary::refresh(const QStringList& files, const QStringList& directories) {
+
+    // Results from the previous refresh are no longer wanted
+    int generation = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_generation += 1;
+        generation = m_generation;
+        m_pendingEntries.clear();
+        m_scannedPaths.clear();
+        m_scanIsFinished = false;
+    }
+
+    // Show everything that the index already knows about, right away
+    beginResetModel();
+    m_entries.clear();
+    m_rows.clear();
+    auto show = [&](const MazeLibraryEntry& entry) {
+        if (!m_rows.contains(entry.path)) {
+            m_rows.insert(entry.path, m_entries.size());
+            m_entries.append(entry);
+        }
+    };
+    for (const QString& file : files) {
+        MazeLibraryEntry placeholder;
+        placeholder.path = file;
+        show(m_index.value(file, placeholder));
+    }
+    QStringList prefixes;
+    for (const QString& directory : directories) {
+        prefixes.append(QDir(directory).absolutePath() + "/");
+    }
+    for (const MazeLibraryEntry& entry : m_index) {
+        for (const QString& prefix : prefixes) {
+            if (entry.path.startsWith(prefix)) {
+                show(entry);
+                break;
+            }
+        }
+    }
+    endResetModel();
+
+    // Then find out what's missing or out of date
+    QHash<QString, MazeLibraryEntry> index = m_index;
+    QSet<QString> shown = QSet<QString>::fromList(m_rows.keys());
+    m_outstandingTasks.ref();
+    m_threadPool.start(new FunctionTask([=]() {
+        scan(generation, files, directories, index, shown);
+        m_outstandingTasks.deref();
+    }));
+    m_timer.start();
+}
+
+QString MazeLibrary::getPath(int row) const {
+    return m_entries.at(row).path;
+}
+
+int MazeLibrary::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : m_entries.size();
+}
+
+int MazeLibrary::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+QVariant MazeLibrary::data(const QModelIndex& index, int role) const {
+    static const QMap<MazeValidity, QString> validityToString = {
+        {MazeValidity::INVALID, "Invalid"},
+        {MazeValidity::DRAWABLE, "Drawable"},
+        {MazeValidity::EXPLORABLE, "Explorable"},
+        {MazeValidity::OFFICIAL, "Official"},
+    };
+    if (!index.isValid() || m_entries.size() <= index.row()) {
+        return QVariant();
+    }
+    const MazeLibraryEntry& entry = m_entries.at(index.row());
+    if (role == Qt::DecorationRole && index.column() == NAME) {
+        return entry.thumbnail.isNull() ? QVariant() : QVariant(entry.thumbnail);
+    }
+    if (role != Qt::DisplayRole && role != SORT_ROLE) {
+        return QVariant();
+    }
+
+    // Files that haven't been (successfully) loaded only have names
+    bool sort = role == SORT_ROLE;
+    bool known = entry.isIndexed && entry.isLoadable;
+    switch (index.column()) {
+        case NAME:
+            return entry.path.section('/', -1);
+        case SIZE:
+            if (sort) {
+                return known ? qint64(entry.width) * entry.height : qint64(-1);
+            }
+            return known ? QString("%1x%2").arg(entry.width).arg(entry.height) : QString();
+        case VALIDITY:
+            if (sort) {
+                return known ? static_cast<int>(entry.validity) : -1;
+            }
+            return (
+                known ? validityToString.value(entry.validity) :
+                entry.isIndexed ? QString("Unreadable") :
+                QString()
+            );
+        case MAX_DISTANCE:
+            if (sort) {
+                return known ? entry.maxDistance : -1;
+            }
+            return known ? QString::number(entry.maxDistance) : QString();
+        case HASH:
+            return known ? QString("%1").arg(entry.hash, 16, 16, QChar('0')) : QString();
+        case CANONICAL_HASH:
+            return (
+                known
+                ? QString("%1").arg(entry.canonicalHash, 16, 16, QChar('0'))
+                : QString()
+            );
+        case PATH:
+            return entry.path;
+    }
+    return QVariant();
+}
+
+QVariant MazeLibrary::headerData(
+        int section,
+        Qt::Orientation orientation,
+        int role) const {
+    static const QMap<int, QString> columnToString = {
+        {NAME, "File Name"},
+        {SIZE, "Size"},
+        {VALIDITY, "Validity"},
+        {MAX_DISTANCE, "Max Distance"},
+        {HASH, "Hash"},
+        {CANONICAL_HASH, "Canonical Hash"},
+        {PATH, "File Path"},
+    };
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    return columnToString.value(section);
+}
+
+QImage MazeLibrary::renderThumbnail(const PackedMaze& maze) {
+
+    int width = maze.getWidth();
+    int height = maze.getHeight();
+    if (width == 0 || height == 0) {
+        return QImage();
+    }
+
+    // Each post, wall, and tile gets a pixel; rows run from north to south
+    QImage image(2 * width + 1, 2 * height + 1, QImage::Format_Grayscale8);
+    image.fill(255);
+    auto setBlack = [&](int column, int row) {
+        image.scanLine(2 * height - row)[column] = 0;
+    };
+    for (int x = 0; x <= width; x += 1) {
+        for (int y = 0; y <= height; y += 1) {
+            setBlack(2 * x, 2 * y);
+            if (x < width && (
+                    y < height
+                    ? maze.isWall(x, y, Direction::SOUTH)
+                    : maze.isWall(x, height - 1, Direction::NORTH))) {
+                setBlack(2 * x + 1, 2 * y);
+            }
+            if (y < height && (
+                    x < width
+                    ? maze.isWall(x, y, Direction::WEST)
+                    : maze.isWall(width - 1, y, Direction::EAST))) {
+                setBlack(2 * x, 2 * y + 1);
+            }
+        }
+    }
+
+    // Small mazes are scaled up by whole pixels, to stay crisp
+    int longest = std::max(image.width(), image.height());
+    if (THUMBNAIL_SIZE < longest) {
+        return image.scaled(
+            THUMBNAIL_SIZE,
+            THUMBNAIL_SIZE,
+            Qt::KeepAspectRatio,
+            Qt::SmoothTransformation);
+    }
+    int factor = THUMBNAIL_SIZE / longest;
+    return image.scaled(image.width() * factor, image.height() * factor);
+}
+
+void MazeLibrary::scan(
+        int generation,
+        const QStringList& files,
+        const QStringList& directories,
+        const QHash<QString, MazeLibraryEntry>& index,
+        const QSet<QString>& shown) {
+
+    auto isCurrent = [this](int generation) {
+        QMutexLocker locker(&m_mutex);
+        return generation == m_generation;
+    };
+    auto push = [this](int generation, const MazeLibraryEntry& entry) {
+        QMutexLocker locker(&m_mutex);
+        if (generation == m_generation) {
+            m_pendingEntries.append(entry);
+        }
+    };
+
+    // Name filters are case-insensitive
+    QStringList nameFilters;
+    for (const QString& suffix : MAZE_FILE_TYPE_TO_SUFFIX()) {
+        nameFilters.append(QString("*.") + suffix);
+    }
+    QStringList paths = files;
+    for (const QString& directory : directories) {
+        QDirIterator iterator(
+            QDir(directory).absolutePath(),
+            nameFilters,
+            QDir::Files,
+            QDirIterator::Subdirectories);
+        while (iterator.hasNext() && isCurrent(generation)) {
+            paths.append(iterator.next());
+        }
+    }
+
+    // Only files that are new, or that changed, need to be loaded
+    QSet<QString> scanned;
+    for (const QString& path : paths) {
+        if (scanned.contains(path)) {
+            continue;
+        }
+        scanned.insert(path);
+        auto cached = index.constFind(path);
+        if (cached != index.constEnd() && isFresh(cached.value(), path)) {
+            if (!shown.contains(path)) {
+                push(generation, cached.value());
+            }
+            continue;
+        }
+        m_outstandingTasks.ref();
+        m_threadPool.start(new FunctionTask([=]() {
+            if (isCurrent(generation)) {
+                push(generation, indexFile(path));
+            }
+            m_outstandingTasks.deref();
+        }));
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (generation == m_generation) {
+        m_scannedPaths = scanned;
+        m_scanIsFinished = true;
+    }
+}
+
+void MazeLibrary::applyPending() {
+
+    // Workers push their results before they finish, so if nothing was
+    // outstanding beforehand, this takes the last of the results
+    bool isIdle = m_outstandingTasks.load() == 0;
+    QVector<MazeLibraryEntry> entries;
+    QSet<QString> scanned;
+    bool scanIsFinished = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        entries.swap(m_pendingEntries);
+        scanIsFinished = m_scanIsFinished;
+        if (scanIsFinished) {
+            scanned.swap(m_scannedPaths);
+            m_scanIsFinished = false;
+        }
+    }
+
+    // Update the rows that are already shown, and add the rest all at once
+    QVector<MazeLibraryEntry> added;
+    for (const MazeLibraryEntry& entry : entries) {
+        const MazeLibraryEntry& cached = m_index.value(entry.path);
+        if (!cached.isIndexed ||
+                cached.lastModified != entry.lastModified ||
+                cached.fileSize != entry.fileSize) {
+            m_index.insert(entry.path, entry);
+            m_indexIsDirty = true;
+        }
+        int row = m_rows.value(entry.path, -1);
+        if (row == -1) {
+            added.append(entry);
+            continue;
+        }
+        m_entries[row] = entry;
+        emit dataChanged(index(row, 0), index(row, COLUMN_COUNT - 1));
+    }
+    if (!added.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size() + added.size() - 1);
+        for (const MazeLibraryEntry& entry : added) {
+            m_rows.insert(entry.path, m_entries.size());
+            m_entries.append(entry);
+        }
+        endInsertRows();
+    }
+
+    // Once the scan is done, drop the files that are gone, both from the
+    // table and from the index
+    if (scanIsFinished) {
+        for (int row = m_entries.size() - 1; 0 <= row; row -= 1) {
+            if (!scanned.contains(m_entries.at(row).path)) {
+                beginRemoveRows(QModelIndex(), row, row);
+                m_entries.remove(row);
+                endRemoveRows();
+            }
+        }
+        m_rows.clear();
+        for (int row = 0; row < m_entries.size(); row += 1) {
+            m_rows.insert(m_entries.at(row).path, row);
+        }
+        for (auto it = m_index.begin(); it != m_index.end();) {
+            if (scanned.contains(it.key())) {
+                ++it;
+                continue;
+            }
+            it = m_index.erase(it);
+            m_indexIsDirty = true;
+        }
+    }
+
+    if (isIdle) {
+        m_timer.stop();
+        if (m_indexIsDirty) {
+            saveIndex();
+        }
+    }
+}
+
+MazeLibraryEntry MazeLibrary::indexFile(const QString& path) {
+    MazeLibraryEntry entry;
+    QFileInfo info(path);
+    entry.path = path;
+    entry.lastModified = info.lastModified().toMSecsSinceEpoch();
+    entry.fileSize = info.size();
+    entry.isIndexed = true;
+    try {
+        MazeMetadata metadata;
+        PackedMaze maze = MazeFileUtilities::load(path, &metadata);
+        entry.isLoadable = true;
+        entry.width = maze.getWidth();
+        entry.height = maze.getHeight();
+        entry.hash = maze.getHash();
+        entry.canonicalHash = maze.getCanonicalHash();
+        entry.validity = (
+            metadata.isAvailable
+            ? metadata.validity
+            : MazeChecker::checkMaze(maze)
+        );
+        QVector<int> distances = (
+            metadata.isAvailable
+            ? metadata.distances
+            : MazeUtilities::getDistancesToCenter(maze)
+        );
+        entry.maxDistance = 0;
+        for (int distance : distances) {
+            entry.maxDistance = std::max(entry.maxDistance, distance);
+        }
+        entry.thumbnail = renderThumbnail(maze);
+    }
+    catch (const std::exception& e) {
+        entry.isLoadable = false;
+    }
+    return entry;
+}
+
+bool MazeLibrary::isFresh(const MazeLibraryEntry& entry, const QString& path) {
+    QFileInfo info(path);
+    return (
+        entry.isIndexed &&
+        entry.lastModified == info.lastModified().toMSecsSinceEpoch() &&
+        entry.fileSize == info.size()
+    );
+}
+
+QString MazeLibrary::getIndexPath() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+        "/maze-library.index";
+}
+
+void MazeLibrary::loadIndex() {
+    QFile file(getIndexPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 count = 0;
+    in >> magic >> version >> count;
+    if (magic != INDEX_MAGIC || version != INDEX_VERSION) {
+        return;
+    }
+    QHash<QString, MazeLibraryEntry> index;
+    for (int i = 0; i < count && in.status() == QDataStream::Ok; i += 1) {
+        MazeLibraryEntry entry;
+        qint32 width = 0;
+        qint32 height = 0;
+        qint32 validity = 0;
+        qint32 maxDistance = 0;
+        in >> entry.path >> entry.lastModified >> entry.fileSize
+            >> entry.isIndexed >> entry.isLoadable >> width >> height
+            >> validity >> maxDistance >> entry.hash >> entry.canonicalHash
+            >> entry.thumbnail;
+        entry.width = width;
+        entry.height = height;
+        entry.validity = static_cast<MazeValidity>(validity);
+        entry.maxDistance = maxDistance;
+        index.insert(entry.path, entry);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qWarning().noquote().nospace()
+            << "Ignoring the corrupt maze library index \"" << getIndexPath() << "\".";
+        return;
+    }
+    m_index = index;
+}
+
+void MazeLibrary::saveIndex() {
+    m_indexIsDirty = false;
+    QDir().mkpath(QFileInfo(getIndexPath()).absolutePath());
+    QSaveFile file(getIndexPath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning().noquote().nospace()
+            << "Unable to write the maze library index \"" << getIndexPath() << "\".";
+        return;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << INDEX_MAGIC << INDEX_VERSION << static_cast<qint32>(m_index.size());
+    for (const MazeLibraryEntry& entry : m_index) {
+        out << entry.path << entry.lastModified << entry.fileSize
+            << entry.isIndexed << entry.isLoadable
+            << static_cast<qint32>(entry.width)
+            << static_cast<qint32>(entry.height)
+            << static_cast<qint32>(entry.validity)
+            << static_cast<qint32>(entry.maxDistance)
+            << entry.hash << entry.canonicalHash << entry.thumbnail;
+    }
+    if (!file.commit()) {
+        qWarning().noquote().nospace()
+            << "Unable to write the maze library index \"" << getIndexPath() << "\".";
+    }
+}
+
+} // namespace mms
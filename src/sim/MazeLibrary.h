@@ -0,0 +1,123 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QAtomicInt>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+
+#include "MazeChecker.h"
+#include "PackedMaze.h"
+
+namespace mms {
+
+// What the library knows about a maze file. An entry is stale once the
+// file's modification time or size no longer match.
+struct MazeLibraryEntry {
+    QString path;
+    qint64 lastModified = 0;
+    qint64 fileSize = -1;
+    // False until the file has been loaded and checked at least once
+    bool isIndexed = false;
+    bool isLoadable = false;
+    int width = 0;
+    int height = 0;
+    MazeValidity validity = MazeValidity::INVALID;
+    int maxDistance = -1;
+    quint64 hash = 0;
+    // The same for all eight rotations and mirrorings of the maze, so that
+    // copies of a maze can be found however they were drawn
+    quint64 canonicalHash = 0;
+    QImage thumbnail;
+};
+
+// All of the maze files that the simulator knows about, as a table model.
+// Rows come from an on-disk index, so they're available immediately; a pool
+// of background workers then scans the directories, and loads, checks, and
+// renders a thumbnail of each file that's new or changed since it was last
+// indexed. Results are applied in batches, on the GUI thread.
+class MazeLibrary : public QAbstractTableModel {
+
+    Q_OBJECT
+
+public:
+
+    enum Column {
+        NAME,
+        SIZE,
+        VALIDITY,
+        MAX_DISTANCE,
+        HASH,
+        CANONICAL_HASH,
+        PATH,
+        COLUMN_COUNT,
+    };
+
+    // Each cell's sort key, so that e.g. sizes sort by area
+    static const int SORT_ROLE = Qt::UserRole;
+
+    // The longest side of a thumbnail, in pixels
+    static const int THUMBNAIL_SIZE = 48;
+
+    MazeLibrary(QObject* parent = nullptr);
+    ~MazeLibrary();
+
+    // Shows the given files, along with every maze file in (or under) the
+    // given directories, and starts indexing whatever is out of date
+    void refresh(const QStringList& files, const QStringList& directories);
+    QString getPath(int row) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+    QVariant headerData(
+        int section,
+        Qt::Orientation orientation,
+        int role = Qt::DisplayRole) const;
+
+    static QImage renderThumbnail(const PackedMaze& maze);
+
+private:
+
+    // Only touched on the GUI thread
+    QVector<MazeLibraryEntry> m_entries;
+    QHash<QString, int> m_rows;
+    QHash<QString, MazeLibraryEntry> m_index;
+    bool m_indexIsDirty;
+
+    // Results from the workers, waiting to be applied; results from an
+    // earlier refresh are dropped
+    QMutex m_mutex;
+    int m_generation;
+    QVector<MazeLibraryEntry> m_pendingEntries;
+    QSet<QString> m_scannedPaths;
+    bool m_scanIsFinished;
+
+    QThreadPool m_threadPool;
+    QAtomicInt m_outstandingTasks;
+    QTimer m_timer;
+
+    void scan(
+        int generation,
+        const QStringList& files,
+        const QStringList& directories,
+        const QHash<QString, MazeLibraryEntry>& index,
+        const QSet<QString>& shown);
+    void applyPending();
+
+    // Loads and checks the file, never throwing
+    static MazeLibraryEntry indexFile(const QString& path);
+    static bool isFresh(const MazeLibraryEntry& entry, const QString& path);
+
+    static QString getIndexPath();
+    void loadIndex();
+    void saveIndex();
+};
+
+} // namespace mms
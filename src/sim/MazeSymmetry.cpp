@@ -0,0 +1,116 @@
+#include "MazeSymmetry.h"
+
+#include <utility>
+
+#include "ContainerUtilities.h"
+
+namespace mms {
+
+const QVector<MazeSymmetry>& MAZE_SYMMETRIES() {
+    static const QVector<MazeSymmetry> vector = {
+        MazeSymmetry::IDENTITY,
+        MazeSymmetry::ROTATE_90,
+        MazeSymmetry::ROTATE_180,
+        MazeSymmetry::ROTATE_270,
+        MazeSymmetry::MIRROR,
+        MazeSymmetry::MIRROR_ROTATE_90,
+        MazeSymmetry::MIRROR_ROTATE_180,
+        MazeSymmetry::MIRROR_ROTATE_270,
+    };
+    return vector;
+}
+
+const QMap<MazeSymmetry, QString>& MAZE_SYMMETRY_TO_STRING() {
+    static const QMap<MazeSymmetry, QString> map = {
+        {MazeSymmetry::IDENTITY, "identity"},
+        {MazeSymmetry::ROTATE_90, "rotate-90"},
+        {MazeSymmetry::ROTATE_180, "rotate-180"},
+        {MazeSymmetry::ROTATE_270, "rotate-270"},
+        {MazeSymmetry::MIRROR, "mirror"},
+        {MazeSymmetry::MIRROR_ROTATE_90, "mirror-rotate-90"},
+        {MazeSymmetry::MIRROR_ROTATE_180, "mirror-rotate-180"},
+        {MazeSymmetry::MIRROR_ROTATE_270, "mirror-rotate-270"},
+    };
+    return map;
+}
+
+const QMap<QString, MazeSymmetry>& STRING_TO_MAZE_SYMMETRY() {
+    static const QMap<QString, MazeSymmetry> map =
+        ContainerUtilities::inverse(MAZE_SYMMETRY_TO_STRING());
+    return map;
+}
+
+MazeSymmetryMap::MazeSymmetryMap() : MazeSymmetryMap(MazeSymmetry::IDENTITY, 0, 0) {
+}
+
+MazeSymmetryMap::MazeSymmetryMap(MazeSymmetry symmetry, int width, int height) :
+        m_symmetry(symmetry),
+        m_width(width),
+        m_height(height),
+        m_xx(1),
+        m_xy(0),
+        m_x0(0),
+        m_yx(0),
+        m_yy(1),
+        m_y0(0) {
+
+    for (int i = 0; i < 4; i += 1) {
+        m_directions[i] = DIRECTIONS().at(i);
+    }
+
+    // The symmetries are listed unmirrored first, a quarter turn apart
+    int index = MAZE_SYMMETRIES().indexOf(symmetry);
+    m_isMirrored = 4 <= index;
+    int rotations = index % 4;
+
+    // Mirroring maps (x, y) to (w - 1 - x, y), and swaps east and west
+    if (m_isMirrored) {
+        compose(-1, 0, m_width - 1, 0, 1, 0);
+        std::swap(m_directions[1], m_directions[3]);
+    }
+
+    // Each quarter turn maps (x, y) to (y, h - 1 - x), which makes the view
+    // h x w, and shows the maze's east as its north
+    for (int i = 0; i < rotations; i += 1) {
+        compose(0, 1, 0, -1, 0, m_height - 1);
+        std::swap(m_width, m_height);
+        Direction north = m_directions[0];
+        for (int j = 0; j < 3; j += 1) {
+            m_directions[j] = m_directions[j + 1];
+        }
+        m_directions[3] = north;
+    }
+}
+
+MazeSymmetry MazeSymmetryMap::getSymmetry() const {
+    return m_symmetry;
+}
+
+bool MazeSymmetryMap::isMirrored() const {
+    return m_isMirrored;
+}
+
+int MazeSymmetryMap::getWidth() const {
+    return m_width;
+}
+
+int MazeSymmetryMap::getHeight() const {
+    return m_height;
+}
+
+void MazeSymmetryMap::compose(int xx, int xy, int x0, int yx, int yy, int y0) {
+    int newXx = m_xx * xx + m_xy * yx;
+    int newXy = m_xx * xy + m_xy * yy;
+    int newX0 = m_xx * x0 + m_xy * y0 + m_x0;
+    int newYx = m_yx * xx + m_yy * yx;
+    int newYy = m_yx * xy + m_yy * yy;
+    int newY0 = m_yx * x0 + m_yy * y0 + m_y0;
+    m_xx = newXx;
+    m_xy = newXy;
+    m_x0 = newX0;
+    m_yx = newYx;
+    m_yy = newYy;
+    m_y0 = newY0;
+}
+
+} // namespace mms
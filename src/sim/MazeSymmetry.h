@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+#include "Direction.h"
+
+namespace mms {
+
+// The eight ways to turn a maze over: mirrored across the vertical (or not),
+// and then rotated counter-clockwise by some number of quarter turns
+enum class MazeSymmetry {
+    IDENTITY,
+    ROTATE_90,
+    ROTATE_180,
+    ROTATE_270,
+    MIRROR,
+    MIRROR_ROTATE_90,
+    MIRROR_ROTATE_180,
+    MIRROR_ROTATE_270,
+};
+
+const QVector<MazeSymmetry>& MAZE_SYMMETRIES();
+
+const QMap<MazeSymmetry, QString>& MAZE_SYMMETRY_TO_STRING();
+const QMap<QString, MazeSymmetry>& STRING_TO_MAZE_SYMMETRY();
+
+// Maps the tiles and walls of a symmetric view of a maze back to those of the
+// maze itself, so that the view can be read without copying anything. The
+// mapping is affine, so a lookup is a couple of multiply-adds.
+class MazeSymmetryMap {
+
+public:
+
+    // The width and height are those of the maze, not the view
+    MazeSymmetryMap();
+    MazeSymmetryMap(MazeSymmetry symmetry, int width, int height);
+
+    MazeSymmetry getSymmetry() const;
+
+    // Whether or not the view is mirrored, in which case turning right in
+    // the view is turning left in the maze
+    bool isMirrored() const;
+
+    // The size of the view
+    int getWidth() const;
+    int getHeight() const;
+
+    inline int toSourceX(int x, int y) const {
+        return m_xx * x + m_xy * y + m_x0;
+    }
+    inline int toSourceY(int x, int y) const {
+        return m_yx * x + m_yy * y + m_y0;
+    }
+    inline Direction toSource(Direction direction) const {
+        return m_directions[static_cast<int>(direction)];
+    }
+
+private:
+
+    MazeSymmetry m_symmetry;
+    bool m_isMirrored;
+    int m_width;
+    int m_height;
+
+    // The source position is (m_xx * x + m_xy * y + m_x0, m_yx * x + ...)
+    int m_xx;
+    int m_xy;
+    int m_x0;
+    int m_yx;
+    int m_yy;
+    int m_y0;
+
+    // Indexed by the view direction
+    Direction m_directions[4];
+
+    // Follows the given map (from the next view to the current one) with
+    // this one (from the current view to the maze)
+    void compose(int xx, int xy, int x0, int yx, int yy, int y0);
+};
+
+} // namespace mms
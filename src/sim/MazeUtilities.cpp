@@ -55,4 +55,61 @@ QPair<int, int> MazeUtilities::positionAfterMovingForward(
     };
 }
 
+QVector<int> MazeUtilities::getDistancesToCenter(const PackedMaze& walls) {
+    return getDistancesToGoal(
+        walls,
+        getCenterPositions(walls.getWidth(), walls.getHeight()));
+}
+
+QVector<int> MazeUtilities::getDistancesToGoal(
+        const PackedMaze& walls,
+        const QVector<QPair<int, int>>& goal) {
+
+    // TODO: MACK - dedup some of this with hasNoInaccessibleLocations
+
+    int width = walls.getWidth();
+    int height = walls.getHeight();
+    QVector<int> distances(width * height, -1);
+    if (distances.isEmpty()) {
+        return distances;
+    }
+
+    // The queue for the BFS, as tile indices; every tile is enqueued at most
+    // once, so the queue is just a vector that's read from front to back
+    QVector<int> discovered;
+    discovered.reserve(distances.size());
+
+    // Set the distances of the goal tiles and push them to the queue
+    for (const QPair<int, int>& position : goal) {
+        int index = position.first * height + position.second;
+        if (distances.at(index) == -1) {
+            distances[index] = 0;
+            discovered.append(index);
+        }
+    }
+
+    // Now do a BFS
+    for (int i = 0; i < discovered.size(); i += 1) {
+        int x = discovered.at(i) / height;
+        int y = discovered.at(i) % height;
+        int distance = distances.at(discovered.at(i));
+        for (Direction direction : DIRECTIONS()) {
+            if (walls.isWall(x, y, direction)) {
+                continue;
+            }
+            QPair<int, int> neighbor = positionAfterMovingForward({x, y}, direction);
+            if (!walls.withinMaze(neighbor.first, neighbor.second)) {
+                continue;
+            }
+            int index = neighbor.first * height + neighbor.second;
+            if (distances.at(index) == -1) {
+                distances[index] = distance + 1;
+                discovered.append(index);
+            }
+        }
+    }
+
+    return distances;
+}
+
 } // namespace mms
@@ -4,6 +4,7 @@
 #include <QVector>
 
 #include "Direction.h"
+#include "PackedMaze.h"
 
 namespace mms {
 
@@ -19,6 +20,16 @@ public:
         QPair<int, int> position,
         Direction direction);
 
+    // The BFS distance of each tile from the nearest center tile, indexed
+    // by x * height + y, or -1 for tiles that can't reach the center
+    static QVector<int> getDistancesToCenter(const PackedMaze& walls);
+
+    // The same, from the nearest of the given tiles, which must be within
+    // the maze; it's a BFS with all of them as its sources
+    static QVector<int> getDistancesToGoal(
+        const PackedMaze& walls,
+        const QVector<QPair<int, int>>& goal);
+
 };
 
 } // namespace mms
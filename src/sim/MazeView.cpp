@@ -13,10 +13,15 @@ MazeView::MazeView(
         bool tileFogVisible,
         bool tileTextVisible,
         bool autopopulateTextWithDistance) :
+        m_tileImage(
+            P()->maxPolygonRenderingTiles() < maze->getWidth() * maze->getHeight()
+            ? TileImage(maze->getWidth(), maze->getHeight())
+            : TileImage()),
         m_bufferInterface(
             {maze->getWidth(), maze->getHeight()},
             &m_graphicCpuBuffer,
-            &m_textureCpuBuffer),
+            &m_textureCpuBuffer,
+            m_tileImage.isNull() ? nullptr : &m_tileImage),
         m_mazeGraphic(
             maze,
             &m_bufferInterface,
@@ -30,6 +35,11 @@ MazeView::MazeView(
     initText(2, 4);
 
     // Populate the data vectors with wall polygons and tile distance text.
+    // Each tile is ten rectangles (base, four walls, four corners and fog),
+    // so we know the size of the graphic buffer up front.
+    if (m_tileImage.isNull()) {
+        m_graphicCpuBuffer.reserve(20 * maze->getWidth() * maze->getHeight());
+    }
     m_mazeGraphic.drawPolygons();
     m_mazeGraphic.drawTextures();
 }
@@ -50,6 +60,10 @@ const QVector<TriangleTexture>* MazeView::getTextureCpuBuffer() const {
     return &m_textureCpuBuffer;
 }
 
+const TileImage* MazeView::getTileImage() const {
+    return m_tileImage.isNull() ? nullptr : &m_tileImage;
+}
+
 void MazeView::initText(int numRows, int numCols) {
 
     // Initialze the tile text in the buffer class,
@@ -5,6 +5,7 @@
 #include "BufferInterface.h"
 #include "Maze.h"
 #include "MazeGraphic.h"
+#include "TileImage.h"
 #include "TriangleGraphic.h"
 #include "TriangleTexture.h"
 
@@ -27,11 +28,16 @@ public:
     const QVector<TriangleGraphic>* getGraphicCpuBuffer() const;
     const QVector<TriangleTexture>* getTextureCpuBuffer() const;
 
+    // Null unless the maze is too large to be drawn polygon by polygon, in
+    // which case the cpu buffers above are empty
+    const TileImage* getTileImage() const;
+
 private:
 
     // These vectors contain the triangles that will actually be drawn
     QVector<TriangleGraphic> m_graphicCpuBuffer;
     QVector<TriangleTexture> m_textureCpuBuffer;
+    TileImage m_tileImage;
 
     // The buffer interface provides abstractions which the MazeGraphic
     // uses to populate the vector of TriangleGraphic objects
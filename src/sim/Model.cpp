@@ -16,8 +16,10 @@ Model::Model() :
     m_maze(nullptr),
     m_mouse(nullptr),
     m_stats(nullptr),
+    m_trail(nullptr),
     m_paused(false),
-    m_simSpeed(1.0) {
+    m_simSpeed(1.0),
+    m_stepCount(0) {
     ASSERT_RUNS_JUST_ONCE();
 }
 
@@ -46,6 +48,8 @@ void Model::update(double dt) {
         return;
     }
 
+    m_stepCount += 1;
+
     // Calculate the amount of sim time that should pass during this iteration
     Duration elapsedSimTimeForThisIteration = Duration::Seconds(dt);
 
@@ -67,15 +71,20 @@ void Model::update(double dt) {
         return;
     }
 
-    // Retrieve the tile at current location
-    const Tile* tileAtLocation = m_maze->getTile(location.first, location.second);
-
-    // If this is a new tile, update the set of traversed tiles
-    if (!m_stats->traversedTileLocations.contains(location)) {
-        m_stats->traversedTileLocations.insert(location);
+    // Record where the mouse has been, and if this is a new tile, update
+    // the stats that only change when one is traversed
+    bool isNewTile = m_trail->update(
+        elapsedSimTimeForThisIteration,
+        m_mouse->getCurrentTranslation(),
+        m_mouse->getCurrentRotation(),
+        location.first,
+        location.second);
+    if (isNewTile) {
+        int distance = m_maze->getDistance(location.first, location.second);
+        m_stats->numberOfTraversedTiles += 1;
         if (m_stats->closestDistanceToCenter == -1 ||
-                tileAtLocation->getDistance() < m_stats->closestDistanceToCenter) {
-            m_stats->closestDistanceToCenter = tileAtLocation->getDistance(); 
+                distance < m_stats->closestDistanceToCenter) {
+            m_stats->closestDistanceToCenter = distance;
         }
         // Alert any listeners that a new tile was entered
         emit newTileLocationTraversed(location.first, location.second);
@@ -91,8 +100,8 @@ void Model::update(double dt) {
         m_stats->timeOfOriginDeparture = SimTime::get()->elapsedSimTime();
     }
 
-    // Separately, if we're in the center, update the best time to center
-    if (m_maze->isCenterTile(location.first, location.second)) {
+    // Separately, if we're in the goal, update the best time to center
+    if (m_maze->isGoalTile(location.first, location.second)) {
         Duration timeToCenter = SimTime::get()->elapsedSimTime() - m_stats->timeOfOriginDeparture;
         if (
             m_stats->bestTimeToCenter < Duration::Seconds(0) ||
@@ -109,7 +118,9 @@ void Model::update(double dt) {
 void Model::setMaze(const Maze* maze) {
     m_mutex.lock();
     delete m_stats;
+    delete m_trail;
     m_stats = nullptr;
+    m_trail = nullptr;
     m_mouse = nullptr;
     m_maze = maze;
     m_mutex.unlock();
@@ -122,6 +133,11 @@ void Model::setMouse(Mouse* mouse) {
     ASSERT_TR(m_stats == nullptr);
     m_mouse = mouse;
     m_stats = new MouseStats();
+    m_trail = new MouseTrail(
+        m_maze->getWidth(),
+        m_maze->getHeight(),
+        P()->trailCapacity(),
+        Duration::Seconds(P()->trailInterval()));
     SimTime::get()->reset();
     m_mutex.unlock();
 }
@@ -135,7 +151,9 @@ void Model::removeMouse() {
     ASSERT_FA(m_mouse == nullptr);
     ASSERT_FA(m_stats == nullptr);
     delete m_stats;
+    delete m_trail;
     m_stats = nullptr;
+    m_trail = nullptr;
     m_mouse = nullptr;
     m_mutex.unlock();
 }
@@ -150,6 +168,21 @@ MouseStats Model::getMouseStats() const {
     return stats;
 }
 
+bool Model::writeMouseTimeline(const QString& path) const {
+    m_mutex.lock();
+    bool success = m_trail != nullptr && m_trail->writeTimeline(path);
+    m_mutex.unlock();
+    return success;
+}
+
+qint64 Model::getStepCount() const {
+    return m_stepCount;
+}
+
+const MouseTrail* Model::getMouseTrail() const {
+    return m_trail;
+}
+
 void Model::setPaused(bool paused) {
     m_paused = paused;
 }
@@ -6,6 +6,7 @@
 #include "Maze.h"
 #include "Mouse.h"
 #include "MouseStats.h"
+#include "MouseTrail.h"
 
 namespace mms {
 
@@ -22,8 +23,19 @@ public:
     void setMouse(Mouse* mouse);
     void removeMouse();
 
+    // A copy of a few scalars; the per-tile stats are in the mouse trail
     MouseStats getMouseStats() const;
 
+    // Writes the mouse trail's timeline, while the model is held still;
+    // returns false if there's no mouse or it can't be written
+    bool writeMouseTimeline(const QString& path) const;
+
+    // The number of fixed timesteps simulated so far
+    qint64 getStepCount() const;
+
+    // Owned by the model; valid until the mouse or maze is changed
+    const MouseTrail* getMouseTrail() const;
+
     void setPaused(bool paused);
     void setSimSpeed(double factor);
 
@@ -43,9 +55,11 @@ private:
     const Maze* m_maze;
     Mouse* m_mouse;
     MouseStats* m_stats;
+    MouseTrail* m_trail;
 
     bool m_paused;
     double m_simSpeed;
+    qint64 m_stepCount;
 
     void checkCollision();
 };
@@ -135,6 +135,10 @@ const Coordinate& Mouse::getInitialTranslation() const {
     return m_initialTranslation;
 }
 
+const Angle& Mouse::getInitialRotation() const {
+    return m_initialRotation;
+}
+
 const Coordinate& Mouse::getCurrentTranslation() const {
     return m_currentTranslation;
 }
@@ -312,6 +316,28 @@ const AngularVelocity& Mouse::getWheelMaxSpeed(const QString& name) {
     return m_wheels[name].getMaximumSpeed();
 }
 
+Speed Mouse::getMaximumForwardSpeed() const {
+    // Each wheel's effect is proportional to its speed, which is the
+    // fraction of its maximum that setWheelSpeedsForMovement() gives it
+    Speed speed;
+    QMap<QString, Wheel>::const_iterator it;
+    for (it = m_wheels.constBegin(); it != m_wheels.constEnd(); it += 1) {
+        speed += it.value().getMaximumEffect().forwardEffect *
+            m_wheelSpeedAdjustmentFactors.value(it.key()).first;
+    }
+    return Speed::MetersPerSecond(std::abs(speed.getMetersPerSecond()));
+}
+
+AngularVelocity Mouse::getMaximumTurnSpeed() const {
+    AngularVelocity speed;
+    QMap<QString, Wheel>::const_iterator it;
+    for (it = m_wheels.constBegin(); it != m_wheels.constEnd(); it += 1) {
+        speed += it.value().getMaximumEffect().turnEffect *
+            m_wheelSpeedAdjustmentFactors.value(it.key()).second;
+    }
+    return AngularVelocity::RadiansPerSecond(std::abs(speed.getRadiansPerSecond()));
+}
+
 void Mouse::setWheelSpeeds(const QMap<QString, AngularVelocity>& wheelSpeeds) {
     m_mutex.lock();
     QMap<QString, AngularVelocity>::const_iterator it;
@@ -49,8 +49,9 @@ public:
     // Set the direction that the mouse should face whenever reset
     void setStartingDirection(Direction startingDirection);
 
-    // Gets the initial translation of the mouse
+    // Gets the initial translation and rotation of the mouse
     const Coordinate& getInitialTranslation() const;
+    const Angle& getInitialRotation() const;
 
     // Gets the current translation and rotation of the mouse
     const Coordinate& getCurrentTranslation() const;
@@ -102,6 +103,14 @@ public:
     // intentionally not const to avoid making copies of Wheel objects.
     const AngularVelocity& getWheelMaxSpeed(const QString& name);
 
+    // The fastest the mouse can move forward, and turn in place, with its
+    // wheels set by setWheelSpeedsForMoveForward() and the like. Any other
+    // movement is a mix of the two, such that a curve turn through an angle
+    // takes as long as turning in place through it and then moving forward
+    // along the length of the arc.
+    Speed getMaximumForwardSpeed() const;
+    AngularVelocity getMaximumTurnSpeed() const;
+
     // An atomic interface for setting the wheel speeds
     void setWheelSpeeds(const QMap<QString, AngularVelocity>& wheelSpeeds);
 
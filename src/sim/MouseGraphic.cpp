@@ -8,67 +8,79 @@ namespace mms {
 
 MouseGraphic::MouseGraphic(const Mouse* mouse) :
     m_mouse(mouse) {
-}
-
-Coordinate MouseGraphic::getInitialMouseTranslation() const {
-    return m_mouse->getInitialTranslation();
-}
-
-QPair<Coordinate, Angle> MouseGraphic::getCurrentMousePosition() const {
-    return {
-        m_mouse->getCurrentTranslation(),
-        m_mouse->getCurrentRotation(),
-    };
-}
 
-QVector<TriangleGraphic> MouseGraphic::draw(
-        const Coordinate& currentTranslation,
-        const Angle& currentRotation) const {
-
-    QVector<TriangleGraphic> buffer;
+    // Polygons retrieved at the initial translation and rotation are exactly
+    // the parsed polygons, so these calls don't perform any transformations
+    const Coordinate& translation = m_mouse->getInitialTranslation();
+    const Angle& rotation = m_mouse->getInitialRotation();
 
     // First, we draw the body
-    buffer.append(SimUtilities::polygonToTriangleGraphics(
-        m_mouse->getCurrentBodyPolygon(currentTranslation, currentRotation),
+    m_staticBuffer.append(SimUtilities::polygonToTriangleGraphics(
+        toLocalFrame(m_mouse->getCurrentBodyPolygon(translation, rotation)),
         ColorManager::get()->getMouseBodyColor(), 1.0));
 
     // Next, draw the center of mass
-    buffer.append(SimUtilities::polygonToTriangleGraphics(
-        m_mouse->getCurrentCenterOfMassPolygon(currentTranslation, currentRotation),
+    m_staticBuffer.append(SimUtilities::polygonToTriangleGraphics(
+        toLocalFrame(m_mouse->getCurrentCenterOfMassPolygon(translation, rotation)),
         ColorManager::get()->getMouseCenterOfMassColor(), 1.0));
 
     // Next, we draw the wheels
     for (const Polygon& wheelPolygon :
-            m_mouse->getCurrentWheelPolygons(currentTranslation, currentRotation)) {
-        buffer.append(SimUtilities::polygonToTriangleGraphics(
-            wheelPolygon,
+            m_mouse->getCurrentWheelPolygons(translation, rotation)) {
+        m_staticBuffer.append(SimUtilities::polygonToTriangleGraphics(
+            toLocalFrame(wheelPolygon),
             ColorManager::get()->getMouseWheelColor(), 1.0));
     }
 
-    // Next, we draw the sensors
+    // Lastly, we draw the sensors
     for (const Polygon& sensorPolygon :
-            m_mouse->getCurrentSensorPolygons(currentTranslation, currentRotation)) {
-        buffer.append(SimUtilities::polygonToTriangleGraphics(
-            sensorPolygon,
+            m_mouse->getCurrentSensorPolygons(translation, rotation)) {
+        m_staticBuffer.append(SimUtilities::polygonToTriangleGraphics(
+            toLocalFrame(sensorPolygon),
             ColorManager::get()->getMouseSensorColor(), 1.0));
     }
 
-    // Lastly, we draw the sensor views
+    // Uncomment to draw collision polygon
+    /*
+    m_staticBuffer.append(SimUtilities::polygonToTriangleGraphics(
+        toLocalFrame(m_mouse->getCurrentCollisionPolygon(translation, rotation)),
+        Color::GRAY, .5);
+    */
+}
+
+Coordinate MouseGraphic::getInitialMouseTranslation() const {
+    return m_mouse->getInitialTranslation();
+}
+
+QPair<Coordinate, Angle> MouseGraphic::getCurrentMousePosition() const {
+    return {
+        m_mouse->getCurrentTranslation(),
+        m_mouse->getCurrentRotation(),
+    };
+}
+
+const QVector<TriangleGraphic>& MouseGraphic::getStaticBuffer() const {
+    return m_staticBuffer;
+}
+
+QVector<TriangleGraphic> MouseGraphic::drawSensorViews(
+        const Coordinate& currentTranslation,
+        const Angle& currentRotation) const {
+    QVector<TriangleGraphic> buffer;
     for (const Polygon& polygon :
             m_mouse->getCurrentSensorViewPolygons(currentTranslation, currentRotation)) {
         buffer.append(SimUtilities::polygonToTriangleGraphics(
             polygon,
             ColorManager::get()->getMouseVisionColor(), 1.0));
     }
-
-    // Uncomment to draw collision polygon
-    /*
-    buffer.append(SimUtilities::polygonToTriangleGraphics(
-        m_mouse->getCurrentCollisionPolygon(currentTranslation, currentRotation),
-        Color::GRAY, .5);
-    */
-
     return buffer;
 }
 
+Polygon MouseGraphic::toLocalFrame(const Polygon& polygon) const {
+    // Note that translate and rotateAroundPoint preserve the triangulation
+    return polygon
+        .translate(Coordinate() - m_mouse->getInitialTranslation())
+        .rotateAroundPoint(Angle() - m_mouse->getInitialRotation(), Coordinate());
+}
+
 } // namespace mms
@@ -19,13 +19,25 @@ public:
     Coordinate getInitialMouseTranslation() const;
     QPair<Coordinate, Angle> getCurrentMousePosition() const;
 
-    QVector<TriangleGraphic> draw(
+    // The rigid parts of the mouse (body, center of mass, wheels, and
+    // sensors), triangulated once in the mouse's local frame, i.e., with the
+    // mouse centered at the origin and facing east. These are posed on the
+    // GPU via TransformationMatrix::getMouseTransformationMatrix.
+    const QVector<TriangleGraphic>& getStaticBuffer() const;
+
+    // The sensor views depend on the walls around the mouse, so they can't be
+    // cached like the rest of the mouse; these are in the physical frame.
+    QVector<TriangleGraphic> drawSensorViews(
         const Coordinate& currentTranslation,
         const Angle& currentRotation) const;
 
 private:
 
     const Mouse* m_mouse;
+    QVector<TriangleGraphic> m_staticBuffer;
+
+    // Moves a polygon from the mouse's initial pose to its local frame
+    Polygon toLocalFrame(const Polygon& polygon) const;
 
 };
 
@@ -30,7 +30,12 @@ MouseInterface::MouseInterface(
         m_interfaceType(InterfaceType::DISCRETE),
         m_interfaceTypeFinalized(false),
         m_inOrigin(true),
-        m_wheelSpeedFraction(1.0) {
+        m_wheelSpeedFraction(1.0),
+        m_commandCount(0) {
+}
+
+qint64 MouseInterface::getCommandCount() const {
+    return m_commandCount;
 }
 
 void MouseInterface::emitMouseAlgoStarted() {
@@ -51,6 +56,8 @@ QString MouseInterface::dispatch(const QString& command) {
     static const QString NO_ACK_STRING = "";
     static const QString ERROR_STRING = "!";
 
+    m_commandCount += 1;
+
     QStringList tokens = command.split(" ", QString::SkipEmptyParts);
     QString function = tokens.at(0);
 
@@ -465,7 +472,7 @@ void MouseInterface::declareTileDistance(int x, int y, int distance) {
         setTileTextImpl(x, y, (0 <= distance ? QString::number(distance) : "inf"));
     }
     if (getDynamicOptions().setTileBaseColorWhenDistanceDeclaredCorrectly) {
-        int actualDistance = m_maze->getTile(x, y)->getDistance();
+        int actualDistance = m_maze->getDistance(x, y);
         // A negative distance is interpreted to mean infinity
         if (distance == actualDistance || (distance < 0 && actualDistance < 0)) {
             setTileColorImpl(x, y,
@@ -575,7 +582,7 @@ void MouseInterface::setTileTextImpl(int x, int y, const QString& text) {
     QString filtered;
     for (int i = 0; i < text.size(); i += 1) {
         QChar c = text.at(i);
-        if (!FontImage::get()->positions().contains(c)) {
+        if (!FontImage::get()->contains(c)) {
             qWarning().noquote().nospace()
                 << "Unable to set the tile text for unprintable character \""
                 << (c == '\n' ? "\\n" :
@@ -769,7 +776,7 @@ bool MouseInterface::isWall(QPair<QPair<int, int>, Direction> wall, bool declare
 
     ASSERT_TR(m_maze->withinMaze(x, y));
 
-    bool wallExists = m_maze->getTile(x, y)->isWall(direction);
+    bool wallExists = m_maze->isWall(x, y, direction);
 
     if (declareWallOnRead) {
         declareWallImpl(wall, wallExists, declareBothWallHalves);
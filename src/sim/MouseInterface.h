@@ -38,6 +38,9 @@ public:
     // A user pressed an input button in the UI
     void inputButtonWasPressed(int button);
 
+    // The number of commands dispatched so far
+    qint64 getCommandCount() const;
+
     // Parameters set by the algorithm
     InterfaceType getInterfaceType(bool canFinalize) const;
     DynamicMouseAlgorithmOptions getDynamicOptions() const;
@@ -137,6 +140,9 @@ private:
     // doesn't travel too fast in DISCRETE mode
     double m_wheelSpeedFraction;
 
+    // Incremented on every dispatch
+    qint64 m_commandCount;
+
     // Cache of tiles, for making clearAll methods faster
     std::set<QPair<int, int>> m_tilesWithColor;
     std::set<QPair<int, int>> m_tilesWithText;
@@ -1,16 +1,16 @@
 #pragma once
 
-#include <QPair>
-#include <QSet>
-
 #include "units/Duration.h"
 
 namespace mms {
 
+// The run's stats as of the last step; these are all scalars, so that a
+// snapshot is cheap to take while the mouse runs, and the per-tile stats are
+// kept by the run's MouseTrail instead
 struct MouseStats {
     Duration bestTimeToCenter = Duration::Seconds(-1);
     Duration timeOfOriginDeparture = Duration::Seconds(-1);
-    QSet<QPair<int, int>> traversedTileLocations;
+    int numberOfTraversedTiles = 0;
     int closestDistanceToCenter = -1;
 };
 
@@ -0,0 +1,149 @@
+#include "MouseTrail.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QTextStream>
+
+#include <algorithm>
+
+#include "Assert.h"
+
+namespace mms {
+
+MouseTrail::MouseTrail(
+        int mazeWidth,
+        int mazeHeight,
+        int capacity,
+        const Duration& interval) :
+        m_mazeWidth(mazeWidth),
+        m_mazeHeight(mazeHeight),
+        m_interval(interval),
+        m_poses(capacity),
+        m_count(0),
+        m_firstVisitTimes(mazeWidth * mazeHeight, -1.0),
+        m_visits(mazeWidth * mazeHeight, 0),
+        m_dwellTimes(mazeWidth * mazeHeight, 0.0),
+        m_maxDwellTime(0.0),
+        m_lastTileIndex(-1),
+        m_tileVersion(0),
+        m_entries(ENTRY_CAPACITY, -1) {
+    ASSERT_LT(0, capacity);
+    m_timeline.reserve(mazeWidth * mazeHeight);
+}
+
+bool MouseTrail::update(
+        const Duration& dt,
+        const Coordinate& translation,
+        const Angle& rotation,
+        int x,
+        int y) {
+
+    // Always record the first pose, and then one pose per interval
+    m_elapsedTime += dt;
+    m_timeSinceLastPose += dt;
+    if (m_count == 0 || !(m_timeSinceLastPose < m_interval)) {
+        m_poses[m_count % m_poses.size()] = {
+            translation.getX().getMeters(),
+            translation.getY().getMeters(),
+            rotation.getRadiansZeroTo2pi(),
+        };
+        m_count += 1;
+        m_timeSinceLastPose = Duration();
+    }
+
+    // Update the tile stats
+    ASSERT_LE(0, x);
+    ASSERT_LT(x, m_mazeWidth);
+    ASSERT_LE(0, y);
+    ASSERT_LT(y, m_mazeHeight);
+    int index = m_mazeHeight * x + y;
+    bool isFirstVisit = false;
+    if (index != m_lastTileIndex) {
+        if (m_visits.at(index) == 0) {
+            m_firstVisitTimes[index] = m_elapsedTime.getSeconds();
+            m_timeline.append(index);
+            isFirstVisit = true;
+        }
+        m_visits[index] += 1;
+        m_lastTileIndex = index;
+        m_tileVersion += 1;
+        m_entries[m_tileVersion % ENTRY_CAPACITY] = index;
+    }
+    m_dwellTimes[index] += dt.getSeconds();
+    m_maxDwellTime = std::max(m_maxDwellTime, m_dwellTimes.at(index));
+    return isFirstVisit;
+}
+
+int MouseTrail::getCapacity() const {
+    return m_poses.size();
+}
+
+qint64 MouseTrail::getCount() const {
+    return m_count;
+}
+
+qint64 MouseTrail::getFirstIndex() const {
+    return std::max(static_cast<qint64>(0), m_count - m_poses.size());
+}
+
+const MouseTrail::Pose& MouseTrail::getPose(qint64 index) const {
+    ASSERT_LE(getFirstIndex(), index);
+    ASSERT_LT(index, m_count);
+    return m_poses.at(index % m_poses.size());
+}
+
+int MouseTrail::getVisits(int x, int y) const {
+    return m_visits.at(m_mazeHeight * x + y);
+}
+
+double MouseTrail::getDwellTime(int x, int y) const {
+    return m_dwellTimes.at(m_mazeHeight * x + y);
+}
+
+double MouseTrail::getMaxDwellTime() const {
+    return m_maxDwellTime;
+}
+
+double MouseTrail::getFirstVisitTime(int x, int y) const {
+    return m_firstVisitTimes.at(m_mazeHeight * x + y);
+}
+
+const QVector<int>& MouseTrail::getTimeline() const {
+    return m_timeline;
+}
+
+int MouseTrail::getTileVersion() const {
+    return m_tileVersion;
+}
+
+int MouseTrail::getEnteredTile(int tileVersion) const {
+    ASSERT_LT(0, tileVersion);
+    ASSERT_LT(m_tileVersion - ENTRY_CAPACITY, tileVersion);
+    ASSERT_LE(tileVersion, m_tileVersion);
+    return m_entries.at(tileVersion % ENTRY_CAPACITY);
+}
+
+bool MouseTrail::writeTimeline(const QString& path) const {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning().noquote().nospace()
+            << "Unable to write the timeline to \"" << path << "\": "
+            << file.errorString() << ".";
+        return false;
+    }
+    QTextStream out(&file);
+    out << "order,x,y,first_visit_seconds,visits,dwell_seconds\n";
+    for (int i = 0; i < m_timeline.size(); i += 1) {
+        int index = m_timeline.at(i);
+        out << i << ","
+            << index / m_mazeHeight << ","
+            << index % m_mazeHeight << ","
+            << QString::number(m_firstVisitTimes.at(index), 'f', 3) << ","
+            << m_visits.at(index) << ","
+            << QString::number(m_dwellTimes.at(index), 'f', 3) << "\n";
+    }
+    out.flush();
+    return true;
+}
+
+} // namespace mms
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+#include "units/Angle.h"
+#include "units/Coordinate.h"
+#include "units/Duration.h"
+
+namespace mms {
+
+// Where the mouse has been: a fixed-capacity ring buffer of poses, sampled at
+// a fixed sim-time interval, plus the time of the first visit to, the number
+// of visits to, and the total time spent in each tile, the order in which
+// the tiles were first visited, and the most recently entered tiles. Memory
+// use is constant regardless of the run length.
+class MouseTrail {
+
+public:
+
+    struct Pose {
+        double x; // x position, in meters
+        double y; // y position, in meters
+        double rotation; // rotation, in radians
+    };
+
+    MouseTrail(
+        int mazeWidth,
+        int mazeHeight,
+        int capacity,
+        const Duration& interval);
+
+    // Records that the mouse is at the given pose, in tile (x, y), after dt
+    // of sim time has elapsed; returns whether it's the first time that the
+    // mouse has been in the tile
+    bool update(
+        const Duration& dt,
+        const Coordinate& translation,
+        const Angle& rotation,
+        int x,
+        int y);
+
+    // The total number of poses ever recorded; only the newest getCapacity()
+    // of them are kept, i.e., those with index in [getFirstIndex(), getCount())
+    int getCapacity() const;
+    qint64 getCount() const;
+    qint64 getFirstIndex() const;
+    const Pose& getPose(qint64 index) const;
+
+    // Per-tile visit counts and dwell times (in seconds)
+    int getVisits(int x, int y) const;
+    double getDwellTime(int x, int y) const;
+    double getMaxDwellTime() const;
+
+    // The sim time since the trail began, in seconds, at which the mouse
+    // first entered the tile, or -1 if it hasn't yet
+    double getFirstVisitTime(int x, int y) const;
+
+    // The tiles visited so far, as x * mazeHeight + y, in the order in which
+    // they were first visited
+    const QVector<int>& getTimeline() const;
+
+    // Incremented every time the mouse enters a tile, so that readers can
+    // tell whether the per-tile stats changed without copying them
+    int getTileVersion() const;
+
+    // The tile (as x * mazeHeight + y) that the mouse entered at the given
+    // tile version; only the newest ENTRY_CAPACITY entries are kept, i.e.,
+    // those with version in (getTileVersion() - ENTRY_CAPACITY, getTileVersion()]
+    static const int ENTRY_CAPACITY = 1024;
+    int getEnteredTile(int tileVersion) const;
+
+    // Writes the timeline as CSV, one row per visited tile with its per-tile
+    // stats; returns false (and warns) if it can't be written
+    bool writeTimeline(const QString& path) const;
+
+private:
+
+    int m_mazeWidth;
+    int m_mazeHeight;
+    Duration m_interval;
+
+    // The ring buffer, and the sim time since the last recorded pose
+    QVector<Pose> m_poses;
+    qint64 m_count;
+    Duration m_timeSinceLastPose;
+
+    // The sim time since the trail began
+    Duration m_elapsedTime;
+
+    // Indexed by (mazeHeight * x + y), like the maze's tiles
+    QVector<double> m_firstVisitTimes;
+    QVector<int> m_visits;
+    QVector<double> m_dwellTimes;
+    double m_maxDwellTime;
+    int m_lastTileIndex;
+    int m_tileVersion;
+    QVector<int> m_timeline;
+    QVector<int> m_entries;
+
+};
+
+} // namespace mms
@@ -0,0 +1,228 @@
+#include "OptimalTimeOracle.h"
+
+#include <QMutexLocker>
+#include <QtMath>
+
+#include <cmath>
+#include <cstring>
+
+namespace mms {
+
+QMutex OptimalTimeOracle::s_mutex;
+QHash<quint64, double> OptimalTimeOracle::s_cache;
+
+Duration OptimalTimeOracle::getTimeToGoal(
+        const PackedMaze& maze,
+        const QVector<QPair<int, int>>& goal,
+        const Distance& tileLength,
+        const Speed& forwardSpeed,
+        const AngularVelocity& turnSpeed) {
+
+    double length = tileLength.getMeters();
+    double speed = forwardSpeed.getMetersPerSecond();
+    double turn = turnSpeed.getRadiansPerSecond();
+    if (!(0 < length && 0 < speed && 0 < turn)) {
+        return Duration::Seconds(-1);
+    }
+
+    // FNV-1a over the maze's hash, the goal, and the bits of the parameters
+    QVector<quint64> words = {maze.getHash(), 0, 0, 0};
+    std::memcpy(&words[1], &length, sizeof(double));
+    std::memcpy(&words[2], &speed, sizeof(double));
+    std::memcpy(&words[3], &turn, sizeof(double));
+    for (const QPair<int, int>& position : goal) {
+        words.append((quint64(quint32(position.first)) << 32) | quint32(position.second));
+    }
+    quint64 key = 14695981039346656037ULL;
+    for (quint64 word : words) {
+        key ^= word;
+        key *= 1099511628211ULL;
+    }
+
+    {
+        QMutexLocker locker(&s_mutex);
+        QHash<quint64, double>::const_iterator it = s_cache.constFind(key);
+        if (it != s_cache.constEnd()) {
+            return Duration::Seconds(it.value());
+        }
+    }
+
+    // Searched without the lock, so that callers on other threads (with
+    // other mazes) aren't held up; two of them may both search for the same
+    // result, which is harmless
+    double seconds = search(maze, goal, length, speed, turn);
+
+    QMutexLocker locker(&s_mutex);
+    if (CACHE_CAPACITY <= s_cache.size()) {
+        s_cache.clear();
+    }
+    s_cache.insert(key, seconds);
+    return Duration::Seconds(seconds);
+}
+
+double OptimalTimeOracle::search(
+        const PackedMaze& maze,
+        const QVector<QPair<int, int>>& goal,
+        double tileLength,
+        double forwardSpeed,
+        double turnSpeed) {
+
+    int width = maze.getWidth();
+    int height = maze.getHeight();
+    if (width == 0 || height == 0) {
+        return -1.0;
+    }
+    int columns = 2 * width + 1;
+    int rows = 2 * height + 1;
+
+    // Which points the mouse may be at, and which are goals (the centers and
+    // sides of the goal tiles, since the mouse is in a goal tile as soon as
+    // it crosses into one)
+    QVector<char> isNode(columns * rows, 0);
+    QVector<char> isGoal(columns * rows, 0);
+    for (int X = 0; X < columns; X += 1) {
+        for (int Y = 0; Y < rows; Y += 1) {
+            isNode[X * rows + Y] = isOpen(maze, X, Y);
+        }
+    }
+    for (const QPair<int, int>& tile : goal) {
+        if (!maze.withinMaze(tile.first, tile.second)) {
+            continue;
+        }
+        int X = 2 * tile.first + 1;
+        int Y = 2 * tile.second + 1;
+        if (X == 1 && Y == 1) {
+            return 0.0;
+        }
+        isGoal[X * rows + Y] = 1;
+        isGoal[(X + 1) * rows + Y] = 1;
+        isGoal[(X - 1) * rows + Y] = 1;
+        isGoal[X * rows + Y + 1] = 1;
+        isGoal[X * rows + Y - 1] = 1;
+    }
+
+    // The timing starts when the mouse leaves the start tile, so it never
+    // goes back through the start tile's center, nor across its corner
+    isNode[1 * rows + 1] = 0;
+
+    // Headings are clockwise from north, in eighths of a turn; an orthogonal
+    // move goes half a tile (between a tile's center and one of its sides),
+    // and a diagonal move goes between two adjacent sides of a tile
+    static const int DX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    static const int DY[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+    double orthogonalCost = tileLength / 2.0 / forwardSpeed;
+    double diagonalCost = tileLength / M_SQRT2 / forwardSpeed;
+    double turnCost = M_PI / 4.0 / turnSpeed;
+
+    // Every move costs at least one bucket's width, so a move out of bucket k
+    // lands in bucket k + 1 or later, and no bucket ahead of the current one
+    // is more than the most costly move away; the ring is just big enough
+    double bucketWidth = qMin(orthogonalCost, turnCost);
+    double maximumCost = qMax(diagonalCost, turnCost);
+    int bucketCount = static_cast<int>(maximumCost / bucketWidth) + 2;
+
+    struct Entry {
+        int state;
+        double time;
+    };
+    QVector<QVector<Entry>> buckets(bucketCount);
+    QVector<double> times(columns * rows * 8, -1.0);
+    int pending = 0;
+    qint64 current = 0;
+
+    auto push = [&](int state, double time) {
+        double best = times.at(state);
+        if (0 <= best && best <= time) {
+            return;
+        }
+        times[state] = time;
+        qint64 bucket = qMax(
+            current + 1,
+            static_cast<qint64>(std::floor(time / bucketWidth)));
+        buckets[bucket % bucketCount].append({state, time});
+        pending += 1;
+    };
+
+    // The mouse may leave through any open side, having turned as it liked
+    // while it was still in the start tile
+    for (int start : {2 * rows + 1, 1 * rows + 2}) {
+        if (isNode.at(start)) {
+            for (int heading = 0; heading < 8; heading += 1) {
+                times[start * 8 + heading] = 0.0;
+                buckets[0].append({start * 8 + heading, 0.0});
+                pending += 1;
+            }
+        }
+    }
+
+    double best = -1.0;
+    for (current = 0; 0 < pending; current += 1) {
+        QVector<Entry>& bucket = buckets[current % bucketCount];
+
+        // Nothing in a bucket can improve on anything else in it, so each
+        // entry is final (unless it's stale), though not in order
+        for (int i = 0; i < bucket.size(); i += 1) {
+            Entry entry = bucket.at(i);
+            if (times.at(entry.state) < entry.time) {
+                continue;
+            }
+            int point = entry.state / 8;
+            int heading = entry.state % 8;
+            if (isGoal.at(point)) {
+                if (best < 0 || entry.time < best) {
+                    best = entry.time;
+                }
+                continue;
+            }
+            push(point * 8 + (heading + 1) % 8, entry.time + turnCost);
+            push(point * 8 + (heading + 7) % 8, entry.time + turnCost);
+
+            int X = point / rows + DX[heading];
+            int Y = point % rows + DY[heading];
+            if (X < 0 || columns <= X || Y < 0 || rows <= Y) {
+                continue;
+            }
+            int next = X * rows + Y;
+            if (!isNode.at(next)) {
+                continue;
+            }
+            if (heading % 2 == 0) {
+                push(next * 8 + heading, entry.time + orthogonalCost);
+            }
+            else {
+                // The tile crossed is the one whose center is beside both
+                // sides; points with both coordinates odd are tile centers
+                int centerX = (X % 2 == 1) ? X : X - DX[heading];
+                int centerY = (Y % 2 == 1) ? Y : Y - DY[heading];
+                if (!(centerX == 1 && centerY == 1)) {
+                    push(next * 8 + heading, entry.time + diagonalCost);
+                }
+            }
+        }
+        pending -= bucket.size();
+        bucket.clear();
+        if (0 <= best) {
+            return best;
+        }
+    }
+    return -1.0;
+}
+
+bool OptimalTimeOracle::isOpen(const PackedMaze& maze, int X, int Y) {
+    bool oddX = X % 2 == 1;
+    bool oddY = Y % 2 == 1;
+    if (oddX && oddY) {
+        return true;
+    }
+    if (oddX) {
+        return 0 < Y && Y < 2 * maze.getHeight() &&
+            !maze.isWall(X / 2, Y / 2, Direction::SOUTH);
+    }
+    if (oddY) {
+        return 0 < X && X < 2 * maze.getWidth() &&
+            !maze.isWall(X / 2, Y / 2, Direction::WEST);
+    }
+    return false;
+}
+
+} // namespace mms
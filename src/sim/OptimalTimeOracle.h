@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QVector>
+
+#include "units/AngularVelocity.h"
+#include "units/Distance.h"
+#include "units/Duration.h"
+#include "units/Speed.h"
+
+#include "PackedMaze.h"
+
+namespace mms {
+
+// The least time in which a mouse could get from the start to the goal,
+// timed the way MouseStats::bestTimeToCenter is (from when the mouse leaves
+// the start tile to when it enters a goal tile), to score a run against.
+//
+// The mouse's wheels change speed instantly, so the time of a path is its
+// length at top speed plus its turning at top turn speed (which is also
+// what a curve turn costs; see Mouse::getMaximumTurnSpeed()). The mouse's
+// center is kept to the tile centers and the midpoints of open walls, and
+// may move between the midpoints of two sides of a tile, which is a diagonal
+// run of 45 degrees. The search is over (point, heading), with eight
+// headings, and its queue is a ring of buckets no wider than the cheapest
+// move, so that every entry in a bucket is final when it's reached.
+class OptimalTimeOracle {
+
+public:
+
+    // This class is not constructible
+    OptimalTimeOracle() = delete;
+
+    // Negative if the goal can't be reached. Results are cached by the
+    // maze's hash, the goal, and the mouse's speeds.
+    static Duration getTimeToGoal(
+        const PackedMaze& maze,
+        const QVector<QPair<int, int>>& goal,
+        const Distance& tileLength,
+        const Speed& forwardSpeed,
+        const AngularVelocity& turnSpeed);
+
+private:
+
+    // How many results are cached; the cache is simply cleared when full
+    static const int CACHE_CAPACITY = 1024;
+    static QMutex s_mutex;
+    static QHash<quint64, double> s_cache;
+
+    // Returns seconds, or -1 if the goal can't be reached
+    static double search(
+        const PackedMaze& maze,
+        const QVector<QPair<int, int>>& goal,
+        double tileLength,
+        double forwardSpeed,
+        double turnSpeed);
+
+    // Points are indexed by X * (2 * height + 1) + Y, in units of half a
+    // tile from the maze's lower left corner: tile centers have odd X and
+    // Y, and wall midpoints have exactly one of them odd
+    static bool isOpen(const PackedMaze& maze, int X, int Y);
+};
+
+} // namespace mms
@@ -0,0 +1,310 @@
+#include "PackedMaze.h"
+
+#include "Assert.h"
+
+namespace mms {
+
+PackedMaze::PackedMaze() : PackedMaze(0, 0) {
+}
+
+PackedMaze::PackedMaze(int width, int height) :
+        m_width(width),
+        m_height(height),
+        m_hasConsistentWalls(true) {
+    ASSERT_LE(0, width);
+    ASSERT_LE(0, height);
+    m_horizontal.fill(0, wordCount(width * (height + 1)));
+    m_vertical.fill(0, wordCount((width + 1) * height));
+}
+
+PackedMaze PackedMaze::fromBasicMaze(const BasicMaze& basicMaze) {
+
+    // Only the rectangular portion of the maze can be packed
+    int width = basicMaze.size();
+    int height = 0;
+    for (int x = 0; x < width; x += 1) {
+        int columnHeight = basicMaze.at(x).size();
+        if (x == 0 || columnHeight < height) {
+            height = columnHeight;
+        }
+    }
+    if (height == 0) {
+        width = 0;
+    }
+
+    QVector<quint8> tileWalls(width * height, 0);
+    for (int x = 0; x < width; x += 1) {
+        const QVector<BasicTile>& column = basicMaze.at(x);
+        for (int y = 0; y < height; y += 1) {
+            const BasicTile& tile = column.at(y);
+            for (Direction direction : DIRECTIONS()) {
+                if (tile.value(direction)) {
+                    tileWalls[x * height + y] |= 1 << static_cast<int>(direction);
+                }
+            }
+        }
+    }
+    return fromTileWalls(width, height, tileWalls);
+}
+
+PackedMaze PackedMaze::fromTileWalls(
+        int width,
+        int height,
+        const QVector<quint8>& tileWalls) {
+
+    ASSERT_EQ(tileWalls.size(), width * height);
+    PackedMaze packed(width, height);
+    quint64* horizontal = packed.m_horizontal.data();
+    quint64* vertical = packed.m_vertical.data();
+    const quint8* walls = tileWalls.constData();
+
+    // Each tile sets its four wall bits without branching, and any wall
+    // half that disagrees with the neighboring tile's half is accumulated
+    // into the mismatch
+    quint64 mismatch = 0;
+    for (int x = 0; x < width; x += 1) {
+        for (int y = 0; y < height; y += 1) {
+            quint64 tile = walls[x * height + y];
+            orBit(horizontal, x * (height + 1) + y + 1, tile & 1);
+            orBit(vertical, (x + 1) * height + y, (tile >> 1) & 1);
+            orBit(horizontal, x * (height + 1) + y, (tile >> 2) & 1);
+            orBit(vertical, x * height + y, (tile >> 3) & 1);
+            if (y + 1 < height) {
+                mismatch |= (tile & 1) ^ ((walls[x * height + y + 1] >> 2) & 1);
+            }
+            if (x + 1 < width) {
+                mismatch |= ((tile >> 1) & 1) ^ ((walls[(x + 1) * height + y] >> 3) & 1);
+            }
+        }
+    }
+    packed.m_hasConsistentWalls = (mismatch == 0);
+
+    return packed;
+}
+
+PackedMaze PackedMaze::fromWords(
+        int width,
+        int height,
+        bool hasConsistentWalls,
+        const QVector<quint64>& horizontal,
+        const QVector<quint64>& vertical) {
+    PackedMaze packed(width, height);
+    ASSERT_EQ(horizontal.size(), packed.m_horizontal.size());
+    ASSERT_EQ(vertical.size(), packed.m_vertical.size());
+    packed.m_horizontal = horizontal;
+    packed.m_vertical = vertical;
+    packed.m_hasConsistentWalls = hasConsistentWalls;
+
+    // Keep the bits past the end of each plane clear, so that equal walls
+    // always mean equal words
+    int horizontalBits = width * (height + 1);
+    int verticalBits = (width + 1) * height;
+    if (horizontalBits % 64 != 0) {
+        packed.m_horizontal.last() &= (quint64(1) << (horizontalBits % 64)) - 1;
+    }
+    if (verticalBits % 64 != 0) {
+        packed.m_vertical.last() &= (quint64(1) << (verticalBits % 64)) - 1;
+    }
+    return packed;
+}
+
+BasicMaze PackedMaze::toBasicMaze() const {
+    BasicMaze basicMaze;
+    for (int x = 0; x < m_width; x += 1) {
+        QVector<BasicTile> column;
+        for (int y = 0; y < m_height; y += 1) {
+            BasicTile tile;
+            for (Direction direction : DIRECTIONS()) {
+                tile.insert(direction, isWall(x, y, direction));
+            }
+            column.push_back(tile);
+        }
+        basicMaze.push_back(column);
+    }
+    return basicMaze;
+}
+
+int PackedMaze::getWidth() const {
+    return m_width;
+}
+
+int PackedMaze::getHeight() const {
+    return m_height;
+}
+
+bool PackedMaze::withinMaze(int x, int y) const {
+    return 0 <= x && x < m_width && 0 <= y && y < m_height;
+}
+
+void PackedMaze::setWall(int x, int y, Direction direction, bool isWall) {
+    ASSERT_TR(withinMaze(x, y));
+    m_hasConsistentWalls = true;
+    switch (direction) {
+        case Direction::NORTH:
+            setBit(&m_horizontal, x * (m_height + 1) + y + 1, isWall);
+            break;
+        case Direction::EAST:
+            setBit(&m_vertical, (x + 1) * m_height + y, isWall);
+            break;
+        case Direction::SOUTH:
+            setBit(&m_horizontal, x * (m_height + 1) + y, isWall);
+            break;
+        case Direction::WEST:
+            setBit(&m_vertical, x * m_height + y, isWall);
+            break;
+    }
+}
+
+bool PackedMaze::operator==(const PackedMaze& other) const {
+    return (
+        m_width == other.m_width &&
+        m_height == other.m_height &&
+        m_horizontal == other.m_horizontal &&
+        m_vertical == other.m_vertical
+    );
+}
+
+bool PackedMaze::operator!=(const PackedMaze& other) const {
+    return !(*this == other);
+}
+
+bool PackedMaze::hasConsistentWalls() const {
+    return m_hasConsistentWalls;
+}
+
+int PackedMaze::getByteCount() const {
+    return (m_horizontal.size() + m_vertical.size()) * sizeof(quint64);
+}
+
+const QVector<quint64>& PackedMaze::getHorizontalWords() const {
+    return m_horizontal;
+}
+
+const QVector<quint64>& PackedMaze::getVerticalWords() const {
+    return m_vertical;
+}
+
+quint64 PackedMaze::getHash() const {
+    quint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](quint64 word) {
+        hash ^= word;
+        hash *= 1099511628211ULL;
+    };
+    mix(m_width);
+    mix(m_height);
+    for (quint64 word : m_horizontal) {
+        mix(word);
+    }
+    for (quint64 word : m_vertical) {
+        mix(word);
+    }
+    return hash;
+}
+
+quint64 PackedMaze::getCanonicalHash() const {
+    quint64 canonical = getHash();
+    for (MazeSymmetry symmetry : MAZE_SYMMETRIES()) {
+        if (symmetry != MazeSymmetry::IDENTITY) {
+            canonical = qMin(
+                canonical,
+                getHash(MazeSymmetryMap(symmetry, m_width, m_height)));
+        }
+    }
+    return canonical;
+}
+
+quint64 PackedMaze::getHash(const MazeSymmetryMap& symmetry) const {
+
+    quint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](quint64 word) {
+        hash ^= word;
+        hash *= 1099511628211ULL;
+    };
+    int width = symmetry.getWidth();
+    int height = symmetry.getHeight();
+    mix(width);
+    mix(height);
+
+    // Each of the view's planes is one of this maze's planes, and since the
+    // symmetry is affine, so is the index of each bit in it. The view's
+    // horizontal walls are the southern walls of its tiles (including a row
+    // of tiles just past its top), and its vertical walls are the western
+    // walls (including a column just past its right).
+    auto stream = [&](int columns, int rows, Direction direction) {
+        auto locateInView = [&](int x, int y, bool* horizontal) {
+            return locate(
+                symmetry.toSourceX(x, y),
+                symmetry.toSourceY(x, y),
+                symmetry.toSource(direction),
+                horizontal);
+        };
+        bool horizontal = false;
+        int origin = locateInView(0, 0, &horizontal);
+        int xStep = locateInView(1, 0, &horizontal) - origin;
+        int yStep = locateInView(0, 1, &horizontal) - origin;
+        const quint64* plane = (
+            horizontal
+            ? m_horizontal.constData()
+            : m_vertical.constData()
+        );
+        quint64 word = 0;
+        int bit = 0;
+        for (int x = 0; x < columns; x += 1) {
+            int index = origin + x * xStep;
+            for (int y = 0; y < rows; y += 1) {
+                word |= ((plane[index >> 6] >> (index & 63)) & 1) << bit;
+                index += yStep;
+                bit += 1;
+                if (bit == 64) {
+                    mix(word);
+                    word = 0;
+                    bit = 0;
+                }
+            }
+        }
+        if (bit != 0) {
+            mix(word);
+        }
+    };
+    stream(width, height + 1, Direction::SOUTH);
+    stream(width + 1, height, Direction::WEST);
+    return hash;
+}
+
+int PackedMaze::locate(int x, int y, Direction direction, bool* horizontal) const {
+    switch (direction) {
+        case Direction::NORTH:
+            *horizontal = true;
+            return x * (m_height + 1) + y + 1;
+        case Direction::EAST:
+            *horizontal = false;
+            return (x + 1) * m_height + y;
+        case Direction::SOUTH:
+            *horizontal = true;
+            return x * (m_height + 1) + y;
+        case Direction::WEST:
+            *horizontal = false;
+            return x * m_height + y;
+    }
+    return 0;
+}
+
+int PackedMaze::wordCount(int bits) {
+    return (bits + 63) / 64;
+}
+
+void PackedMaze::setBit(QVector<quint64>* plane, int index, bool value) {
+    quint64 mask = quint64(1) << (index & 63);
+    if (value) {
+        (*plane)[index >> 6] |= mask;
+    }
+    else {
+        (*plane)[index >> 6] &= ~mask;
+    }
+}
+
+void PackedMaze::orBit(quint64* plane, int index, quint64 bit) {
+    plane[index >> 6] |= bit << (index & 63);
+}
+
+} // namespace mms
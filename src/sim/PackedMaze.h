@@ -0,0 +1,127 @@
+#pragma once
+
+#include <QVector>
+
+#include "BasicMaze.h"
+#include "Direction.h"
+#include "MazeSymmetry.h"
+
+namespace mms {
+
+// A compact, canonical store of the walls of a maze. Each wall is a single
+// bit, and each wall is stored exactly once: horizontal walls (the southern
+// edges of the tiles, plus the northern edge of the top row) live in one
+// bit-plane, and vertical walls (the western edges of the tiles, plus the
+// eastern edge of the rightmost column) live in another. A wall query is a
+// shift and a mask, and a 16x16 maze fits in 68 bytes.
+class PackedMaze {
+
+public:
+
+    PackedMaze();
+    PackedMaze(int width, int height);
+
+    // Builds the packed store from a basic maze. Wall halves that disagree
+    // between neighboring tiles are merged (a wall exists if either tile
+    // reports it), and the disagreement is recorded in hasConsistentWalls().
+    // Columns beyond the height of the shortest column are dropped.
+    static PackedMaze fromBasicMaze(const BasicMaze& basicMaze);
+
+    // Builds the packed store from per-tile wall bits, indexed by
+    // x * height + y, where bit i is set if the tile has a wall in direction
+    // DIRECTIONS().at(i) (this is also the layout of a .MAZ byte). Wall
+    // halves are merged the same way as above.
+    static PackedMaze fromTileWalls(
+        int width,
+        int height,
+        const QVector<quint8>& tileWalls);
+
+    // Builds the packed store from bit-planes in the layout described below,
+    // as written by getHorizontalWords() and getVerticalWords()
+    static PackedMaze fromWords(
+        int width,
+        int height,
+        bool hasConsistentWalls,
+        const QVector<quint64>& horizontal,
+        const QVector<quint64>& vertical);
+    BasicMaze toBasicMaze() const;
+
+    int getWidth() const;
+    int getHeight() const;
+    bool withinMaze(int x, int y) const;
+
+    inline bool isWall(int x, int y, Direction direction) const {
+        int index = 0;
+        const quint64* plane = nullptr;
+        switch (direction) {
+            case Direction::NORTH:
+                index = x * (m_height + 1) + y + 1;
+                plane = m_horizontal.constData();
+                break;
+            case Direction::EAST:
+                index = (x + 1) * m_height + y;
+                plane = m_vertical.constData();
+                break;
+            case Direction::SOUTH:
+                index = x * (m_height + 1) + y;
+                plane = m_horizontal.constData();
+                break;
+            case Direction::WEST:
+                index = x * m_height + y;
+                plane = m_vertical.constData();
+                break;
+        }
+        return (plane[index >> 6] >> (index & 63)) & 1;
+    }
+
+    // Equal if the sizes and all of the walls are equal
+    bool operator==(const PackedMaze& other) const;
+    bool operator!=(const PackedMaze& other) const;
+
+    // Sets both halves of the wall at once
+    void setWall(int x, int y, Direction direction, bool isWall);
+
+    // Whether or not the basic maze this was built from agreed with itself.
+    // Once a wall has been set, the walls are no longer those of the basic
+    // maze, and since the packed store can't disagree with itself, they're
+    // consistent from then on.
+    bool hasConsistentWalls() const;
+
+    // The number of bytes used by both bit-planes
+    int getByteCount() const;
+    const QVector<quint64>& getHorizontalWords() const;
+    const QVector<quint64>& getVerticalWords() const;
+
+    // A 64-bit FNV-1a hash, a word at a time, of the size and the walls
+    quint64 getHash() const;
+
+    // The smallest getHash() of the maze's eight symmetric views, so that a
+    // maze hashes the same however it was rotated or mirrored. The views
+    // aren't built; their bit-planes are streamed from this maze's.
+    quint64 getCanonicalHash() const;
+
+private:
+
+    int m_width;
+    int m_height;
+    bool m_hasConsistentWalls;
+
+    // Horizontal walls, W x (H + 1), column-major
+    QVector<quint64> m_horizontal;
+
+    // Vertical walls, (W + 1) x H, column-major
+    QVector<quint64> m_vertical;
+
+    // The getHash() of a symmetric view
+    quint64 getHash(const MazeSymmetryMap& symmetry) const;
+
+    // Where the wall is stored, whether or not the tile is within the maze;
+    // the index is into the horizontal plane if horizontal is set
+    int locate(int x, int y, Direction direction, bool* horizontal) const;
+
+    static int wordCount(int bits);
+    static void setBit(QVector<quint64>* plane, int index, bool value);
+    static void orBit(quint64* plane, int index, quint64 bit);
+};
+
+} // namespace mms
@@ -26,6 +26,14 @@ Param::Param() {
         "maze-mirrored", false);
     m_mazeRotations = ParamParser::getIntIfHasIntAndInRange(
         "maze-rotations", 0, 0, 3);
+    m_maxPolygonRenderingTiles = ParamParser::getIntIfHasIntAndInRange(
+        "max-polygon-rendering-tiles", 65536, 0, 16777216);
+    m_mazeCacheMegabytes = ParamParser::getIntIfHasIntAndInRange(
+        "maze-cache-megabytes", 256, 0, 65536);
+    m_trailInterval = ParamParser::getDoubleIfHasDoubleAndInRange(
+        "trail-interval", 0.05, 0.001, 10.0);
+    m_trailCapacity = ParamParser::getIntIfHasIntAndInRange(
+        "trail-capacity", 4096, 2, 1000000);
 }
 
 int Param::randomSeed() {
@@ -48,4 +56,20 @@ int Param::mazeRotations() {
     return m_mazeRotations;
 }
 
+int Param::maxPolygonRenderingTiles() {
+    return m_maxPolygonRenderingTiles;
+}
+
+int Param::mazeCacheMegabytes() {
+    return m_mazeCacheMegabytes;
+}
+
+double Param::trailInterval() {
+    return m_trailInterval;
+}
+
+int Param::trailCapacity() {
+    return m_trailCapacity;
+}
+
 } // namespace mms
@@ -21,8 +21,14 @@ public:
     // Maze parameters
     double wallWidth();
     double wallLength();
-    bool mazeMirrored(); // TODO: MACK
-    int mazeRotations(); // TODO: MACK
+    bool mazeMirrored(); // The initial maze symmetry is mirrored...
+    int mazeRotations(); // ...and then rotated counter-clockwise this often
+    int maxPolygonRenderingTiles(); // Larger mazes are drawn as a tile image
+    int mazeCacheMegabytes(); // Memory kept for recently loaded mazes
+
+    // Mouse trail parameters
+    double trailInterval(); // Sim seconds between recorded poses
+    int trailCapacity(); // Max number of poses kept
 
 private:
 
@@ -38,6 +44,10 @@ private:
     double m_wallLength;
     bool m_mazeMirrored;
     int m_mazeRotations;
+    int m_maxPolygonRenderingTiles;
+    int m_mazeCacheMegabytes;
+    double m_trailInterval;
+    int m_trailCapacity;
 };
 
 } // namespace mms
@@ -0,0 +1,97 @@
+#include "PerformanceHud.h"
+
+#include <algorithm>
+
+namespace mms {
+
+PerformanceHud::PerformanceHud() :
+        m_next(0),
+        m_size(0),
+        m_lastRefresh(0.0) {
+}
+
+void PerformanceHud::recordFrame(
+        double wallTime,
+        double simTime,
+        qint64 simSteps,
+        qint64 algoCommands,
+        qint64 uploadBytes) {
+
+    // Sim time and the command count start over with each mouse
+    // algorithm, so the old samples are meaningless at that point
+    if (0 < m_size) {
+        int newest = at(m_size - 1);
+        if (
+            simTime < m_simTimes[newest] ||
+            algoCommands < m_algoCommands[newest]
+        ) {
+            m_size = 0;
+        }
+    }
+
+    m_wallTimes[m_next] = wallTime;
+    m_simTimes[m_next] = simTime;
+    m_simSteps[m_next] = simSteps;
+    m_algoCommands[m_next] = algoCommands;
+    m_uploadBytes[m_next] = uploadBytes;
+    m_next = (m_next + 1) % WINDOW_SIZE;
+    m_size = std::min(m_size + 1, WINDOW_SIZE);
+
+    if (REFRESH_INTERVAL <= wallTime - m_lastRefresh) {
+        refresh();
+        m_lastRefresh = wallTime;
+    }
+}
+
+const QStringList& PerformanceHud::getLines() const {
+    return m_lines;
+}
+
+int PerformanceHud::at(int i) const {
+    return (m_next - m_size + i + WINDOW_SIZE) % WINDOW_SIZE;
+}
+
+void PerformanceHud::refresh() {
+
+    if (m_size < 2) {
+        m_lines.clear();
+        return;
+    }
+
+    // Frame times, in milliseconds
+    int count = m_size - 1;
+    qint64 totalUploadBytes = 0;
+    for (int i = 0; i < count; i += 1) {
+        m_frameTimes[i] = 1000.0 * (m_wallTimes[at(i + 1)] - m_wallTimes[at(i)]);
+        totalUploadBytes += m_uploadBytes[at(i + 1)];
+    }
+    std::sort(m_frameTimes.begin(), m_frameTimes.begin() + count);
+    auto percentile = [&](double p){
+        return m_frameTimes[std::min(count - 1, static_cast<int>(p * count))];
+    };
+
+    // Rates over the whole window
+    int oldest = at(0);
+    int newest = at(m_size - 1);
+    double wallDuration = m_wallTimes[newest] - m_wallTimes[oldest];
+    if (wallDuration <= 0.0) {
+        return;
+    }
+    double simDuration = m_simTimes[newest] - m_simTimes[oldest];
+    qint64 steps = m_simSteps[newest] - m_simSteps[oldest];
+    qint64 commands = m_algoCommands[newest] - m_algoCommands[oldest];
+
+    m_lines = QStringList({
+        QString("Frame (ms)   p50 %1  p95 %2  p99 %3")
+            .arg(percentile(0.50), 0, 'f', 1)
+            .arg(percentile(0.95), 0, 'f', 1)
+            .arg(percentile(0.99), 0, 'f', 1),
+        QString("Steps/s      %1").arg(steps / wallDuration, 0, 'f', 0),
+        QString("Real-time    %1x").arg(simDuration / wallDuration, 0, 'f', 2),
+        QString("Commands/s   %1").arg(commands / wallDuration, 0, 'f', 0),
+        QString("Upload/frame %1 KB").arg(
+            totalUploadBytes / 1024.0 / count, 0, 'f', 1),
+    });
+}
+
+} // namespace mms
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QStringList>
+#include <QtGlobal>
+
+#include <array>
+
+namespace mms {
+
+// Rolling performance statistics for the map's overlay. The samples for the
+// last WINDOW_SIZE frames are kept in fixed arrays, and the text is only
+// regenerated a few times per second, so recording a frame is cheap.
+class PerformanceHud {
+
+public:
+
+    PerformanceHud();
+
+    // Records a frame, given the current wall time and sim time (in seconds),
+    // the running totals of sim steps and algorithm commands, and the number
+    // of bytes uploaded to the GPU for this frame
+    void recordFrame(
+        double wallTime,
+        double simTime,
+        qint64 simSteps,
+        qint64 algoCommands,
+        qint64 uploadBytes);
+
+    // The lines of text to display
+    const QStringList& getLines() const;
+
+private:
+
+    static const int WINDOW_SIZE = 120;
+    static constexpr double REFRESH_INTERVAL = 0.25;
+
+    // Per-frame samples, in a ring buffer
+    std::array<double, WINDOW_SIZE> m_wallTimes;
+    std::array<double, WINDOW_SIZE> m_simTimes;
+    std::array<qint64, WINDOW_SIZE> m_simSteps;
+    std::array<qint64, WINDOW_SIZE> m_algoCommands;
+    std::array<qint64, WINDOW_SIZE> m_uploadBytes;
+    int m_next;
+    int m_size;
+
+    // Scratch space for computing the frame time percentiles
+    std::array<double, WINDOW_SIZE> m_frameTimes;
+
+    double m_lastRefresh;
+    QStringList m_lines;
+
+    // Index of the i-th oldest sample
+    int at(int i) const;
+
+    // Regenerates the text from the samples
+    void refresh();
+};
+
+} // namespace mms
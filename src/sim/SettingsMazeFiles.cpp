@@ -6,6 +6,7 @@
 namespace mms {
 
 const QString SettingsMazeFiles::GROUP = "mazeFiles";
+const QString SettingsMazeFiles::GROUP_DIRECTORIES = "mazeDirectories";
 const QString SettingsMazeFiles::KEY_PATH = "path";
 
 QStringList SettingsMazeFiles::getSettingsMazeFiles() {
@@ -22,4 +23,18 @@ void SettingsMazeFiles::removeMazeFile(const QString& path) {
     Settings::get()->remove(GROUP, KEY_PATH, path);
 }
 
+QStringList SettingsMazeFiles::getSettingsMazeDirectories() {
+    return Settings::get()->values(GROUP_DIRECTORIES, KEY_PATH);
+}
+
+void SettingsMazeFiles::addMazeDirectory(const QString& path) {
+    Settings::get()->add(GROUP_DIRECTORIES, {
+        {KEY_PATH, path},
+    });
+}
+
+void SettingsMazeFiles::removeMazeDirectory(const QString& path) {
+    Settings::get()->remove(GROUP_DIRECTORIES, KEY_PATH, path);
+}
+
 } //namespace mms
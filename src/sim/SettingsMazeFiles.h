@@ -14,9 +14,16 @@ public:
     static void addMazeFile(const QString& path);
     static void removeMazeFile(const QString& path);
 
+    // Directories whose maze files (including those in subdirectories) are
+    // all part of the library
+    static QStringList getSettingsMazeDirectories();
+    static void addMazeDirectory(const QString& path);
+    static void removeMazeDirectory(const QString& path);
+
 private:
 
     static const QString GROUP;
+    static const QString GROUP_DIRECTORIES;
     static const QString KEY_PATH;
 
 };
@@ -0,0 +1,252 @@
+#include "TileBitset.h"
+
+#include <QtAlgorithms>
+
+#include "Assert.h"
+
+namespace mms {
+
+TileBitset::TileBitset() : TileBitset(0, 0) {
+}
+
+TileBitset::TileBitset(int width, int height) :
+        m_width(width),
+        m_height(height),
+        m_words((width * height + 63) / 64, 0) {
+    ASSERT_LE(0, width);
+    ASSERT_LE(0, height);
+}
+
+int TileBitset::getWidth() const {
+    return m_width;
+}
+
+int TileBitset::getHeight() const {
+    return m_height;
+}
+
+bool TileBitset::test(int x, int y) const {
+    ASSERT_TR(0 <= x && x < m_width && 0 <= y && y < m_height);
+    int index = x * m_height + y;
+    return (m_words.at(index >> 6) >> (index & 63)) & 1;
+}
+
+void TileBitset::set(int x, int y) {
+    ASSERT_TR(0 <= x && x < m_width && 0 <= y && y < m_height);
+    int index = x * m_height + y;
+    m_words[index >> 6] |= quint64(1) << (index & 63);
+}
+
+void TileBitset::reset(int x, int y) {
+    ASSERT_TR(0 <= x && x < m_width && 0 <= y && y < m_height);
+    int index = x * m_height + y;
+    m_words[index >> 6] &= ~(quint64(1) << (index & 63));
+}
+
+TileBitset& TileBitset::operator&=(const TileBitset& other) {
+    ASSERT_EQ(m_width, other.m_width);
+    ASSERT_EQ(m_height, other.m_height);
+    for (int i = 0; i < m_words.size(); i += 1) {
+        m_words[i] &= other.m_words.at(i);
+    }
+    return *this;
+}
+
+TileBitset TileBitset::shifted(int offset) const {
+    ASSERT_LE(0, offset);
+    TileBitset result(m_width, m_height);
+    for (int i = 0; i < m_words.size(); i += 1) {
+        result.m_words[i] = readBits(m_words, 64 * i + offset);
+    }
+    int numTiles = m_width * m_height;
+    if (numTiles % 64 != 0) {
+        result.m_words.last() &= (quint64(1) << (numTiles % 64)) - 1;
+    }
+    return result;
+}
+
+int TileBitset::count() const {
+    int count = 0;
+    for (quint64 word : m_words) {
+        count += qPopulationCount(word);
+    }
+    return count;
+}
+
+QVector<QPair<int, int>> TileBitset::getTiles(int limit, bool inSet) const {
+    QVector<QPair<int, int>> tiles;
+    int numTiles = m_width * m_height;
+    for (int i = 0; i < m_words.size() && tiles.size() < limit; i += 1) {
+        quint64 word = (inSet ? m_words.at(i) : ~m_words.at(i));
+        while (word != 0 && tiles.size() < limit) {
+            int index = 64 * i + qCountTrailingZeroBits(word);
+            if (numTiles <= index) {
+                break;
+            }
+            tiles.append({index / m_height, index % m_height});
+            word &= word - 1;
+        }
+    }
+    return tiles;
+}
+
+TileBitset TileBitset::getOpenings(const PackedMaze& maze, Direction direction) {
+
+    // Gather the walls on the given side of each tile, mark the tiles on
+    // that edge of the maze as blocked too, and then invert
+    int width = maze.getWidth();
+    int height = maze.getHeight();
+    TileBitset openings(width, height);
+    switch (direction) {
+        case Direction::NORTH:
+            for (int x = 0; x < width; x += 1) {
+                openings.copyBits(
+                    maze.getHorizontalWords(), x * (height + 1) + 1, x * height, height);
+                openings.set(x, height - 1);
+            }
+            break;
+        case Direction::EAST:
+            openings.copyBits(maze.getVerticalWords(), height, 0, width * height);
+            for (int y = 0; y < height; y += 1) {
+                openings.set(width - 1, y);
+            }
+            break;
+        case Direction::SOUTH:
+            for (int x = 0; x < width; x += 1) {
+                openings.copyBits(
+                    maze.getHorizontalWords(), x * (height + 1), x * height, height);
+                openings.set(x, 0);
+            }
+            break;
+        case Direction::WEST:
+            openings.copyBits(maze.getVerticalWords(), 0, 0, width * height);
+            for (int y = 0; y < height; y += 1) {
+                openings.set(0, y);
+            }
+            break;
+    }
+    openings.invert();
+    return openings;
+}
+
+TileBitset TileBitset::flood(const PackedMaze& maze, const TileBitset& seeds) {
+
+    ASSERT_EQ(seeds.getWidth(), maze.getWidth());
+    ASSERT_EQ(seeds.getHeight(), maze.getHeight());
+    int height = maze.getHeight();
+
+    // Moving north or south shifts a tile's index by one, and moving east
+    // or west shifts it by a column
+    TileBitset openings[4];
+    int shifts[4];
+    for (int i = 0; i < DIRECTIONS().size(); i += 1) {
+        Direction direction = DIRECTIONS().at(i);
+        openings[i] = getOpenings(maze, direction);
+        shifts[i] = (
+            direction == Direction::NORTH ? 1 :
+            direction == Direction::EAST ? height :
+            direction == Direction::SOUTH ? -1 :
+            -height
+        );
+    }
+
+    TileBitset reached = seeds;
+    TileBitset frontier = seeds;
+    TileBitset next(maze.getWidth(), height);
+    QVector<int> frontierWords;
+    for (int i = 0; i < seeds.m_words.size(); i += 1) {
+        if (seeds.m_words.at(i) != 0) {
+            frontierWords.append(i);
+        }
+    }
+
+    // The candidate words may repeat; only the first visit finds new tiles
+    QVector<int> candidateWords;
+    while (!frontierWords.isEmpty()) {
+        candidateWords.clear();
+        for (int word : frontierWords) {
+            quint64 bits = frontier.m_words.at(word);
+            frontier.m_words[word] = 0;
+            for (int i = 0; i < 4; i += 1) {
+                quint64 moving = bits & openings[i].m_words.at(word);
+                if (moving == 0) {
+                    continue;
+                }
+                // The openings guarantee that no tile moves out of the maze
+                int start = 64 * word + shifts[i];
+                if (start < 0) {
+                    moving >>= -start;
+                    start = 0;
+                }
+                next.orBits(moving, start);
+                candidateWords.append(start >> 6);
+                if ((start & 63) != 0 && (start >> 6) + 1 < next.m_words.size()) {
+                    candidateWords.append((start >> 6) + 1);
+                }
+            }
+        }
+        frontierWords.clear();
+        for (int word : candidateWords) {
+            quint64 fresh = next.m_words.at(word) & ~reached.m_words.at(word);
+            next.m_words[word] = 0;
+            if (fresh != 0) {
+                reached.m_words[word] |= fresh;
+                frontier.m_words[word] = fresh;
+                frontierWords.append(word);
+            }
+        }
+    }
+
+    return reached;
+}
+
+quint64 TileBitset::readBits(const QVector<quint64>& plane, int start) {
+    int word = start >> 6;
+    int shift = start & 63;
+    if (plane.size() <= word) {
+        return 0;
+    }
+    quint64 bits = plane.at(word) >> shift;
+    if (shift != 0 && word + 1 < plane.size()) {
+        bits |= plane.at(word + 1) << (64 - shift);
+    }
+    return bits;
+}
+
+void TileBitset::orBits(quint64 bits, int start) {
+    int word = start >> 6;
+    int shift = start & 63;
+    if (m_words.size() <= word) {
+        return;
+    }
+    m_words[word] |= bits << shift;
+    if (shift != 0 && word + 1 < m_words.size()) {
+        m_words[word + 1] |= bits >> (64 - shift);
+    }
+}
+
+void TileBitset::copyBits(
+        const QVector<quint64>& plane,
+        int planeStart,
+        int start,
+        int count) {
+    for (int i = 0; i < count; i += 64) {
+        quint64 bits = readBits(plane, planeStart + i);
+        if (count - i < 64) {
+            bits &= (quint64(1) << (count - i)) - 1;
+        }
+        orBits(bits, start + i);
+    }
+}
+
+void TileBitset::invert() {
+    for (quint64& word : m_words) {
+        word = ~word;
+    }
+    int numTiles = m_width * m_height;
+    if (numTiles % 64 != 0) {
+        m_words.last() &= (quint64(1) << (numTiles % 64)) - 1;
+    }
+}
+
+} // namespace mms
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QPair>
+#include <QVector>
+
+#include "Direction.h"
+#include "PackedMaze.h"
+
+namespace mms {
+
+// A set of tiles, one bit per tile, indexed by x * height + y (the same
+// order as the vertical bit-plane of PackedMaze). Operations work a word
+// (64 tiles) at a time, which is what makes checking and searching large
+// mazes cheap.
+class TileBitset {
+
+public:
+
+    TileBitset();
+    TileBitset(int width, int height);
+
+    int getWidth() const;
+    int getHeight() const;
+
+    bool test(int x, int y) const;
+    void set(int x, int y);
+    void reset(int x, int y);
+    int count() const;
+
+    TileBitset& operator&=(const TileBitset& other);
+
+    // The set with each tile's index decreased by the offset (e.g., an
+    // offset of one yields each tile's northern neighbor's bit, and an
+    // offset of height yields its eastern neighbor's bit); tiles past the
+    // end read as zero
+    TileBitset shifted(int offset) const;
+
+    // The first few tiles in the set (or not in the set), in index order
+    QVector<QPair<int, int>> getTiles(int limit, bool inSet = true) const;
+
+    // The tiles from which a step in the given direction stays within the
+    // maze and doesn't cross a wall
+    static TileBitset getOpenings(const PackedMaze& maze, Direction direction);
+
+    // All tiles reachable from the seeds. This is a breadth-first search
+    // whose frontier is a bitmask: each step moves every frontier tile at
+    // once, a word at a time, and only the words that the frontier actually
+    // occupies are visited, so long corridors cost as little as open areas.
+    static TileBitset flood(const PackedMaze& maze, const TileBitset& seeds);
+
+private:
+
+    int m_width;
+    int m_height;
+    QVector<quint64> m_words;
+
+    // Reads 64 bits of a plane, or ORs 64 bits into this set, starting at
+    // the given bit; bits past the end read as zero and aren't written
+    static quint64 readBits(const QVector<quint64>& plane, int start);
+    void orBits(quint64 bits, int start);
+
+    // ORs count bits of the plane, starting at planeStart, into this set,
+    // starting at start
+    void copyBits(const QVector<quint64>& plane, int planeStart, int start, int count);
+    void invert();
+};
+
+} // namespace mms
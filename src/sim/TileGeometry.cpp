@@ -0,0 +1,89 @@
+#include "TileGeometry.h"
+
+#include "Assert.h"
+#include "Param.h"
+#include "units/Coordinate.h"
+#include "units/Distance.h"
+
+namespace mms {
+
+TileRect TileGeometry::getFullRect(int x, int y, int mazeWidth, int mazeHeight) {
+    std::array<double, 4> xs = getBounds(x, mazeWidth);
+    std::array<double, 4> ys = getBounds(y, mazeHeight);
+    return {xs[0], ys[0], xs[3], ys[3]};
+}
+
+TileRect TileGeometry::getInteriorRect(int x, int y, int mazeWidth, int mazeHeight) {
+    std::array<double, 4> xs = getBounds(x, mazeWidth);
+    std::array<double, 4> ys = getBounds(y, mazeHeight);
+    return {xs[1], ys[1], xs[2], ys[2]};
+}
+
+TileRect TileGeometry::getWallRect(
+        int x,
+        int y,
+        int mazeWidth,
+        int mazeHeight,
+        Direction direction) {
+    std::array<double, 4> xs = getBounds(x, mazeWidth);
+    std::array<double, 4> ys = getBounds(y, mazeHeight);
+    switch (direction) {
+        case Direction::NORTH:
+            return {xs[1], ys[2], xs[2], ys[3]};
+        case Direction::EAST:
+            return {xs[2], ys[1], xs[3], ys[2]};
+        case Direction::SOUTH:
+            return {xs[1], ys[0], xs[2], ys[1]};
+        case Direction::WEST:
+            break;
+    }
+    return {xs[0], ys[1], xs[1], ys[2]};
+}
+
+TileRect TileGeometry::getCornerRect(
+        int x,
+        int y,
+        int mazeWidth,
+        int mazeHeight,
+        int cornerNumber) {
+    ASSERT_LE(0, cornerNumber);
+    ASSERT_LT(cornerNumber, 4);
+    std::array<double, 4> xs = getBounds(x, mazeWidth);
+    std::array<double, 4> ys = getBounds(y, mazeHeight);
+    switch (cornerNumber) {
+        case 0:
+            return {xs[0], ys[0], xs[1], ys[1]};
+        case 1:
+            return {xs[0], ys[2], xs[1], ys[3]};
+        case 2:
+            return {xs[2], ys[2], xs[3], ys[3]};
+    }
+    return {xs[2], ys[0], xs[3], ys[1]};
+}
+
+Polygon TileGeometry::toPolygon(const TileRect& rect) {
+    return Polygon({
+        Coordinate::Cartesian(Distance::Meters(rect.left), Distance::Meters(rect.bottom)),
+        Coordinate::Cartesian(Distance::Meters(rect.left), Distance::Meters(rect.top)),
+        Coordinate::Cartesian(Distance::Meters(rect.right), Distance::Meters(rect.top)),
+        Coordinate::Cartesian(Distance::Meters(rect.right), Distance::Meters(rect.bottom)),
+    });
+}
+
+std::array<double, 4> TileGeometry::getBounds(int index, int count) {
+    // The unit-tile template, offset by the index times the tile length; the
+    // inner boundaries never move, but the outer boundaries of the first and
+    // last tiles are pushed out by half a wall so that the walls on the edge
+    // of the maze are the same width as the interior walls
+    double halfWallWidth = P()->wallWidth() / 2.0;
+    double tileLength = P()->wallLength() + P()->wallWidth();
+    double offset = tileLength * index;
+    return {
+        offset - (index == 0 ? halfWallWidth : 0.0),
+        offset + halfWallWidth,
+        offset + tileLength - halfWallWidth,
+        offset + tileLength + (index == count - 1 ? halfWallWidth : 0.0),
+    };
+}
+
+} // namespace mms
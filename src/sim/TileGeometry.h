@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+
+#include "Direction.h"
+#include "Polygon.h"
+
+namespace mms {
+
+// An axis-aligned rectangle, in meters
+struct TileRect {
+    double left;
+    double bottom;
+    double right;
+    double top;
+};
+
+// Every tile of a maze has the same shape: a unit-tile template, offset by
+// (x, y) times the tile length, with the outer edges of the maze widened by
+// half a wall width. Rather than storing polygons per tile, all tile
+// geometry is generated on demand from that template.
+//
+//      5---6-------------9---a      Along each axis, a tile is cut by four
+//      |   |             |   |      boundaries: outer-low (0/5), inner-low
+//      4---7-------------8---b      (2/7), inner-high (d/8), outer-high
+//      |   |             |   |      (f/a). Every polygon of the tile is a
+//      |   |             |   |      rectangle between two of them:
+//      |   |             |   |
+//      |   |             |   |          full: 05af
+//      |   |             |   |          interior: 278d
+//      1---2-------------d---e          walls: 7698, d8be, 32dc, 1472
+//      |   |             |   |          corners: 0123, 4567, 89ab, cdef
+//      0---3-------------c---f
+//
+class TileGeometry {
+
+public:
+
+    // This class is not constructible
+    TileGeometry() = delete;
+
+    static TileRect getFullRect(int x, int y, int mazeWidth, int mazeHeight);
+    static TileRect getInteriorRect(int x, int y, int mazeWidth, int mazeHeight);
+    static TileRect getWallRect(
+        int x,
+        int y,
+        int mazeWidth,
+        int mazeHeight,
+        Direction direction);
+
+    // Corners are numbered lower-left, upper-left, upper-right, lower-right
+    static TileRect getCornerRect(
+        int x,
+        int y,
+        int mazeWidth,
+        int mazeHeight,
+        int cornerNumber);
+
+    // The rectangle as a polygon, with vertices starting at the lower left
+    // and proceeding clockwise
+    static Polygon toPolygon(const TileRect& rect);
+
+private:
+
+    // The four boundaries of the tile at the given index along one axis
+    static std::array<double, 4> getBounds(int index, int count);
+};
+
+} // namespace mms
@@ -5,45 +5,47 @@
 #include "Assert.h"
 #include "Color.h"
 #include "ColorManager.h"
-#include "FontImage.h"
 #include "Param.h"
+#include "TileGeometry.h"
 
 namespace mms {
 
 TileGraphic::TileGraphic() :
-    m_tile(nullptr),
+    m_maze(nullptr),
+    m_x(-1),
+    m_y(-1),
     m_bufferInterface(nullptr),
     m_color(Color::BLACK),
     m_foggy(false),
     m_wallTruthVisible(false),
     m_tileColorsVisible(false),
     m_tileFogVisible(false),
-    m_tileTextVisible(false) {
+    m_tileTextVisible(false),
+    m_autopopulateTextWithDistance(false) {
 }
 
 TileGraphic::TileGraphic(
-        const Tile* tile,
+        const Maze* maze,
+        int x,
+        int y,
         BufferInterface* bufferInterface,
         bool wallTruthVisible,
         bool tileColorsVisible,
         bool tileFogVisible,
         bool tileTextVisible,
         bool autopopulateTextWithDistance) :
-        m_tile(tile),
+        m_maze(maze),
+        m_x(x),
+        m_y(y),
         m_bufferInterface(bufferInterface),
         m_color(ColorManager::get()->getTileBaseColor()),
         m_foggy(true),
         m_wallTruthVisible(wallTruthVisible),
         m_tileColorsVisible(tileColorsVisible),
         m_tileFogVisible(tileFogVisible),
-        m_tileTextVisible(tileTextVisible) {
-    if (autopopulateTextWithDistance) {
-        m_text = (
-            0 <= m_tile->getDistance()
-            ? QString::number(m_tile->getDistance())
-            : "inf"
-        );
-    }
+        m_tileTextVisible(tileTextVisible),
+        m_autopopulateTextWithDistance(autopopulateTextWithDistance) {
+    populateTextWithDistance();
 }
 
 void TileGraphic::setColor(Color color) {
@@ -91,15 +93,37 @@ void TileGraphic::setTileTextVisible(bool visible) {
     updateText();
 }
 
+void TileGraphic::refresh() {
+    updateWalls();
+    if (m_autopopulateTextWithDistance) {
+        populateTextWithDistance();
+        updateText();
+    }
+}
+
 void TileGraphic::drawPolygons() const {
 
+    // Tile images already have a texel for every polygon; just fill them in
+    if (m_bufferInterface->usesTileImage()) {
+        updateColor();
+        updateWalls();
+        updateFog();
+        return;
+    }
+
     // Note that the order in which we call insertIntoGraphicCpuBuffer
     // determines the order in which the polygons are drawn. Also note that the
     // *StartingIndex methods in GrahicsUtilities.h depend upon this order.
 
+    int x = m_x;
+    int y = m_y;
+    int mazeWidth = m_maze->getWidth();
+    int mazeHeight = m_maze->getHeight();
+    TileRect fullRect = TileGeometry::getFullRect(x, y, mazeWidth, mazeHeight);
+
     // Draw the base of the tile
     m_bufferInterface->insertIntoGraphicCpuBuffer(
-        m_tile->getFullPolygon(),
+        fullRect,
         m_tileColorsVisible
             ? m_color
             : ColorManager::get()->getTileBaseColor(),
@@ -109,22 +133,22 @@ void TileGraphic::drawPolygons() const {
     for (Direction direction : DIRECTIONS()) {
         QPair<Color, float> colorAndAlpha = deduceWallColorAndAlpha(direction);
         m_bufferInterface->insertIntoGraphicCpuBuffer(
-            m_tile->getWallPolygon(direction),
+            TileGeometry::getWallRect(x, y, mazeWidth, mazeHeight, direction),
             colorAndAlpha.first,
             colorAndAlpha.second);
     }
 
     // Draw the corners of the tile
-    for (Polygon polygon : m_tile->getCornerPolygons()) {
+    for (int i = 0; i < 4; i += 1) {
         m_bufferInterface->insertIntoGraphicCpuBuffer(
-            polygon,
+            TileGeometry::getCornerRect(x, y, mazeWidth, mazeHeight, i),
             ColorManager::get()->getTileCornerColor(),
             1.0);
     }
 
     // Draw the fog
     m_bufferInterface->insertIntoGraphicCpuBuffer(
-        m_tile->getFullPolygon(),
+        fullRect,
         ColorManager::get()->getTileFogColor(),
         m_foggy && m_tileFogVisible
             ? ColorManager::get()->getTileFogAlpha()
@@ -132,6 +156,9 @@ void TileGraphic::drawPolygons() const {
 }
 
 void TileGraphic::drawTextures() {
+    if (m_bufferInterface->usesTileImage()) {
+        return;
+    }
     // Insert all of the triangle texture objects into the buffer ...
     QPair<int, int> maxRowsAndCols =
         m_bufferInterface->getTileGraphicTextMaxSize();
@@ -146,8 +173,8 @@ void TileGraphic::drawTextures() {
 
 void TileGraphic::updateColor() const {
     m_bufferInterface->updateTileGraphicBaseColor(
-        m_tile->getX(),
-        m_tile->getY(),
+        m_x,
+        m_y,
         m_tileColorsVisible
             ? m_color
             : ColorManager::get()->getTileBaseColor());
@@ -161,8 +188,8 @@ void TileGraphic::updateWalls() const {
 
 void TileGraphic::updateFog() const {
     m_bufferInterface->updateTileGraphicFog(
-        m_tile->getX(),
-        m_tile->getY(),
+        m_x,
+        m_y,
         m_foggy && m_tileFogVisible
             ? ColorManager::get()->getTileFogAlpha()
             : 0.0);
@@ -185,45 +212,20 @@ void TileGraphic::updateText() const {
         remaining = remaining.mid(maxRowsAndCols.second);
     }
 
-    // For all possible character positions, insert some character
-    // (blank if necessary) into the tile text cpu buffer
-    for (int row = 0; row < maxRowsAndCols.first; row += 1) {
-        for (int col = 0; col < maxRowsAndCols.second; col += 1) {
-            int numRows = std::min(
-                static_cast<int>(rowsOfText.size()),
-                maxRowsAndCols.first
-            );
-            int numCols = std::min(
-                static_cast<int>(row < rowsOfText.size() ? rowsOfText.at(row).size() : 0),
-                maxRowsAndCols.second
-            );
-            QChar c = ' ';
-            if (
-                m_tileTextVisible &&
-                row < rowsOfText.size() &&
-                col < rowsOfText.at(row).size()
-            ) {
-                c = rowsOfText.at(row).at(col).toLatin1();
-            }
-            ASSERT_TR(FontImage::get()->positions().contains(c));
-            m_bufferInterface->updateTileGraphicText(
-                m_tile->getX(),
-                m_tile->getY(),
-                numRows,
-                numCols,
-                row,
-                col,
-                c
-            );
-        }
-    }
+    // Write all of the characters (blank if necessary) into the tile text
+    // cpu buffer at once; invisible text is written as no text at all
+    m_bufferInterface->updateTileGraphicText(
+        m_x,
+        m_y,
+        m_tileTextVisible ? rowsOfText : QVector<QString>()
+    );
 }
 
 void TileGraphic::updateWall(Direction direction) const {
     QPair<Color, float> colorAndAlpha = deduceWallColorAndAlpha(direction);
     m_bufferInterface->updateTileGraphicWallColor(
-        m_tile->getX(),
-        m_tile->getY(),
+        m_x,
+        m_y,
         direction,
         colorAndAlpha.first,
         colorAndAlpha.second
@@ -232,13 +234,16 @@ void TileGraphic::updateWall(Direction direction) const {
 
 QPair<Color, float> TileGraphic::deduceWallColorAndAlpha(Direction direction) const {
 
+    // Whether or not the wall actually exists
+    bool isWall = m_maze->isWall(m_x, m_y, direction);
+
     // Declare the wall color and alpha, assign defaults
     Color wallColor = ColorManager::get()->getTileWallColor();
     float wallAlpha = 1.0;
 
     // Either draw the true walls of the tile ...
     if (m_wallTruthVisible) {
-        wallAlpha = m_tile->isWall(direction) ? 1.0 : 0.0;
+        wallAlpha = isWall ? 1.0 : 0.0;
     }
 
     // ... or the algorithm's (un)declared walls
@@ -248,7 +253,7 @@ QPair<Color, float> TileGraphic::deduceWallColorAndAlpha(Direction direction) co
         if (m_declaredWalls.contains(direction)) {
             if (m_declaredWalls.value(direction)) {
                 // Correct declaration
-                if (m_tile->isWall(direction)) {
+                if (isWall) {
                     wallColor = ColorManager::get()->getTileWallColor();
                 }
                 // Incorrect declaration
@@ -258,7 +263,7 @@ QPair<Color, float> TileGraphic::deduceWallColorAndAlpha(Direction direction) co
             }
             else {
                 // Incorrect declaration
-                if (m_tile->isWall(direction)) {
+                if (isWall) {
                     wallColor = ColorManager::get()->getIncorrectlyDeclaredNoWallColor();
                 }
                 // Correct declaration
@@ -270,7 +275,7 @@ QPair<Color, float> TileGraphic::deduceWallColorAndAlpha(Direction direction) co
 
         // ... otherwise, use the undeclared walls colors
         else {
-            if (m_tile->isWall(direction)) {
+            if (isWall) {
                 wallColor = ColorManager::get()->getUndeclaredWallColor();
             }
             else {
@@ -288,4 +293,15 @@ QPair<Color, float> TileGraphic::deduceWallColorAndAlpha(Direction direction) co
     return {wallColor, wallAlpha};
 }
 
+void TileGraphic::populateTextWithDistance() {
+    // Tile text isn't drawn for tile images, so don't bother storing it
+    if (m_autopopulateTextWithDistance && !m_bufferInterface->usesTileImage()) {
+        m_text = (
+            0 <= m_maze->getDistance(m_x, m_y)
+            ? QString::number(m_maze->getDistance(m_x, m_y))
+            : "inf"
+        );
+    }
+}
+
 } // namespace mms
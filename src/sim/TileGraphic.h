@@ -5,7 +5,7 @@
 
 #include "BufferInterface.h"
 #include "Color.h"
-#include "Tile.h"
+#include "Maze.h"
 
 namespace mms {
 
@@ -15,7 +15,9 @@ public:
 
     TileGraphic();
     TileGraphic(
-        const Tile* tile,
+        const Maze* maze,
+        int x,
+        int y,
         BufferInterface* bufferInterface,
         bool wallTruthVisible,
         bool tileColorsVisible,
@@ -34,6 +36,9 @@ public:
     void setTileFogVisible(bool visible);
     void setTileTextVisible(bool visible);
 
+    // Re-reads the tile's walls and distance after the maze was edited
+    void refresh();
+
     // TODO: MACK - rename these to "reload" or something
     void drawPolygons() const;
     void drawTextures();
@@ -48,7 +53,9 @@ public:
 private:
 
     // Input and output objects
-    const Tile* m_tile;
+    const Maze* m_maze;
+    int m_x;
+    int m_y;
     BufferInterface* m_bufferInterface;
 
     // Visual state
@@ -62,9 +69,11 @@ private:
     bool m_tileColorsVisible;
     bool m_tileFogVisible;
     bool m_tileTextVisible;
+    bool m_autopopulateTextWithDistance;
 
     // Helper functions
     void updateWall(Direction direction) const;
+    void populateTextWithDistance();
     QPair<Color, float> deduceWallColorAndAlpha(Direction direction) const;
 };
 
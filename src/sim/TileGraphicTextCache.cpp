@@ -1,7 +1,6 @@
 #include "TileGraphicTextCache.h"
 
 #include "Assert.h"
-#include "FontImage.h"
 
 namespace mms {
 
@@ -20,35 +19,32 @@ QPair<int, int> TileGraphicTextCache::getTileGraphicTextMaxSize() const {
     return m_tileGraphicTextMaxSize;
 }
 
-QPair<double, double> TileGraphicTextCache::getFontImageCharacterPosition(QChar c) const {
-    ASSERT_TR(FontImage::get()->positions().contains(c));
-    return FontImage::get()->positions().value(c);
+double TileGraphicTextCache::getTileLength() const {
+    return (m_wallLength + m_wallWidth).getMeters();
 }
 
-QPair<Coordinate, Coordinate> TileGraphicTextCache::getTileGraphicTextPosition(
-        int x, int y, int numRows, int numCols, int row, int col) const {
-
-    // Get the character position in the maze for the starting tile
-    QPair<Coordinate, Coordinate> textPosition = m_tileGraphicTextPositions.value(
-        {
-            {numRows, numCols},
-            {row, col}
-        }
-    );
-
-    // Now get the character position in the maze for *this* tile
-    Distance tileLength = m_wallLength + m_wallWidth;
-    Coordinate offset = Coordinate::Cartesian(tileLength * x, tileLength * y);
-    Coordinate LL = textPosition.first + offset;
-    Coordinate UR = textPosition.second + offset;
+const double* TileGraphicTextCache::getTileGraphicTextPosition(
+        int numRows, int numCols, int row, int col) const {
+    return m_tileGraphicTextPositions.constData() +
+        getPositionCacheIndex(numRows, numCols, row, col);
+}
 
-    return {LL, UR};
+int TileGraphicTextCache::getPositionCacheIndex(
+        int numRows, int numCols, int row, int col) const {
+    int maxRows = m_tileGraphicTextMaxSize.first;
+    int maxCols = m_tileGraphicTextMaxSize.second;
+    ASSERT_LE(0, numRows);
+    ASSERT_LE(numRows, maxRows);
+    ASSERT_LE(0, numCols);
+    ASSERT_LE(numCols, maxCols);
+    ASSERT_LE(0, row);
+    ASSERT_LT(row, maxRows);
+    ASSERT_LE(0, col);
+    ASSERT_LT(col, maxCols);
+    return 4 * (((numRows * (maxCols + 1) + numCols) * maxRows + row) * maxCols + col);
 }
 
-QMap<
-    QPair<QPair<int, int>, QPair<int, int>>,
-    QPair<Coordinate, Coordinate>>
-TileGraphicTextCache::buildPositionCache() {
+QVector<double> TileGraphicTextCache::buildPositionCache() {
 
     // The tile graphic text could look like either of the following, depending
     // on the layout, border, and max size
@@ -71,12 +67,11 @@ TileGraphicTextCache::buildPositionCache() {
     //     *[A]--------------------------*-*    *[A]--------------------------*-*
     //     *-*---------------------------*-*    *-*---------------------------*-*
 
-    QMap<
-        QPair<QPair<int, int>, QPair<int, int>>,
-        QPair<Coordinate, Coordinate>> positionCache;
-
     int maxRows = m_tileGraphicTextMaxSize.first;
     int maxCols = m_tileGraphicTextMaxSize.second;
+
+    // Every entry starts out as an empty rectangle at the origin
+    QVector<double> positionCache(4 * (maxRows + 1) * (maxCols + 1) * maxRows * maxCols, 0.0);
     double borderFraction = 0.05;  // border padding
 
     // First we get the unscaled diagonal
@@ -124,13 +119,11 @@ TileGraphicTextCache::buildPositionCache() {
                     );
 
                     // Insert the position into the cache
-                    positionCache.insert(
-                        {
-                            {numRows, numCols}, // Num rows/cols to be drawn
-                            {row, col} // Row and col of the current character
-                        },
-                        {LL, UR} // Lower left and upper right texture coord
-                    );
+                    int index = getPositionCacheIndex(numRows, numCols, row, col);
+                    positionCache[index + 0] = LL.getX().getMeters();
+                    positionCache[index + 1] = LL.getY().getMeters();
+                    positionCache[index + 2] = UR.getX().getMeters();
+                    positionCache[index + 3] = UR.getY().getMeters();
                 }
             }
         }
@@ -1,8 +1,7 @@
 #pragma once
 
-#include <QChar>
-#include <QMap>
 #include <QPair>
+#include <QVector>
 
 #include "units/Coordinate.h"
 
@@ -21,12 +20,14 @@ public:
     // Returns the max number of rows and columns of tile graphic text
     QPair<int, int> getTileGraphicTextMaxSize() const;
 
-    // Return a characters starting and ending position in the font image
-    QPair<double, double> getFontImageCharacterPosition(QChar c) const;
+    // Returns the distance between the origins of adjacent tiles, in meters
+    double getTileLength() const;
 
-    // Retrieve the LL and UR coordinates for a particular location
-    QPair<Coordinate, Coordinate> getTileGraphicTextPosition(
-        int x, int y, int numRows, int numCols, int row, int col) const;
+    // Retrieve the LL and UR coordinates of a character, in meters and for the
+    // starting tile, namely tile (0, 0), as the four values {LLx, LLy, URx,
+    // URy}. Positions outside of the displayed rows/cols are empty rectangles.
+    const double* getTileGraphicTextPosition(
+        int numRows, int numCols, int row, int col) const;
 
 private:
 
@@ -37,16 +38,16 @@ private:
     // The max rows and cols of text per tile
     QPair<int, int> m_tileGraphicTextMaxSize;
 
-    // A map of the number of rows/cols to be displayed and the current row/col
-    // to the LL/UR text coordinates for the starting tile, namely tile (0, 0)
-    QMap<
-        QPair<QPair<int, int>, QPair<int, int>>,
-        QPair<Coordinate, Coordinate>> m_tileGraphicTextPositions;
+    // The LL/UR text coordinates for the starting tile, namely tile (0, 0),
+    // for every number of rows/cols to be displayed and every current row/col
+    QVector<double> m_tileGraphicTextPositions;
+
+    // Maps the number of rows/cols and the current row/col
+    // to an index into the text position cache
+    int getPositionCacheIndex(int numRows, int numCols, int row, int col) const;
 
     // Just a helper method for building the text position cache
-    QMap<
-        QPair<QPair<int, int>, QPair<int, int>>,
-        QPair<Coordinate, Coordinate>> buildPositionCache();
+    QVector<double> buildPositionCache();
 };
 
 } // namespace mms
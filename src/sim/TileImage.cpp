@@ -0,0 +1,167 @@
+#include "TileImage.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Assert.h"
+#include "ColorManager.h"
+#include "Param.h"
+
+namespace mms {
+
+TileImage::TileImage() :
+        m_fogColor({0.0, 0.0, 0.0}),
+        m_version(0) {
+}
+
+TileImage::TileImage(int mazeWidth, int mazeHeight) :
+        m_image(
+            TEXELS_PER_TILE * mazeWidth,
+            TEXELS_PER_TILE * mazeHeight,
+            QImage::Format_RGBA8888),
+        m_fogColor(COLOR_TO_RGB().value(ColorManager::get()->getTileFogColor())),
+        m_rowVersions(mazeHeight, 0),
+        m_version(0) {
+
+    ASSERT_LT(0, mazeWidth);
+    ASSERT_LT(0, mazeHeight);
+
+    // Start with the base color, no walls, and no fog; the tile graphics
+    // overwrite all of it, except for the corners. Every tile starts out the
+    // same, so we write the first row of tiles and copy it to the others.
+    RGB base = COLOR_TO_RGB().value(ColorManager::get()->getTileBaseColor());
+    RGB corner = COLOR_TO_RGB().value(ColorManager::get()->getTileCornerColor());
+    for (int x = 0; x < mazeWidth; x += 1) {
+        for (int i = 0; i < TEXELS_PER_TILE; i += 1) {
+            for (int j = 0; j < TEXELS_PER_TILE; j += 1) {
+                if (i == 1 && j == 1) {
+                    setTexel(x, 0, i, j, base, 1.0);
+                }
+                else if (i == 1 || j == 1) {
+                    setTexel(x, 0, i, j, base, 0.0);
+                }
+                else {
+                    setTexel(x, 0, i, j, corner, 1.0);
+                }
+            }
+        }
+    }
+    for (int row = TEXELS_PER_TILE; row < m_image.height(); row += 1) {
+        std::copy(
+            m_image.constScanLine(row % TEXELS_PER_TILE),
+            m_image.constScanLine(row % TEXELS_PER_TILE) + m_image.bytesPerLine(),
+            m_image.scanLine(row));
+    }
+}
+
+bool TileImage::isNull() const {
+    return m_image.isNull();
+}
+
+int TileImage::getMazeWidth() const {
+    return m_image.width() / TEXELS_PER_TILE;
+}
+
+int TileImage::getMazeHeight() const {
+    return m_image.height() / TEXELS_PER_TILE;
+}
+
+void TileImage::setBaseColor(int x, int y, Color color) {
+    // Keep the fog, which lives in the alpha channel
+    int row = TEXELS_PER_TILE * y + 1;
+    int col = TEXELS_PER_TILE * x + 1;
+    double alpha = m_image.constScanLine(row)[4 * col + 3] / 255.0;
+    setTexel(x, y, 1, 1, COLOR_TO_RGB().value(color), alpha);
+}
+
+void TileImage::setWallColor(int x, int y, Direction direction, Color color, double alpha) {
+    RGB rgb = COLOR_TO_RGB().value(color);
+    switch (direction) {
+        case Direction::NORTH:
+            setTexel(x, y, 1, 2, rgb, alpha);
+            break;
+        case Direction::EAST:
+            setTexel(x, y, 2, 1, rgb, alpha);
+            break;
+        case Direction::SOUTH:
+            setTexel(x, y, 1, 0, rgb, alpha);
+            break;
+        case Direction::WEST:
+            setTexel(x, y, 0, 1, rgb, alpha);
+            break;
+    }
+}
+
+void TileImage::setFog(int x, int y, double alpha) {
+    int row = TEXELS_PER_TILE * y + 1;
+    int col = TEXELS_PER_TILE * x + 1;
+    const uchar* texel = m_image.constScanLine(row) + 4 * col;
+    RGB base = {texel[0] / 255.0, texel[1] / 255.0, texel[2] / 255.0};
+    setTexel(x, y, 1, 1, base, 1.0 - alpha);
+}
+
+const QImage& TileImage::getImage() const {
+    return m_image;
+}
+
+RGB TileImage::getFogColor() const {
+    return m_fogColor;
+}
+
+const QVector<quint32>& TileImage::getRowVersions() const {
+    return m_rowVersions;
+}
+
+QRgb TileImage::sample(double x, double y) const {
+
+    // Keep this in sync with the map's tile image fragment shader
+    double halfWallWidth = P()->wallWidth() / 2.0;
+    double tileLength = P()->wallLength() + P()->wallWidth();
+    int tileX = std::min(std::max(
+        static_cast<int>(std::floor(x / tileLength)), 0), getMazeWidth() - 1);
+    int tileY = std::min(std::max(
+        static_cast<int>(std::floor(y / tileLength)), 0), getMazeHeight() - 1);
+    double localX = x - tileX * tileLength;
+    double localY = y - tileY * tileLength;
+    int i = (localX < halfWallWidth ? 0 : (tileLength - halfWallWidth <= localX ? 2 : 1));
+    int j = (localY < halfWallWidth ? 0 : (tileLength - halfWallWidth <= localY ? 2 : 1));
+
+    const uchar* layer =
+        m_image.constScanLine(TEXELS_PER_TILE * tileY + j) +
+        4 * (TEXELS_PER_TILE * tileX + i);
+    const uchar* base =
+        m_image.constScanLine(TEXELS_PER_TILE * tileY + 1) +
+        4 * (TEXELS_PER_TILE * tileX + 1);
+
+    double layerAlpha = layer[3] / 255.0;
+    double fogAlpha = 1.0 - base[3] / 255.0;
+    double channels[3];
+    double fog[3] = {m_fogColor.r, m_fogColor.g, m_fogColor.b};
+    for (int k = 0; k < 3; k += 1) {
+        double color = (
+            (i == 1 && j == 1)
+            ? base[k] / 255.0
+            : (1.0 - layerAlpha) * base[k] / 255.0 + layerAlpha * layer[k] / 255.0
+        );
+        channels[k] = (1.0 - fogAlpha) * color + fogAlpha * fog[k];
+    }
+    return qRgb(
+        static_cast<int>(255.0 * channels[0] + 0.5),
+        static_cast<int>(255.0 * channels[1] + 0.5),
+        static_cast<int>(255.0 * channels[2] + 0.5));
+}
+
+void TileImage::setTexel(int x, int y, int i, int j, RGB rgb, double alpha) {
+    ASSERT_TR(0 <= x && x < getMazeWidth() && 0 <= y && y < getMazeHeight());
+    uchar* texel =
+        m_image.scanLine(TEXELS_PER_TILE * y + j) +
+        4 * (TEXELS_PER_TILE * x + i);
+    texel[0] = static_cast<uchar>(255.0 * rgb.r + 0.5);
+    texel[1] = static_cast<uchar>(255.0 * rgb.g + 0.5);
+    texel[2] = static_cast<uchar>(255.0 * rgb.b + 0.5);
+    texel[3] = static_cast<uchar>(255.0 * alpha + 0.5);
+    m_version += 1;
+    m_rowVersions[y] = m_version;
+}
+
+} // namespace mms
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QImage>
+#include <QVector>
+
+#include "Color.h"
+#include "Direction.h"
+#include "RGB.h"
+
+namespace mms {
+
+// A compact stand-in for the per-tile triangles, used for mazes that are too
+// large to draw polygon by polygon. Each tile is a 3x3 block of texels:
+//
+//      +---+---+---+
+//      | 1 | N | 2 |      The middle texel holds the base color of the tile,
+//      +---+---+---+      with the fog stored (inverted) in its alpha. The
+//      | W | B | E |      edge texels hold the wall colors and alphas, and
+//      +---+---+---+      the corner texels hold the corner color.
+//      | 0 | S | 3 |
+//      +---+---+---+
+//
+// The map's tile image shader (and sample(), below) composite the walls over
+// the base and the fog over both, which matches the polygon path exactly.
+// Texel row r holds tile row r / 3; the image is not mirrored.
+class TileImage {
+
+public:
+
+    static const int TEXELS_PER_TILE = 3;
+
+    TileImage();
+    TileImage(int mazeWidth, int mazeHeight);
+
+    bool isNull() const;
+    int getMazeWidth() const;
+    int getMazeHeight() const;
+
+    void setBaseColor(int x, int y, Color color);
+    void setWallColor(int x, int y, Direction direction, Color color, double alpha);
+    void setFog(int x, int y, double alpha);
+
+    // The texels, in QImage::Format_RGBA8888
+    const QImage& getImage() const;
+    RGB getFogColor() const;
+
+    // Each tile row's version is bumped whenever one of its texels changes,
+    // so that only the changed rows need to be uploaded to the GPU
+    const QVector<quint32>& getRowVersions() const;
+
+    // The composited color at a physical point (in meters)
+    QRgb sample(double x, double y) const;
+
+private:
+
+    QImage m_image;
+    RGB m_fogColor;
+    QVector<quint32> m_rowVersions;
+    quint32 m_version;
+
+    void setTexel(int x, int y, int i, int j, RGB rgb, double alpha);
+};
+
+} // namespace mms
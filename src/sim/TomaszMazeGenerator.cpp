@@ -0,0 +1,852 @@
+#include "TomaszMazeGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace mms {
+
+const double TomaszMazeGenerator::STRAIGHT_FACTOR = 0.85;
+const double TomaszMazeGenerator::DEAD_END_BREAK_CHANCE = 0.75;
+
+void TomaszMazeGenerator::generate(MazeGeneratorInterface* interface) {
+
+    TomaszMazeGenerator generator(interface);
+    generator.generateMaze();
+
+    // The interface starts out without any walls, and sets both halves of
+    // each one, so only the southern and western walls of each tile (plus
+    // the outermost northern and eastern walls) need to be passed on
+    int width = generator.m_width;
+    int height = generator.m_height;
+    for (int x = 0; x < width; x += 1) {
+        for (int y = 0; y < height; y += 1) {
+            quint8 walls = generator.m_walls.at(x * height + y);
+            if (y == height - 1 && (walls & 1)) {
+                interface->setWall(x, y, 'n', true);
+            }
+            if (x == width - 1 && (walls & 2)) {
+                interface->setWall(x, y, 'e', true);
+            }
+            if (walls & 4) {
+                interface->setWall(x, y, 's', true);
+            }
+            if (walls & 8) {
+                interface->setWall(x, y, 'w', true);
+            }
+        }
+    }
+}
+
+TomaszMazeGenerator::TomaszMazeGenerator(MazeGeneratorInterface* interface) :
+        m_interface(interface),
+        m_width(interface->getWidth()),
+        m_height(interface->getHeight()),
+        m_walls(m_width * m_height, 15),
+        m_edges(m_width * m_height, 0),
+        m_isExplored(m_width * m_height, false),
+        m_isCenter(m_width * m_height, false),
+        m_moveConsts(m_width * m_height, 0.0f),
+        m_direction(-1),
+        m_depths(m_width * m_height, 0),
+        m_lows(m_width * m_height, std::numeric_limits<int>::max()),
+        m_distances(m_width * m_height, -1),
+        m_marks(m_width * m_height, 0),
+        m_mark(0),
+        m_queue(m_width * m_height, 0),
+        m_longestCorridor(0),
+        m_ringCount(0) {
+    m_offsets[0] = 1;
+    m_offsets[1] = m_height;
+    m_offsets[2] = -1;
+    m_offsets[3] = -m_height;
+    m_stack.reserve(m_width * m_height);
+    m_pairs.reserve(2 * m_width * m_height);
+
+    // The further from the center, the likelier the search is to go
+    // straight. The offsets are truncated to integers, as they are in the
+    // original (which passes them to the integer abs()), and the constant is
+    // narrowed to a float, as it is there.
+    QVector<double> yCenterDistances(m_height, 0.0);
+    for (int y = 0; y < m_height; y += 1) {
+        yCenterDistances[y] =
+            (std::abs(static_cast<int>(y - m_height / 2.0)) * 2.0) / (m_height - 1);
+    }
+    for (int x = 0; x < m_width; x += 1) {
+        double xCenterDistance =
+            (std::abs(static_cast<int>(x - m_width / 2.0)) * 2.0) / (m_width - 1);
+        for (int y = 0; y < m_height; y += 1) {
+            m_edges[x * m_height + y] = (
+                (y == m_height - 1 ? 1 : 0) |
+                (x == m_width - 1 ? 2 : 0) |
+                (y == 0 ? 4 : 0) |
+                (x == 0 ? 8 : 0)
+            );
+            m_moveConsts[x * m_height + y] = static_cast<float>(
+                STRAIGHT_FACTOR * std::max(xCenterDistance, yCenterDistances.at(y)));
+        }
+    }
+}
+
+void TomaszMazeGenerator::generateMaze() {
+
+    // Start with every wall, and a hollow center that the search won't enter
+    makeCenter();
+
+    quint8* walls = m_walls.data();
+    const quint8* edges = m_edges.constData();
+    bool* isExplored = m_isExplored.data();
+    const bool* isCenter = m_isCenter.constData();
+    const float* moveConsts = m_moveConsts.constData();
+    isExplored[0] = true;
+    m_stack.append(0);
+    while (!m_stack.isEmpty()) {
+
+        int tile = m_stack.last();
+        bool choices[4];
+        int possible = 0;
+        for (int direction = 0; direction < 4; direction += 1) {
+            int neighbor = tile + m_offsets[direction];
+            choices[direction] = (
+                !(edges[tile] & (1 << direction)) &&
+                !isExplored[neighbor] &&
+                !isCenter[neighbor]
+            );
+            possible += choices[direction] ? 1 : 0;
+        }
+
+        // At a dead end, maybe break through to the most distant neighbor,
+        // which makes the maze more open, and then backtrack
+        if (possible == 0) {
+            m_stack.removeLast();
+            int depth = m_stack.size();
+            int low = m_lows.at(depth);
+            m_lows[depth] = std::numeric_limits<int>::max();
+            if (!m_escapes.isEmpty() && m_escapes.last() == depth) {
+                m_escapes.removeLast();
+            }
+            if (m_direction != -1 && m_interface->getRandomFloat() <= DEAD_END_BREAK_CHANCE) {
+                updateDeadEndDistances(tile);
+                if (breakGradientWall(tile)) {
+                    m_shortcuts.append(tile);
+                    for (int direction = 0; direction < 4; direction += 1) {
+                        int neighbor = tile + m_offsets[direction];
+                        if (!(m_walls.at(tile) & (1 << direction)) && neighbor != m_stack.last()) {
+                            low = m_depths.at(neighbor);
+                        }
+                    }
+                }
+            }
+            if (depth > 0) {
+                m_lows[depth - 1] = std::min(m_lows.at(depth - 1), low);
+                if (m_lows.at(depth - 1) < depth - 1 &&
+                        (m_escapes.isEmpty() || m_escapes.last() != depth - 1)) {
+                    m_escapes.append(depth - 1);
+                }
+            }
+            m_direction = -1;
+            continue;
+        }
+
+        m_direction = getDirectionToMove(moveConsts[tile], choices, possible);
+        int next = tile + m_offsets[m_direction];
+        walls[tile] &= ~(1 << m_direction);
+        walls[next] &= ~(1 << ((m_direction + 2) % 4));
+        isExplored[next] = true;
+        m_depths[next] = m_stack.size();
+        m_stack.append(next);
+    }
+
+    breakGradientWalls();
+    pathIntoCenter();
+}
+
+void TomaszMazeGenerator::makeCenter() {
+
+    // The lower left tile of the center; for an odd side, it's the middle
+    int xCenter = static_cast<int>(std::round(m_width / 2.0) - 1);
+    int yCenter = static_cast<int>(std::round(m_height / 2.0) - 1);
+    int center = xCenter * m_height + yCenter;
+
+    m_isCenter[center] = true;
+    if (m_width % 2 == 0 && m_height % 2 == 0) {
+        setWall(center + m_height + 1, 2, false);
+        setWall(center + m_height + 1, 3, false);
+        m_isCenter[center + m_height + 1] = true;
+    }
+    if (m_width % 2 == 0) {
+        setWall(center, 1, false);
+        m_isCenter[center + m_height] = true;
+    }
+    if (m_height % 2 == 0) {
+        setWall(center, 0, false);
+        m_isCenter[center + 1] = true;
+    }
+}
+
+void TomaszMazeGenerator::breakGradientWalls() {
+
+    // The original searches from every tile in every pass; since the pairs
+    // of neighbors are all that's read, their distances are found once, and
+    // then only shortened by the walls that are broken
+    computePairDistances();
+    for (int i = 0; i < GRADIENT_WALL_BREAKS; i += 1) {
+
+        // Find the first tile with the largest distance to a neighbor; the
+        // pairs are in order of their lower tile, which is scanned first
+        int greatestGradient = 0;
+        int tileOfGreatest = 0;
+        for (const TilePair& pair : m_pairs) {
+            int gradient = std::abs(pair.distance);
+            if (greatestGradient < gradient) {
+                greatestGradient = gradient;
+                tileOfGreatest = pair.first;
+            }
+        }
+
+        // If no wall is broken, the next pass would find the same tile
+        updatePairNeighborDistances(tileOfGreatest);
+        if (!breakGradientWall(tileOfGreatest)) {
+            break;
+        }
+        if (i + 1 < GRADIENT_WALL_BREAKS) {
+            relaxPairDistances(tileOfGreatest);
+        }
+    }
+}
+
+void TomaszMazeGenerator::pathIntoCenter() {
+
+    int xCenter = static_cast<int>(std::round(m_width / 2.0) - 1);
+    int yCenter = static_cast<int>(std::round(m_height / 2.0) - 1);
+    int center = xCenter * m_height + yCenter;
+
+    // The center tiles other than the lower left one, in the order that the
+    // original considers them
+    QVector<int> candidates;
+    if (m_width % 2 == 0 && m_height % 2 == 0) {
+        candidates.append(center + m_height + 1);
+    }
+    if (m_width % 2 == 0) {
+        candidates.append(center + m_height);
+    }
+    if (m_height % 2 == 0) {
+        candidates.append(center + 1);
+    }
+
+    // Only the distances from the start to the neighbors of the center are
+    // read; the center itself is still walled in
+    QVector<int> centerTiles = candidates;
+    centerTiles.append(center);
+    QVector<int> targets;
+    for (int tile : centerTiles) {
+        for (int direction = 0; direction < 4; direction += 1) {
+            if (isValidExploredTile(tile, direction)) {
+                targets.append(getNeighbor(tile, direction));
+            }
+        }
+    }
+    updateDistances(0, targets.data(), targets.size(), false);
+
+    int greatestGradient = 0;
+    int tileOfGreatest = center;
+    for (int tile : candidates) {
+        int current = getDistance(tile);
+        for (int direction = 0; direction < 4; direction += 1) {
+            if (!isValidExploredTile(tile, direction)) {
+                continue;
+            }
+            int gradient = std::abs(getDistance(getNeighbor(tile, direction)) - current);
+            if (greatestGradient < gradient) {
+                greatestGradient = gradient;
+                tileOfGreatest = tile;
+            }
+        }
+    }
+    breakGradientWall(tileOfGreatest);
+}
+
+bool TomaszMazeGenerator::breakGradientWall(int tile) {
+    int current = getDistance(tile);
+    int biggestDifference = 0;
+    int wallToBreak = -1;
+    for (int direction = 0; direction < 4; direction += 1) {
+        if (!isValidExploredTile(tile, direction)) {
+            continue;
+        }
+        int difference = std::abs(getDistance(getNeighbor(tile, direction)) - current);
+        if (biggestDifference < difference) {
+            biggestDifference = difference;
+            wallToBreak = direction;
+        }
+    }
+    if (biggestDifference <= DEAD_END_BREAK_THRESHOLD) {
+        return false;
+    }
+    setWall(tile, wallToBreak, false);
+    return true;
+}
+
+int TomaszMazeGenerator::getDirectionToMove(float moveConst, const bool* choices, int possible) {
+
+    // Maybe keep going straight; otherwise, pick any other open direction
+    int direction = 0;
+    if (m_direction != -1 && choices[m_direction] && possible != 1) {
+        if (m_interface->getRandomFloat() <= moveConst) {
+            return m_direction;
+        }
+        do {
+            direction = getRandomIndex();
+        } while (!choices[direction] || direction == m_direction);
+        return direction;
+    }
+    do {
+        direction = getRandomIndex();
+    } while (!choices[direction]);
+    return direction;
+}
+
+void TomaszMazeGenerator::updateDistances(int tile, bool neighborsOnly) {
+
+    // The neighbors whose distances breakGradientWall() reads
+    int targets[4];
+    int remaining = 0;
+    if (neighborsOnly) {
+        for (int direction = 0; direction < 4; direction += 1) {
+            if (isValidExploredTile(tile, direction)) {
+                targets[remaining] = getNeighbor(tile, direction);
+                remaining += 1;
+            }
+        }
+    }
+    updateDistances(tile, neighborsOnly ? targets : nullptr, remaining, neighborsOnly);
+}
+
+void TomaszMazeGenerator::updateDistances(
+        int tile,
+        int* targets,
+        int remaining,
+        bool neighborsOnly) {
+
+    // Copied, so that the writes below can't be taken to change them
+    m_mark += 1;
+    int mark = m_mark;
+    const int offsets[4] = {m_offsets[0], m_offsets[1], m_offsets[2], m_offsets[3]};
+    const quint8* walls = m_walls.constData();
+    int* distances = m_distances.data();
+    int* marks = m_marks.data();
+    int* queue = m_queue.data();
+
+    // The outer walls are never broken, so an open wall always leads to a
+    // tile within the maze
+    int head = 0;
+    int tail = 0;
+    queue[tail++] = tile;
+    distances[tile] = 0;
+    marks[tile] = mark;
+    if (targets != nullptr && remaining == 0) {
+        return;
+    }
+    int level = 0;
+    while (head < tail) {
+        int current = queue[head++];
+        int distance = distances[current] + 1;
+
+        // At the first tile of each distance, every closer tile has been
+        // reached, and no further one; if a single neighbor is left, it's
+        // further than the others, which is all that breakGradientWall()
+        // compares, once that's past the threshold
+        if (distance > level) {
+            level = distance;
+            if (neighborsOnly && remaining == 1 && level > DEAD_END_BREAK_THRESHOLD) {
+                distances[targets[0]] = level;
+                marks[targets[0]] = mark;
+                return;
+            }
+        }
+        int openings = ~walls[current] & 15;
+        for (int direction = 0; openings != 0; direction += 1, openings >>= 1) {
+            int next = current + offsets[direction];
+            if (!(openings & 1) || marks[next] == mark) {
+                continue;
+            }
+            distances[next] = distance;
+            marks[next] = mark;
+            queue[tail++] = next;
+            if (targets == nullptr) {
+                continue;
+            }
+            for (int i = 0; i < remaining; i += 1) {
+                if (targets[i] == next) {
+                    targets[i] = targets[remaining - 1];
+                    remaining -= 1;
+                    break;
+                }
+            }
+            if (remaining == 0) {
+                return;
+            }
+        }
+    }
+}
+
+void TomaszMazeGenerator::updateDeadEndDistances(int tile) {
+
+    // The tile's explored neighbors are all on the stack, so the path to
+    // each of them through the tree is just the difference of their depths.
+    // A shorter one would have to leave the tree below the neighbor, through
+    // a shortcut from the finished branches of a tile between them to above
+    // that tile, which only the search can rule out; that only matters if
+    // one of the paths is long enough for a wall to be broken.
+    int depth = m_stack.size();
+    int highest = depth;
+    m_mark += 1;
+    m_distances[tile] = 0;
+    m_marks[tile] = m_mark;
+    for (int direction = 0; direction < 4; direction += 1) {
+        if (isValidExploredTile(tile, direction)) {
+            int neighbor = tile + m_offsets[direction];
+            m_distances[neighbor] = depth - m_depths.at(neighbor);
+            m_marks[neighbor] = m_mark;
+            highest = std::min(highest, m_depths.at(neighbor));
+        }
+    }
+    if (depth - highest > DEAD_END_BREAK_THRESHOLD &&
+            !m_escapes.isEmpty() && highest < m_escapes.last()) {
+        updateDistances(tile, true);
+    }
+}
+
+int TomaszMazeGenerator::getDistance(int tile) const {
+    return m_marks.at(tile) == m_mark ? m_distances.at(tile) : -1;
+}
+
+void TomaszMazeGenerator::computePairDistances() {
+
+    // The passages carved by the search form a tree, in which any two
+    // neighbors are an ancestor and a descendant (a depth-first search
+    // always finishes a tile's unexplored neighbors before the tile itself),
+    // so the path between them through the tree is just the difference of
+    // their depths. Any shorter path goes through one of the walls that the
+    // search broke, each of which closed a loop.
+    m_pairs.clear();
+    m_pairIndices.fill(-1, 2 * m_walls.size());
+    const quint8* walls = m_walls.constData();
+    const quint8* edges = m_edges.constData();
+    const int* depths = m_depths.constData();
+    for (int tile = 0; tile < m_walls.size(); tile += 1) {
+        for (int direction = 0; direction < 2; direction += 1) {
+            int neighbor = tile + m_offsets[direction];
+            if ((edges[tile] & (1 << direction)) || !isPairNeeded(tile, neighbor)) {
+                continue;
+            }
+            TilePair pair = {tile, neighbor, 1};
+            if (walls[tile] & (1 << direction)) {
+                pair.distance = std::abs(depths[tile] - depths[neighbor]);
+            }
+            m_pairIndices[2 * tile + direction] = m_pairs.size();
+            m_pairs.append(pair);
+        }
+    }
+    if (m_shortcuts.isEmpty()) {
+        return;
+    }
+
+    // Tiles that hang from the same place on the loops are only connected
+    // through the tree; otherwise, the path climbs to the loops from both
+    // tiles, and either stays within a corridor or goes from one of the
+    // corridor's junctions to one of the other's. There are far fewer
+    // junctions than tiles, so each pair is found from the junctions at the
+    // ends of its first tile's corridor, with a search over the corridors.
+    computeCorridors();
+    const int* anchors = m_anchors.constData();
+    const int* heights = m_heights.constData();
+    const int* corridors = m_corridorIndices.constData();
+    const int* positions = m_corridorPositions.constData();
+    const int* ends = m_ends.constData();
+    const int* endDistances = m_endDistances.constData();
+    int junctionCount = m_junctions.size();
+    QVector<int> starts(junctionCount + 1, 0);
+    QVector<int> pairJunctions(2 * m_pairs.size(), -1);
+    for (int i = 0; i < m_pairs.size(); i += 1) {
+        TilePair& pair = m_pairs[i];
+        int first = anchors[pair.first];
+        int second = anchors[pair.second];
+        if (pair.distance == 1 || first == second) {
+            continue;
+        }
+        if (corridors[first] != -1 && corridors[first] == corridors[second]) {
+            int distance =
+                heights[pair.first] + heights[pair.second] +
+                std::abs(positions[first] - positions[second]);
+            pair.distance = std::min(pair.distance, distance);
+        }
+        pairJunctions[2 * i] = ends[2 * first];
+        starts[ends[2 * first] + 1] += 1;
+        if (ends[2 * first + 1] != ends[2 * first]) {
+            pairJunctions[2 * i + 1] = ends[2 * first + 1];
+            starts[ends[2 * first + 1] + 1] += 1;
+        }
+    }
+    for (int junction = 0; junction < junctionCount; junction += 1) {
+        starts[junction + 1] += starts.at(junction);
+    }
+    QVector<int> entries(starts.last(), 0);
+    QVector<int> cursors = starts;
+    for (int i = 0; i < pairJunctions.size(); i += 1) {
+        int junction = pairJunctions.at(i);
+        if (junction != -1) {
+            entries[cursors[junction]] = i / 2;
+            cursors[junction] += 1;
+        }
+    }
+
+    // Each search only goes as far as the junctions that its pairs need
+    const int unreached = std::numeric_limits<int>::max();
+    const int* distances = m_junctionDistances.constData();
+    int* targets = m_junctionTargets.data();
+    for (int source = 0; source < junctionCount; source += 1) {
+        if (starts.at(source) == starts.at(source + 1)) {
+            continue;
+        }
+        int targetCount = 0;
+        for (int i = starts.at(source); i < starts.at(source + 1); i += 1) {
+            int second = anchors[m_pairs.at(entries.at(i)).second];
+            for (int end = 0; end < 2; end += 1) {
+                if (targets[ends[2 * second + end]] != source) {
+                    targets[ends[2 * second + end]] = source;
+                    targetCount += 1;
+                }
+            }
+        }
+        computeJunctionDistances(source, targetCount);
+        for (int i = starts.at(source); i < starts.at(source + 1); i += 1) {
+            TilePair& pair = m_pairs[entries.at(i)];
+            int first = anchors[pair.first];
+            int second = anchors[pair.second];
+            int fromFirst = std::min(
+                ends[2 * first] == source ? endDistances[2 * first] : unreached,
+                ends[2 * first + 1] == source ? endDistances[2 * first + 1] : unreached);
+            int toSecond = std::min(
+                distances[ends[2 * second]] + endDistances[2 * second],
+                distances[ends[2 * second + 1]] + endDistances[2 * second + 1]);
+            int distance = heights[pair.first] + heights[pair.second] + fromFirst + toSecond;
+            pair.distance = std::min(pair.distance, distance);
+        }
+    }
+}
+
+void TomaszMazeGenerator::relaxPairDistances(int tile) {
+    updateDistances(tile, false);
+    const int* distances = m_distances.constData();
+    const int* marks = m_marks.constData();
+    for (TilePair& pair : m_pairs) {
+        if (marks[pair.first] != m_mark || marks[pair.second] != m_mark) {
+            continue;
+        }
+        int distance = distances[pair.first] + distances[pair.second];
+        if (pair.distance == -1 || distance < pair.distance) {
+            pair.distance = distance;
+        }
+    }
+}
+
+void TomaszMazeGenerator::updatePairNeighborDistances(int tile) {
+
+    // Only when there are no pairs at all is the start the tile, and the
+    // start isn't in any pair
+    if (tile == 0) {
+        updateDistances(tile, true);
+        return;
+    }
+    m_mark += 1;
+    m_distances[tile] = 0;
+    m_marks[tile] = m_mark;
+    for (int direction = 0; direction < 4; direction += 1) {
+        if (!isValidExploredTile(tile, direction)) {
+            continue;
+        }
+        int neighbor = tile + m_offsets[direction];
+        int index = direction < 2 ?
+            m_pairIndices.at(2 * tile + direction) :
+            m_pairIndices.at(2 * neighbor + direction - 2);
+        m_distances[neighbor] = m_pairs.at(index).distance;
+        m_marks[neighbor] = m_mark;
+    }
+}
+
+bool TomaszMazeGenerator::isPairNeeded(int tile, int neighbor) const {
+    // Unexplored tiles are walled in, so their pairs are -1 either way
+    return (
+        tile != 0 && neighbor != 0 &&
+        m_isExplored.at(tile) && m_isExplored.at(neighbor) &&
+        !m_isCenter.at(tile) && !m_isCenter.at(neighbor)
+    );
+}
+
+void TomaszMazeGenerator::computeCorridors() {
+
+    int size = m_walls.size();
+    const int offsets[4] = {m_offsets[0], m_offsets[1], m_offsets[2], m_offsets[3]};
+    const quint8* walls = m_walls.constData();
+    const bool* isExplored = m_isExplored.constData();
+    int* queue = m_queue.data();
+
+    // Cut off the branches that lead nowhere, from their dead ends inwards;
+    // what's left is the loops and the corridors between them, and each
+    // tile's count is of its open neighbors among them (or -1 if it's cut)
+    QVector<int> countStore(size, 0);
+    int* counts = countStore.data();
+    int tail = 0;
+    for (int tile = 0; tile < size; tile += 1) {
+        if (!isExplored[tile]) {
+            continue;
+        }
+        int openings = ~walls[tile] & 15;
+        counts[tile] = (openings & 1) + (openings >> 1 & 1) + (openings >> 2 & 1) + (openings >> 3);
+        if (counts[tile] <= 1) {
+            queue[tail++] = tile;
+        }
+    }
+    for (int head = 0; head < tail; head += 1) {
+        int tile = queue[head];
+        counts[tile] = -1;
+        for (int direction = 0; direction < 4; direction += 1) {
+            int neighbor = tile + offsets[direction];
+            if ((walls[tile] & (1 << direction)) || counts[neighbor] < 0) {
+                continue;
+            }
+            counts[neighbor] -= 1;
+            if (counts[neighbor] == 1) {
+                queue[tail++] = neighbor;
+            }
+        }
+    }
+
+    // Hang the branches back on, from the loops outwards
+    m_heights.fill(0, size);
+    m_anchors.fill(-1, size);
+    int* heights = m_heights.data();
+    int* anchors = m_anchors.data();
+    tail = 0;
+    for (int tile = 0; tile < size; tile += 1) {
+        if (counts[tile] > 0) {
+            anchors[tile] = tile;
+            queue[tail++] = tile;
+        }
+    }
+    for (int head = 0; head < tail; head += 1) {
+        int tile = queue[head];
+        for (int direction = 0; direction < 4; direction += 1) {
+            int neighbor = tile + offsets[direction];
+            if ((walls[tile] & (1 << direction)) || anchors[neighbor] != -1) {
+                continue;
+            }
+            heights[neighbor] = heights[tile] + 1;
+            anchors[neighbor] = anchors[tile];
+            queue[tail++] = neighbor;
+        }
+    }
+
+    // Junctions are where corridors meet; a lone loop needs one to start at
+    m_junctions.clear();
+    m_junctionIndices.fill(-1, size);
+    int* junctionIndices = m_junctionIndices.data();
+    for (int tile = 0; tile < size; tile += 1) {
+        if (counts[tile] > 2) {
+            junctionIndices[tile] = m_junctions.size();
+            m_junctions.append(tile);
+        }
+    }
+    for (int tile = 0; tile < size && m_junctions.isEmpty(); tile += 1) {
+        if (counts[tile] > 0) {
+            junctionIndices[tile] = 0;
+            m_junctions.append(tile);
+        }
+    }
+
+    // Follow each corridor from the first of its junctions to be reached
+    m_corridors.clear();
+    m_longestCorridor = 0;
+    m_corridorIndices.fill(-1, size);
+    m_corridorPositions.fill(0, size);
+    int* corridorIndices = m_corridorIndices.data();
+    int* positions = m_corridorPositions.data();
+    for (int junction = 0; junction < m_junctions.size(); junction += 1) {
+        int start = m_junctions.at(junction);
+        for (int direction = 0; direction < 4; direction += 1) {
+            int next = start + offsets[direction];
+            if ((walls[start] & (1 << direction)) ||
+                    counts[next] < 0 ||
+                    corridorIndices[next] != -1 ||
+                    (junctionIndices[next] != -1 && next < start)) {
+                continue;
+            }
+            int previous = start;
+            int current = next;
+            int length = 1;
+            while (junctionIndices[current] == -1) {
+                corridorIndices[current] = m_corridors.size();
+                positions[current] = length;
+                for (int turn = 0; turn < 4; turn += 1) {
+                    int neighbor = current + offsets[turn];
+                    if (!(walls[current] & (1 << turn)) &&
+                            counts[neighbor] >= 0 &&
+                            neighbor != previous) {
+                        previous = current;
+                        current = neighbor;
+                        break;
+                    }
+                }
+                length += 1;
+            }
+            Corridor corridor = {junction, junctionIndices[current], length};
+            m_corridors.append(corridor);
+            m_longestCorridor = std::max(m_longestCorridor, length);
+        }
+    }
+
+    // The ends of each tile's corridor, or the junction itself at both ends
+    m_ends.fill(-1, 2 * size);
+    m_endDistances.fill(0, 2 * size);
+    int* ends = m_ends.data();
+    int* endDistances = m_endDistances.data();
+    const Corridor* corridors = m_corridors.constData();
+    for (int tile = 0; tile < size; tile += 1) {
+        if (junctionIndices[tile] != -1) {
+            ends[2 * tile] = junctionIndices[tile];
+            ends[2 * tile + 1] = junctionIndices[tile];
+        }
+        else if (corridorIndices[tile] != -1) {
+            const Corridor& corridor = corridors[corridorIndices[tile]];
+            ends[2 * tile] = corridor.first;
+            ends[2 * tile + 1] = corridor.second;
+            endDistances[2 * tile] = positions[tile];
+            endDistances[2 * tile + 1] = corridor.length - positions[tile];
+        }
+    }
+
+    // Each junction's corridors to other junctions, contiguously
+    m_linkStarts.fill(0, m_junctions.size() + 1);
+    for (const Corridor& corridor : m_corridors) {
+        if (corridor.first != corridor.second) {
+            m_linkStarts[corridor.first + 1] += 1;
+            m_linkStarts[corridor.second + 1] += 1;
+        }
+    }
+    for (int junction = 0; junction < m_junctions.size(); junction += 1) {
+        m_linkStarts[junction + 1] += m_linkStarts.at(junction);
+    }
+    m_links.resize(m_linkStarts.last());
+    QVector<int> cursors = m_linkStarts;
+    for (const Corridor& corridor : m_corridors) {
+        if (corridor.first != corridor.second) {
+            Link first = {corridor.second, corridor.length};
+            Link second = {corridor.first, corridor.length};
+            m_links[cursors[corridor.first]++] = first;
+            m_links[cursors[corridor.second]++] = second;
+        }
+    }
+
+    // Every junction is queued at most once per link to it, plus the source
+    m_junctionDistances.fill(std::numeric_limits<int>::max(), m_junctions.size());
+    m_junctionTargets.fill(-1, m_junctions.size());
+    m_ringHeads.fill(-1, m_longestCorridor + 1);
+    m_ringEntries.fill(0, m_links.size() + 1);
+    m_ringNexts.fill(0, m_links.size() + 1);
+    m_ringCount = 0;
+}
+
+void TomaszMazeGenerator::computeJunctionDistances(int junction, int targetCount) {
+
+    // Dijkstra's algorithm, with the corridors' lengths as weights. Nothing
+    // in the queue is further than the longest corridor past the junction
+    // being settled, so it's a ring of buckets by distance, with each bucket
+    // a list threaded through the entries. The entries are also every
+    // junction that the previous search reached, so only those are reset.
+    const int* linkStarts = m_linkStarts.constData();
+    const Link* links = m_links.constData();
+    const int* targets = m_junctionTargets.constData();
+    int* distances = m_junctionDistances.data();
+    int* heads = m_ringHeads.data();
+    int* entries = m_ringEntries.data();
+    int* nexts = m_ringNexts.data();
+    int ringSize = m_ringHeads.size();
+    for (int i = 0; i < m_ringCount; i += 1) {
+        distances[entries[i]] = std::numeric_limits<int>::max();
+    }
+    std::fill(heads, heads + ringSize, -1);
+    distances[junction] = 0;
+    heads[0] = 0;
+    entries[0] = junction;
+    nexts[0] = -1;
+    int count = 1;
+    int bucket = 0;
+    for (int distance = 0; targetCount > 0; distance += 1) {
+        while (targetCount > 0 && heads[bucket] != -1) {
+            int entry = heads[bucket];
+            int current = entries[entry];
+            heads[bucket] = nexts[entry];
+            if (distances[current] < distance) {
+                continue;
+            }
+            if (targets[current] == junction) {
+                targetCount -= 1;
+            }
+            for (int i = linkStarts[current]; i < linkStarts[current + 1]; i += 1) {
+                int next = links[i].junction;
+                int nextDistance = distance + links[i].length;
+                if (nextDistance < distances[next]) {
+                    distances[next] = nextDistance;
+                    int nextBucket = bucket + links[i].length;
+                    if (nextBucket >= ringSize) {
+                        nextBucket -= ringSize;
+                    }
+                    entries[count] = next;
+                    nexts[count] = heads[nextBucket];
+                    heads[nextBucket] = count;
+                    count += 1;
+                }
+            }
+        }
+        bucket = bucket + 1 < ringSize ? bucket + 1 : 0;
+    }
+    m_ringCount = count;
+}
+
+int TomaszMazeGenerator::getNeighbor(int tile, int direction) const {
+    return m_edges.at(tile) & (1 << direction) ? -1 : tile + m_offsets[direction];
+}
+
+void TomaszMazeGenerator::setWall(int tile, int direction, bool wallExists) {
+    int neighbor = getNeighbor(tile, direction);
+    int opposite = (direction + 2) % 4;
+    if (wallExists) {
+        m_walls[tile] |= 1 << direction;
+        if (neighbor != -1) {
+            m_walls[neighbor] |= 1 << opposite;
+        }
+    }
+    else {
+        m_walls[tile] &= ~(1 << direction);
+        if (neighbor != -1) {
+            m_walls[neighbor] &= ~(1 << opposite);
+        }
+    }
+}
+
+bool TomaszMazeGenerator::isValidExploredTile(int tile, int direction) const {
+    int neighbor = getNeighbor(tile, direction);
+    return (
+        neighbor > 0 &&
+        m_isExplored.at(neighbor) &&
+        !m_isCenter.at(neighbor)
+    );
+}
+
+int TomaszMazeGenerator::getRandomIndex() {
+    return static_cast<int>(std::floor(m_interface->getRandomFloat() * 4));
+}
+
+} // namespace mms
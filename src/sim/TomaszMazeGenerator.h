@@ -0,0 +1,189 @@
+#pragma once
+
+#include <QVector>
+
+#include "MazeGenerator.h"
+
+namespace mms {
+
+// The maze generator of maze/algos/tomasz, rewritten to run in-process: it
+// draws the same random floats in the same order, and so generates exactly
+// the same maze, but keeps everything in flat per-tile arrays, and searches
+// no further than the distances it needs. It's a randomized depth-first
+// search that prefers to go straight near the edges, breaks walls at some
+// dead ends and across the largest gradients of distance, and finally opens
+// the center from the side that's furthest from the start. Every instance is
+// independent, so any number can run at once.
+class TomaszMazeGenerator {
+
+public:
+
+    static void generate(MazeGeneratorInterface* interface);
+
+private:
+
+    // How likely the search is to keep going straight, at the edges of the
+    // maze (it's proportional to the distance from the center)
+    static const double STRAIGHT_FACTOR;
+
+    // How likely a dead end is to be broken through
+    static const double DEAD_END_BREAK_CHANCE;
+
+    // Walls are only broken between tiles that are more than this far apart
+    static const int DEAD_END_BREAK_THRESHOLD = 8;
+
+    // How many walls are broken across the largest gradients at the end
+    static const int GRADIENT_WALL_BREAKS = 3;
+
+    TomaszMazeGenerator(MazeGeneratorInterface* interface);
+
+    // Tiles are indexed by x * height + y, and directions by their index in
+    // DIRECTIONS(), so that bit d of a tile's walls is its wall in direction d
+    // (the layout of a .MAZ byte)
+    MazeGeneratorInterface* m_interface;
+    int m_width;
+    int m_height;
+    int m_offsets[4];
+    QVector<quint8> m_walls;
+
+    // Bit d is set if the tile is at the edge of the maze in direction d
+    QVector<quint8> m_edges;
+    QVector<bool> m_isExplored;
+    QVector<bool> m_isCenter;
+
+    // How likely the search is to keep going straight from each tile
+    QVector<float> m_moveConsts;
+
+    // The search's stack of tiles, and its last move (or -1)
+    QVector<int> m_stack;
+    int m_direction;
+
+    // Each tile's depth in the tree of the search, and the tiles at which
+    // the search broke a wall (which are the only ways out of the tree)
+    QVector<int> m_depths;
+    QVector<int> m_shortcuts;
+
+    // For each depth of the stack, the shallowest depth that a shortcut from
+    // the finished branches of the tile there leads to, and the depths at
+    // which that's above the tile, from the shallowest to the deepest
+    QVector<int> m_lows;
+    QVector<int> m_escapes;
+
+    // The distances from the most recent updateDistances() source; a tile's
+    // distance is only valid if its mark is the current one, and is -1
+    // (unreachable) otherwise, so nothing needs to be cleared between runs
+    QVector<int> m_distances;
+    QVector<int> m_marks;
+    int m_mark;
+    QVector<int> m_queue;
+
+    // The pairs of neighbors that breakGradientWalls() reads, in the order
+    // that it reads them, and the distance between each; the pair of a tile
+    // and its northern or eastern neighbor is at m_pairIndices[2 * tile] or
+    // m_pairIndices[2 * tile + 1], if it's needed
+    struct TilePair {
+        int first;
+        int second;
+        int distance;
+    };
+    QVector<TilePair> m_pairs;
+    QVector<int> m_pairIndices;
+
+    // The passages without their branches that lead nowhere, which are where
+    // every path between two different branches runs: each tile's distance
+    // to them and the tile of them that it hangs from (itself, if it's on
+    // them), and, for the tiles on them, the junction that they are, or the
+    // corridor between two junctions that they're on and how far along it
+    struct Corridor {
+        int first;
+        int second;
+        int length;
+    };
+    QVector<int> m_heights;
+    QVector<int> m_anchors;
+    QVector<int> m_junctionIndices;
+    QVector<int> m_corridorIndices;
+    QVector<int> m_corridorPositions;
+    QVector<int> m_junctions;
+    QVector<Corridor> m_corridors;
+    int m_longestCorridor;
+
+    // For each tile on the loops, the junctions at the ends of its corridor
+    // (its own index, twice, for a junction), at 2 * tile and 2 * tile + 1,
+    // and its distances to them along the corridor
+    QVector<int> m_ends;
+    QVector<int> m_endDistances;
+
+    // The corridors between different junctions, listed for each junction
+    // from m_links[m_linkStarts[junction]] up to the next junction's start
+    struct Link {
+        int junction;
+        int length;
+    };
+    QVector<int> m_linkStarts;
+    QVector<Link> m_links;
+
+    // The distances from the most recent computeJunctionDistances() source,
+    // the source that each junction is a target of, and the search's queue
+    QVector<int> m_junctionDistances;
+    QVector<int> m_junctionTargets;
+    QVector<int> m_ringHeads;
+    QVector<int> m_ringEntries;
+    QVector<int> m_ringNexts;
+    int m_ringCount;
+
+    void generateMaze();
+    void makeCenter();
+    void breakGradientWalls();
+    void pathIntoCenter();
+
+    // Breaks the wall between the tile and the explored neighbor whose
+    // distance differs from it the most, if that's above the threshold, and
+    // returns whether it did. The distances must be from updateDistances() or
+    // updatePairNeighborDistances() on the same tile, except at the very end,
+    // when they're from the start.
+    bool breakGradientWall(int tile);
+
+    // Direction choice during the depth-first search
+    int getDirectionToMove(float moveConst, const bool* choices, int possible);
+
+    // Sets the distances from a new dead end to its explored neighbors, from
+    // the depths when nothing can shorten them, and with a search otherwise
+    void updateDeadEndDistances(int tile);
+
+    // A breadth-first search from the tile. If neighborsOnly is set, it
+    // stops as soon as every valid explored neighbor of the tile has a
+    // distance, which is all that breakGradientWall() reads. Given targets,
+    // it stops once they all have one (the array is reordered as they do).
+    void updateDistances(int tile, bool neighborsOnly);
+    void updateDistances(int tile, int* targets, int remaining, bool neighborsOnly);
+    int getDistance(int tile) const;
+
+    // Fills in m_pairs from scratch, or after a wall at the tile has been
+    // broken (every path that got shorter goes through it)
+    void computePairDistances();
+    void relaxPairDistances(int tile);
+    bool isPairNeeded(int tile, int neighbor) const;
+
+    // Sets the distances from the tile to its valid explored neighbors from
+    // their pairs, for breakGradientWall(), instead of searching for them
+    void updatePairNeighborDistances(int tile);
+
+    // Finds the junctions and corridors above, and the distances between
+    // the junctions, which are all that a path between branches depends on
+    void computeCorridors();
+
+    // Dijkstra's algorithm over the corridors, from the junction until the
+    // given number of its targets (in m_junctionTargets) have distances
+    void computeJunctionDistances(int junction, int targetCount);
+
+    // The neighbor in the direction, or -1 if it's outside of the maze
+    int getNeighbor(int tile, int direction) const;
+    void setWall(int tile, int direction, bool wallExists);
+
+    bool isValidExploredTile(int tile, int direction) const;
+
+    int getRandomIndex();
+};
+
+} // namespace mms
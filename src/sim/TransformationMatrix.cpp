@@ -4,6 +4,7 @@
 #include <QtMath>
 
 #include <algorithm>
+#include <limits>
 
 #include "Assert.h"
 
@@ -229,6 +230,69 @@ QVector<float> TransformationMatrix::getZoomedMapTransformationMatrix(
     return zoomedMapCameraMatrix;
 }
 
+QVector<float> TransformationMatrix::getMouseTransformationMatrix(
+        const Coordinate& currentMouseTranslation,
+        const Angle& currentMouseRotation) {
+
+    // Rotate about the origin (counter-clockwise, like
+    // GeometryUtilities::rotateVertexAroundPoint) and then translate
+    double theta = currentMouseRotation.getRadiansZeroTo2pi();
+    float x = static_cast<float>(currentMouseTranslation.getX().getMeters());
+    float y = static_cast<float>(currentMouseTranslation.getY().getMeters());
+    return {
+        static_cast<float>(std::cos(theta)), static_cast<float>(-std::sin(theta)), 0.0,   x,
+        static_cast<float>(std::sin(theta)),  static_cast<float>(std::cos(theta)), 0.0,   y,
+                                        0.0,                                  0.0, 1.0, 0.0,
+                                        0.0,                                  0.0, 0.0, 1.0,
+    };
+}
+
+QPair<QPair<double, double>, QPair<double, double>> TransformationMatrix::getVisiblePhysicalRegion(
+        const QVector<float>& transformationMatrix,
+        QPair<int, int> mapPosition,
+        QPair<int, int> mapSize,
+        QPair<int, int> windowSize) {
+
+    ASSERT_EQ(transformationMatrix.size(), 16);
+
+    // The map matrices only ever scale, rotate, and translate in the xy
+    // plane, so we only need to invert the 2D affine part of the matrix
+    double a = transformationMatrix.at(0);
+    double b = transformationMatrix.at(1);
+    double c = transformationMatrix.at(4);
+    double d = transformationMatrix.at(5);
+    double tx = transformationMatrix.at(3);
+    double ty = transformationMatrix.at(7);
+    double determinant = a * d - b * c;
+    ASSERT_NE(determinant, 0.0);
+
+    // Map each corner of the map back to physical coordinates (the map may
+    // be rotated, hence all four corners) and take the bounding box
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = std::numeric_limits<double>::lowest();
+    for (int i = 0; i < 4; i += 1) {
+        QPair<double, double> corner = mapPixelCoordinateToOpenGlCoordinate(
+            {
+                mapPosition.first + (i % 2) * mapSize.first,
+                mapPosition.second + (i / 2) * mapSize.second
+            },
+            windowSize
+        );
+        double gx = corner.first - tx;
+        double gy = corner.second - ty;
+        double x = ( d * gx - b * gy) / determinant;
+        double y = (-c * gx + a * gy) / determinant;
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    }
+
+    return {{minX, minY}, {maxX, maxY}};
+}
+
 QPair<double, double> TransformationMatrix::mapPixelCoordinateToOpenGlCoordinate(
         QPair<double, double> coordinate,
         QPair<int, int> windowSize) {
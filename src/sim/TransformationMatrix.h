@@ -35,12 +35,20 @@ public:
         const Coordinate& currentMouseTranslation,
         const Angle& currentMouseRotation);
 
-private:
+    // Retrieve the 4x4 matrix that poses geometry given in the mouse's local
+    // frame (centered at the origin, facing east) at the given translation
+    // and rotation, in physical coordinates
+    static QVector<float> getMouseTransformationMatrix(
+        const Coordinate& currentMouseTranslation,
+        const Angle& currentMouseRotation);
 
-    // Maps a pixel coordinate ((0,0) in the bottom left, (width, height) in the upper right)
-    // to the OpenGL coordinate system ((-1,-1) in the bottom left, (1,1) in the upper right)
-    static QPair<double, double> mapPixelCoordinateToOpenGlCoordinate(
-        QPair<double, double> coordinate,
+    // Retrieve the lower-left and upper-right physical coordinates (in meters)
+    // of the smallest axis-aligned rectangle that contains everything that's
+    // visible through the map, given the map's transformation matrix
+    static QPair<QPair<double, double>, QPair<double, double>> getVisiblePhysicalRegion(
+        const QVector<float>& transformationMatrix,
+        QPair<int, int> mapPosition,
+        QPair<int, int> mapSize,
         QPair<int, int> windowSize);
 
     // Multiplies two 4x4 matrices together
@@ -48,6 +56,14 @@ private:
         QVector<float> left,
         QVector<float> right);
 
+private:
+
+    // Maps a pixel coordinate ((0,0) in the bottom left, (width, height) in the upper right)
+    // to the OpenGL coordinate system ((-1,-1) in the bottom left, (1,1) in the upper right)
+    static QPair<double, double> mapPixelCoordinateToOpenGlCoordinate(
+        QPair<double, double> coordinate,
+        QPair<int, int> windowSize);
+
 };
 
 } // namespace mms
@@ -1,23 +1,30 @@
 #include "Window.h"
 
 #include <QAction>
+#include <QActionGroup>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
 #include <QFileDialog>
 #include <QFrame>
 #include <QGroupBox>
 #include <QHBoxLayout>
-#include <QLinkedList>
 #include <QMenu>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QScopedPointer>
 #include <QSplitter>
 #include <QTabWidget>
+#include <QTextStream>
 #include <QTimer>
 #include <QVBoxLayout>
 
 #include "ColorManager.h"
 #include "ConfigDialog.h"
+#include "MazeChecker.h"
 #include "MazeFilesTab.h"
 #include "Model.h"
+#include "OptimalTimeOracle.h"
 #include "Param.h"
 #include "ProcessUtilities.h"
 #include "Resources.h"
@@ -44,12 +51,26 @@ Window::Window(QWidget *parent) :
         m_fogCheckbox(new QCheckBox("Fog")),
         m_textCheckbox(new QCheckBox("Text")),
         m_followCheckbox(new QCheckBox("Follow")),
+        m_trailCheckbox(new QCheckBox("Trail")),
+        m_heatmapCheckbox(new QCheckBox("Heatmap")),
+        m_hudCheckbox(new QCheckBox("Stats")),
+        m_editCheckbox(new QCheckBox("Edit")),
+        m_mazeCache(
+            [=](const Maze* maze){ return makeTruth(maze); },
+            qint64(P()->mazeCacheMegabytes()) * 1024 * 1024),
         m_maze(nullptr),
         m_truth(nullptr),
+        m_editor(nullptr),
+        m_mazeSymmetry(MAZE_SYMMETRIES().at(
+            (P()->mazeMirrored() ? 4 : 0) + P()->mazeRotations())),
         m_mouse(nullptr),
         m_mouseGraphic(nullptr),
         m_view(nullptr),
         m_mouseInterface(nullptr),
+        m_frameExporter(nullptr),
+        m_quitWhenMouseAlgoFinishes(false),
+        m_timelineCount(0),
+        m_sweepExitCode(0),
 
         // MouseAlgosTab
         m_mouseAlgoWidget(new QWidget()),
@@ -102,6 +123,8 @@ Window::Window(QWidget *parent) :
         mazeStatsLayout->addWidget(label);
         mazeStatsLayout->addWidget(pair.second);
     }
+    m_isValidLabel->installEventFilter(this);
+    m_isOfficialLabel->installEventFilter(this);
 
     // Add the map (and set some layout props)
     mapHolderLayout->addWidget(&m_map);
@@ -122,6 +145,10 @@ Window::Window(QWidget *parent) :
     mapOptionsLayout->addWidget(m_fogCheckbox);
     mapOptionsLayout->addWidget(m_textCheckbox);
     mapOptionsLayout->addWidget(m_followCheckbox);
+    mapOptionsLayout->addWidget(m_trailCheckbox);
+    mapOptionsLayout->addWidget(m_heatmapCheckbox);
+    mapOptionsLayout->addWidget(m_hudCheckbox);
+    mapOptionsLayout->addWidget(m_editCheckbox);
 
     // Add functionality to those map buttons
     connect(m_viewButton, &QRadioButton::toggled, this, [=](bool checked){
@@ -133,8 +160,13 @@ Window::Window(QWidget *parent) :
         m_textCheckbox->setEnabled(checked);
     });
     connect(m_distancesCheckbox, &QCheckBox::stateChanged, this, [=](int state){
-        if (m_truth != nullptr) {
-            m_truth->getMazeGraphic()->setTileTextVisible(state == Qt::Checked);
+        // Cached truths have to match, too, for when they're switched to
+        QVector<MazeView*> truths = m_mazeCache.getViews();
+        if (m_truth != nullptr && !truths.contains(m_truth)) {
+            truths.append(m_truth);
+        }
+        for (MazeView* truth : truths) {
+            truth->getMazeGraphic()->setTileTextVisible(state == Qt::Checked);
         }
     });
     connect(m_wallTruthCheckbox, &QCheckBox::stateChanged, this, [=](int state){
@@ -166,6 +198,25 @@ Window::Window(QWidget *parent) :
         }
     });
 
+    connect(m_trailCheckbox, &QCheckBox::stateChanged, this, [=](int state){
+        m_map.setTrailVisible(state == Qt::Checked);
+    });
+    connect(m_heatmapCheckbox, &QCheckBox::stateChanged, this, [=](int state){
+        m_map.setHeatmapVisible(state == Qt::Checked);
+    });
+    connect(m_hudCheckbox, &QCheckBox::stateChanged, this, [=](int state){
+        m_map.setHudVisible(state == Qt::Checked);
+    });
+    connect(&m_map, &Map::wallClicked, this, [=](int x, int y, Direction direction){
+        if (!m_editCheckbox->isChecked() || m_editor == nullptr || m_mouse != nullptr) {
+            return;
+        }
+        // An edited maze no longer matches its file
+        m_mazeCache.release(m_maze);
+        m_editor->toggleWall(x, y, direction);
+        updateMazeStats();
+    });
+
     // Set the default values for the map options
     m_truthButton->setChecked(true);
     m_distancesCheckbox->setChecked(true);
@@ -181,6 +232,14 @@ Window::Window(QWidget *parent) :
     m_textCheckbox->setEnabled(false);
     m_followCheckbox->setChecked(false);
     m_followCheckbox->setEnabled(false);
+    m_trailCheckbox->setChecked(true);
+    m_trailCheckbox->setEnabled(false);
+    m_heatmapCheckbox->setChecked(false);
+    m_heatmapCheckbox->setEnabled(false);
+    m_hudCheckbox->setChecked(false);
+    m_hudCheckbox->setEnabled(true);
+    m_editCheckbox->setChecked(false);
+    m_editCheckbox->setEnabled(true);
 
     // Add the tabs to the splitter
     QTabWidget* tabWidget = new QTabWidget();
@@ -190,12 +249,11 @@ Window::Window(QWidget *parent) :
     MazeFilesTab* mazeFilesTab = new MazeFilesTab(); 
     connect(
         mazeFilesTab, &MazeFilesTab::mazeFileChanged,
-        this, [=](const QString& path){
-            Maze* maze = Maze::fromFile(path);
-            if (maze != nullptr) {
-                setMaze(maze);
-            }
-        }
+        this, &Window::loadMazeFile
+    );
+    connect(
+        mazeFilesTab, &MazeFilesTab::mazeFileNeighborsChanged,
+        &m_mazeCache, &MazeCache::preload
     );
     tabWidget->addTab(mazeFilesTab, "Maze Files");
 
@@ -216,6 +274,23 @@ Window::Window(QWidget *parent) :
     connect(quitAction, &QAction::triggered, this, &Window::close);
     fileMenu->addAction(quitAction);
 
+    // Maze symmetry, for catching mouse algorithms that favor a direction
+    QMenu* mazeMenu = menuBar()->addMenu(tr("Ma&ze"));
+    QMenu* symmetryMenu = mazeMenu->addMenu(tr("&Symmetry"));
+    QActionGroup* symmetryGroup = new QActionGroup(this);
+    for (MazeSymmetry symmetry : MAZE_SYMMETRIES()) {
+        QAction* symmetryAction = new QAction(
+            MAZE_SYMMETRY_TO_STRING().value(symmetry),
+            symmetryGroup);
+        symmetryAction->setCheckable(true);
+        connect(symmetryAction, &QAction::triggered, this, [=](){
+            setMazeSymmetry(symmetry);
+        });
+        symmetryMenu->addAction(symmetryAction);
+        m_mazeSymmetryActions.insert(symmetry, symmetryAction);
+    }
+    m_mazeSymmetryActions.value(m_mazeSymmetry)->setChecked(true);
+
     // Save the maze
     // TODO: MACK - select the maze type here...
     /*
@@ -293,39 +368,23 @@ Window::Window(QWidget *parent) :
             if (now - then < secondsPerFrame) {
                 return;
             }
+            m_map.setHudCounters(
+                m_model.getStepCount(),
+                m_mouseInterface == nullptr
+                    ? 0
+                    : m_mouseInterface->getCommandCount());
             m_map.update();
             m_model.step();
+            if (m_frameExporter != nullptr) {
+                m_frameExporter->capture(
+                    m_maze,
+                    m_viewButton->isChecked() ? m_view : m_truth,
+                    m_mouseGraphic);
+            }
             then = now;
         }
     );
     mapTimer->start(secondsPerFrame * 1000);
-
-    // TODO: MACK - this is very expensive - fix it
-    /*
-    // Start the info loop
-    QTimer* otherTimer = new QTimer();
-    QLinkedList<double>* timestamps = new QLinkedList<double>();
-    int numFrames = 10;
-    connect(otherTimer, &QTimer::timeout, this, [=](){
-        double now = SimUtilities::getHighResTimestamp();
-        timestamps->append(now);
-        if (timestamps->size() > numFrames) {
-            double then = timestamps->takeFirst();
-            double fps = numFrames / (now - then);
-        }
-        QPair<QStringList, QVector<QVariant>> runStats = getRunStats();
-        QStringList keys = runStats.first;
-        QVector<QVariant> values = runStats.second;
-        for (int i = 0; i < keys.size(); i += 1) {
-            QString text = values.at(i).toString();
-            if (values.at(i).type() == QVariant::Double) {
-                text = QString::number(values.at(i).toDouble(), 'f', 3);
-            }
-            m_runStats.value(keys.at(i))->setText(text);
-        }
-    });
-    //otherTimer->start(100); // 10 fps
-    */
 }
 
 void Window::resizeEvent(QResizeEvent* event) {
@@ -341,7 +400,131 @@ void Window::closeEvent(QCloseEvent *event) {
     QMainWindow::closeEvent(event);
 }
 
-void Window::setMaze(Maze* maze) {
+bool Window::loadMazeFile(const QString& path) {
+    QPair<Maze*, MazeView*> cached = m_mazeCache.get(path);
+    if (cached.first == nullptr) {
+        qWarning().noquote().nospace()
+            << "Could not load the maze file \"" << path << "\".";
+        return false;
+    }
+    // Only the maze is cached; a symmetric view, or one with another goal,
+    // needs its own truth
+    if (m_mazeGoal.isEmpty() && m_mazeSymmetry == MazeSymmetry::IDENTITY) {
+        setMaze(cached.first, cached.second);
+    }
+    else if (m_mazeGoal.isEmpty()) {
+        setMaze(cached.first->withSymmetry(m_mazeSymmetry));
+    }
+    else {
+        QScopedPointer<Maze> maze(cached.first->withGoal(m_mazeGoal));
+        setMaze(maze->withSymmetry(m_mazeSymmetry));
+    }
+    return true;
+}
+
+void Window::setMazeGoal(const QVector<QPair<int, int>>& goal) {
+    m_mazeGoal = goal;
+    if (m_maze != nullptr) {
+        setMaze(m_maze->withGoal(goal));
+    }
+}
+
+void Window::setMazeSymmetry(MazeSymmetry symmetry) {
+    m_mazeSymmetry = symmetry;
+    m_mazeSymmetryActions.value(symmetry)->setChecked(true);
+    if (m_maze != nullptr && m_maze->getSymmetry() != symmetry) {
+        setMaze(m_maze->withSymmetry(symmetry));
+    }
+}
+
+void Window::startMouseAlgo(const QString& name, bool quitWhenFinished) {
+    int index = m_mouseAlgoComboBox->findText(name);
+    if (index < 0) {
+        qWarning().noquote().nospace()
+            << "No mouse algorithm named \"" << name << "\".";
+        if (quitWhenFinished) {
+            QCoreApplication::exit(1);
+        }
+        return;
+    }
+    m_mouseAlgoComboBox->setCurrentIndex(index);
+    m_quitWhenMouseAlgoFinishes = quitWhenFinished;
+    mouseAlgoRunStart();
+    if (m_quitWhenMouseAlgoFinishes && m_mouseAlgoRunProcess == nullptr) {
+        QCoreApplication::exit(1);
+    }
+}
+
+void Window::sweepMouseAlgo(const QString& name) {
+    m_sweepMouseAlgo = name;
+    m_sweepSymmetries = MAZE_SYMMETRIES();
+    m_sweepExitCode = 0;
+    sweepNext();
+}
+
+void Window::sweepNext() {
+    setMazeSymmetry(m_sweepSymmetries.first());
+    startMouseAlgo(m_sweepMouseAlgo, true);
+}
+
+void Window::sweepFinished(int exitCode) {
+
+    // One line per symmetry, with the stats that say how well the run went
+    static const QStringList keys = {
+        "Tiles Traversed",
+        "Closest Distance to Center",
+        "Best Time to Center",
+        "Efficiency",
+        "Crashed",
+    };
+    QPair<QStringList, QVector<QVariant>> runStats = getRunStats();
+    QStringList fields = {
+        MAZE_SYMMETRY_TO_STRING().value(m_sweepSymmetries.takeFirst()),
+        QString("exit=%1").arg(exitCode),
+    };
+    for (const QString& key : keys) {
+        int index = runStats.first.indexOf(key);
+        fields.append(QString("%1=%2").arg(key, runStats.second.value(index).toString()));
+    }
+    QTextStream out(stdout);
+    out << fields.join("\t") << "\n";
+    out.flush();
+
+    m_sweepExitCode = qMax(m_sweepExitCode, exitCode);
+    if (m_sweepSymmetries.isEmpty()) {
+        QCoreApplication::exit(m_sweepExitCode);
+        return;
+    }
+
+    // The next run stops this one, which can't happen while its process is
+    // still signaling that it finished
+    QTimer::singleShot(0, this, &Window::sweepNext);
+}
+
+void Window::setFrameExporter(FrameExporter* frameExporter) {
+    m_frameExporter = frameExporter;
+}
+
+void Window::setTimelineDirectory(const QString& directory) {
+    if (!QDir().mkpath(directory)) {
+        qWarning().noquote().nospace()
+            << "Could not create the timeline directory \"" << directory
+            << "\"; timelines will not be saved.";
+        return;
+    }
+    m_timelineDirectory = directory;
+}
+
+void Window::writeMouseTimeline() {
+    m_timelineCount += 1;
+    QString path = QDir(m_timelineDirectory).filePath(
+        QString("%1-%2.csv")
+            .arg(m_timelineCount, 4, 10, QChar('0'))
+            .arg(MAZE_SYMMETRY_TO_STRING().value(m_maze->getSymmetry())));
+    m_model.writeMouseTimeline(path);
+}
+
+void Window::setMaze(Maze* maze, MazeView* truth) {
 
     // Stop running maze/mouse algos
     mouseAlgoRunStop();
@@ -349,22 +532,47 @@ void Window::setMaze(Maze* maze) {
     // Next, update the maze and truth
     Maze* oldMaze = m_maze;
     MazeView* oldTruth = m_truth;
+    bool oldMazeIsCached = m_mazeCache.owns(oldMaze);
     m_maze = maze;
-    m_truth = new MazeView(
-        m_maze,
-        true, // wallTruthVisible
-        false, // tileColorsVisible
-        false, // tileFogVisible
-        m_distancesCheckbox->isChecked(), // tileTextVisible
-        true // autopopulateTextWithDistance
+    m_truth = truth != nullptr ? truth : makeTruth(m_maze);
+
+    // Edits go to the walls as stored, so symmetric views can't be edited
+    MazeEditor* oldEditor = m_editor;
+    m_editor = (
+        m_maze->getSymmetry() == MazeSymmetry::IDENTITY
+        ? new MazeEditor(m_maze, m_truth->getMazeGraphic())
+        : nullptr
     );
 
     // Update pointers held by other objects
     m_model.setMaze(m_maze);
     m_map.setMaze(m_maze);
     m_map.setView(m_truth);
+    updateMazeStats();
+
+    // Delete the old objects, unless they're cached (or still current)
+    delete oldEditor;
+    if (oldMaze != m_maze && !oldMazeIsCached) {
+        delete oldMaze;
+        delete oldTruth;
+    }
 
-    // Update maze stats UI widgets
+    // Only now that nothing points to the old maze may the cache evict it
+    m_mazeCache.setCurrent(m_maze);
+}
+
+MazeView* Window::makeTruth(const Maze* maze) const {
+    return new MazeView(
+        maze,
+        true, // wallTruthVisible
+        false, // tileColorsVisible
+        false, // tileFogVisible
+        m_distancesCheckbox->isChecked(), // tileTextVisible
+        true // autopopulateTextWithDistance
+    );
+}
+
+void Window::updateMazeStats() {
     m_mazeWidthLabel->setText(QString::number(m_maze->getWidth()));
     m_mazeHeightLabel->setText(QString::number(m_maze->getHeight()));
     m_maxDistanceLabel->setText(
@@ -375,10 +583,16 @@ void Window::setMaze(Maze* maze) {
     );
     m_isValidLabel->setText(m_maze->isValidMaze() ? "TRUE" : "FALSE");
     m_isOfficialLabel->setText(m_maze->isOfficialMaze() ? "TRUE" : "FALSE");
+}
 
-    // Delete the old objects
-    delete oldMaze;
-    delete oldTruth;
+bool Window::eventFilter(QObject* watched, QEvent* event) {
+    // Explain the validity on mouse over
+    if (event->type() == QEvent::ToolTip && m_maze != nullptr &&
+            (watched == m_isValidLabel || watched == m_isOfficialLabel)) {
+        static_cast<QLabel*>(watched)->setToolTip(
+            MazeChecker::describe(MazeChecker::getReport(m_maze->getOrientedWalls())));
+    }
+    return QMainWindow::eventFilter(watched, event);
 }
 
 void Window::editSettings() {
@@ -442,6 +656,8 @@ QPair<QStringList, QVector<QVariant>> Window::getRunStats() const {
         "Elapsed Sim Time",
         "Time Since Origin Departure",
         "Best Time to Center",
+        "Optimal Time to Center",
+        "Efficiency",
         "Crashed",
     };
 
@@ -457,7 +673,7 @@ QPair<QStringList, QVector<QVariant>> Window::getRunStats() const {
     else {
         // TODO: MACK - m_mouse can be null here :/ ...
         values.append(
-            QString::number(stats.traversedTileLocations.size()) + " / " +
+            QString::number(stats.numberOfTraversedTiles) + " / " +
             QString::number(m_maze->getWidth() * m_maze->getHeight())
         );
         values.append(stats.closestDistanceToCenter);
@@ -480,6 +696,27 @@ QPair<QStringList, QVector<QVariant>> Window::getRunStats() const {
             ? "NONE"
             : SimUtilities::formatDuration(stats.bestTimeToCenter)
         );
+
+        // The efficiency is how close the best run came to the optimal one
+        Duration optimalTimeToCenter = OptimalTimeOracle::getTimeToGoal(
+            m_maze->getOrientedWalls(),
+            m_maze->getGoalPositions(),
+            Distance::Meters(P()->wallLength() + P()->wallWidth()),
+            m_mouse->getMaximumForwardSpeed(),
+            m_mouse->getMaximumTurnSpeed());
+        values.append(
+            optimalTimeToCenter.getSeconds() < 0
+            ? "NONE"
+            : SimUtilities::formatDuration(optimalTimeToCenter)
+        );
+        values.append(
+            optimalTimeToCenter.getSeconds() < 0 ||
+            stats.bestTimeToCenter.getSeconds() <= 0
+            ? "NONE"
+            : QString::number(
+                100.0 * optimalTimeToCenter.getSeconds() /
+                stats.bestTimeToCenter.getSeconds(), 'f', 1) + "%"
+        );
         values.append((m_mouse->didCrash() ? "TRUE" : "FALSE"));
     }
 
@@ -1171,6 +1408,11 @@ void Window::mouseAlgoRunStart() {
             );
             m_mouseAlgoRunButton->setText("Run");
 
+            // Save how the run went, before the mouse is removed
+            if (!m_timelineDirectory.isEmpty()) {
+                writeMouseTimeline();
+            }
+
             // Update the status label, call stderrPostAction
             if (exitStatus == QProcess::NormalExit && exitCode == 0) {
                 m_mouseAlgoRunStatus->setText("COMPLETE");
@@ -1188,6 +1430,17 @@ void Window::mouseAlgoRunStart() {
                     "QLabel { background: rgb(255, 150, 150); }"
                 );
             }
+
+            // For headless runs, exit with the algorithm's status
+            if (m_quitWhenMouseAlgoFinishes) {
+                int status = exitStatus == QProcess::NormalExit ? exitCode : 1;
+                if (m_sweepMouseAlgo.isEmpty()) {
+                    QCoreApplication::exit(status);
+                }
+                else {
+                    sweepFinished(status);
+                }
+            }
         }
     );
 
@@ -1232,6 +1485,7 @@ void Window::mouseAlgoRunStart() {
     m_mouseAlgoRunProcess = newProcess;
     m_map.setView(newView);
     m_map.setMouseGraphic(newMouseGraphic);
+    m_map.setMouseTrail(m_model.getMouseTrail());
 
     // We have to do some gymnastics here (similar to above)
     // to ensure that the UI updates happen on the UI thread
@@ -1244,6 +1498,9 @@ void Window::mouseAlgoRunStart() {
             m_viewButton->setEnabled(true);
             m_viewButton->setChecked(true);
             m_followCheckbox->setEnabled(true);
+            m_trailCheckbox->setEnabled(true);
+            m_heatmapCheckbox->setEnabled(true);
+            m_editCheckbox->setEnabled(false);
             m_mouseAlgoPauseButton->setEnabled(true);
             for (QPushButton* button : m_mouseAlgoInputButtons) {
                 button->setEnabled(true);
@@ -1287,6 +1544,7 @@ void Window::mouseAlgoRunStop() {
     // thread so that we can be sure no more stderr will be emitted.
     m_stderrBuffer.clear();
     m_map.setMouseGraphic(nullptr);
+    m_map.setMouseTrail(nullptr);
     m_map.setView(m_truth);
     m_model.removeMouse();
     m_mouseAlgoRunProcess = nullptr;
@@ -1300,6 +1558,9 @@ void Window::mouseAlgoRunStop() {
     m_truthButton->setChecked(true);
     m_viewButton->setEnabled(false);
     m_followCheckbox->setEnabled(false);
+    m_trailCheckbox->setEnabled(false);
+    m_heatmapCheckbox->setEnabled(false);
+    m_editCheckbox->setEnabled(true);
     m_mouseAlgoPauseButton->setEnabled(false);
     mouseAlgoResume();
     for (QPushButton* button : m_mouseAlgoInputButtons) {
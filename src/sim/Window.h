@@ -1,8 +1,10 @@
 #pragma once
 
+#include <QAction>
 #include <QCheckBox>
 #include <QCloseEvent>
 #include <QComboBox>
+#include <QEvent>
 #include <QLabel>
 #include <QMainWindow>
 #include <QPlainTextEdit>
@@ -12,8 +14,12 @@
 #include <QThread>
 
 #include "ConfigDialogField.h"
+#include "FrameExporter.h"
 #include "Map.h"
 #include "Maze.h"
+#include "MazeCache.h"
+#include "MazeEditor.h"
+#include "MazeSymmetry.h"
 #include "MazeView.h"
 #include "Model.h"
 #include "MouseAlgoStatsWidget.h"
@@ -33,6 +39,30 @@ public:
     void closeEvent(QCloseEvent* event);
     void resizeEvent(QResizeEvent* event);
 
+    // Fills in the validity tooltips when they're about to be shown, since
+    // checking every rule of a large maze isn't free
+    bool eventFilter(QObject* watched, QEvent* event);
+
+    // Used by the command line options (e.g., for headless runs); returns
+    // whether or not the maze could be loaded
+    bool loadMazeFile(const QString& path);
+    void setMazeSymmetry(MazeSymmetry symmetry);
+
+    // Makes the given tiles (in the maze file's coordinates) the goal of
+    // this maze and the ones loaded after it; the goal is the center if
+    // there are none
+    void setMazeGoal(const QVector<QPair<int, int>>& goal);
+    void startMouseAlgo(const QString& name, bool quitWhenFinished);
+
+    // Runs the mouse algorithm in each symmetry of the maze in turn, printing
+    // the stats of each run, and then exits with the worst exit code
+    void sweepMouseAlgo(const QString& name);
+    void setFrameExporter(FrameExporter* frameExporter);
+
+    // Writes the exploration timeline of each run that finishes to a CSV
+    // file in the directory, numbered in the order the runs finished
+    void setTimelineDirectory(const QString& directory);
+
 signals:
 
     // Emits this signal when a user presses an input button
@@ -66,10 +96,27 @@ private:
     QCheckBox* m_fogCheckbox;
     QCheckBox* m_textCheckbox;
     QCheckBox* m_followCheckbox;
+    QCheckBox* m_trailCheckbox;
+    QCheckBox* m_heatmapCheckbox;
+    QCheckBox* m_hudCheckbox;
+    QCheckBox* m_editCheckbox;
+
+    // Recently loaded mazes and their true views, which usually include the
+    // current ones; anything that the cache doesn't own belongs to the window
+    MazeCache m_mazeCache;
 
-    // The maze and the true view of the maze
+    // The maze, the true view of the maze, and the editor that toggles the
+    // walls of both when the map is clicked (while no mouse is running)
     Maze* m_maze;
     MazeView* m_truth;
+    MazeEditor* m_editor;
+
+    // The symmetry that mazes are viewed (and run) in, and its menu items
+    MazeSymmetry m_mazeSymmetry;
+    QMap<MazeSymmetry, QAction*> m_mazeSymmetryActions;
+
+    // The goal that mazes are given, if it isn't the center
+    QVector<QPair<int, int>> m_mazeGoal;
 
     // The mouse, its graphic, its view of the maze, and the controller
     // responsible for spawning and interfacing with the mouse algorithm
@@ -78,8 +125,30 @@ private:
     MazeView* m_view;
     MouseInterface* m_mouseInterface;
 
-    // Helper function for updating the maze 
-    void setMaze(Maze* maze);
+    // Snapshots the map every so often, if set
+    FrameExporter* m_frameExporter;
+
+    // Whether to exit once the mouse algorithm finishes
+    bool m_quitWhenMouseAlgoFinishes;
+
+    // Where run timelines are written, if anywhere, and how many have been
+    QString m_timelineDirectory;
+    int m_timelineCount;
+    void writeMouseTimeline();
+
+    // The algorithm being swept across symmetries (if any), the symmetries
+    // that are left, and the worst exit code so far
+    QString m_sweepMouseAlgo;
+    QVector<MazeSymmetry> m_sweepSymmetries;
+    int m_sweepExitCode;
+    void sweepNext();
+    void sweepFinished(int exitCode);
+
+    // Helper functions for updating the maze; if the truth is null, it's
+    // built from the maze
+    void setMaze(Maze* maze, MazeView* truth = nullptr);
+    MazeView* makeTruth(const Maze* maze) const;
+    void updateMazeStats();
 
     // Helper function for editing settings
     void editSettings();